@@ -25,8 +25,6 @@
 
  // Cabeçalhos necessários (para esta função), acrescentar ao seu código 
 #include <iostream>
-#include <fstream>
-#include <sstream>
 #include <string>
 #include <vector>
  
@@ -44,6 +42,10 @@ using namespace std;
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+// Parser de .obj compartilhado (src/ObjLoader.h e src/ObjLoader.cpp)
+#include "ObjLoader.h"
+#include "ObjLoader.cpp"
+
 struct Mesh 
 {
     GLuint VAO; 
@@ -52,68 +54,30 @@ struct Mesh
 
 int loadSimpleOBJ(string filePATH, int &nVertices)
  {
-    std::vector<glm::vec3> vertices;
-    std::vector<glm::vec2> texCoords;
-    std::vector<glm::vec3> normals;
     std::vector<GLfloat> vBuffer;
     glm::vec3 color = glm::vec3(1.0, 0.0, 0.0);
 
-    std::ifstream arqEntrada(filePATH.c_str());
-    if (!arqEntrada.is_open()) 
+    // O arquivo é mapeado em memória e lido sem criar strings por linha
+    ObjMesh mesh;
+    if (!loadOBJ(filePATH, mesh)) 
 	{
         std::cerr << "Erro ao tentar ler o arquivo " << filePATH << std::endl;
         return -1;
     }
 
-    std::string line;
-    while (std::getline(arqEntrada, line)) 
+    // mesh é indexada; aqui expandimos de volta para um vértice por canto (glDrawArrays)
+    vBuffer.reserve(mesh.indices.size() * 6);
+    for (uint32_t index : mesh.indices) 
 	{
-        std::istringstream ssline(line);
-        std::string word;
-        ssline >> word;
-
-        if (word == "v") 
-		{
-            glm::vec3 vertice;
-            ssline >> vertice.x >> vertice.y >> vertice.z;
-            vertices.push_back(vertice);
-        } 
-        else if (word == "vt") 
-		{
-            glm::vec2 vt;
-            ssline >> vt.s >> vt.t;
-            texCoords.push_back(vt);
-        } 
-        else if (word == "vn") 
-		{
-            glm::vec3 normal;
-            ssline >> normal.x >> normal.y >> normal.z;
-            normals.push_back(normal);
-        } 
-        else if (word == "f")
-		 {
-            while (ssline >> word) 
-			{
-                int vi = 0, ti = 0, ni = 0;
-                std::istringstream ss(word);
-                std::string index;
-
-                if (std::getline(ss, index, '/')) vi = !index.empty() ? std::stoi(index) - 1 : 0;
-                if (std::getline(ss, index, '/')) ti = !index.empty() ? std::stoi(index) - 1 : 0;
-                if (std::getline(ss, index)) ni = !index.empty() ? std::stoi(index) - 1 : 0;
-
-                vBuffer.push_back(vertices[vi].x);
-                vBuffer.push_back(vertices[vi].y);
-                vBuffer.push_back(vertices[vi].z);
-                vBuffer.push_back(color.r);
-                vBuffer.push_back(color.g);
-                vBuffer.push_back(color.b);
-            }
-        }
+        const Vertex &v = mesh.vertices[index];
+        vBuffer.push_back(v.position.x);
+        vBuffer.push_back(v.position.y);
+        vBuffer.push_back(v.position.z);
+        vBuffer.push_back(color.r);
+        vBuffer.push_back(color.g);
+        vBuffer.push_back(color.b);
     }
 
-    arqEntrada.close();
-
     std::cout << "Gerando o buffer de geometria..." << std::endl;
     GLuint VBO, VAO;
     glGenBuffers(1, &VBO);
@@ -0,0 +1,296 @@
+#include "AssetPack.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string_view>
+
+namespace fs = std::filesystem;
+
+std::string packEntryName(const std::string &root, const std::string &path)
+{
+    std::error_code ec;
+    fs::path base = fs::absolute(root, ec).lexically_normal();
+    fs::path full = fs::absolute(path, ec).lexically_normal();
+    if (ec)
+        return std::string();
+    std::string name = full.lexically_relative(base).generic_string();
+    if (name.empty() || name == "." || name.compare(0, 2, "..") == 0)
+        return std::string();
+    for (char &c : name)
+        c = (char)std::tolower((unsigned char)c);
+    return name;
+}
+
+// LZ4, formato de bloco: sequências de [token][literais][offset][comprimento
+// extra]; os 5 últimos bytes são sempre literais e o último match começa até
+// 12 bytes antes do fim, como o formato exige
+static const size_t LZ4_MIN_MATCH = 4;
+static const size_t LZ4_LAST_LITERALS = 5;
+static const size_t LZ4_MATCH_LIMIT = 12;
+static const int LZ4_HASH_BITS = 16;
+static const uint32_t LZ4_NO_POSITION = 0xFFFFFFFFu;
+
+static uint32_t read32(const char *p)
+{
+    uint32_t value;
+    memcpy(&value, p, 4);
+    return value;
+}
+
+static void writeLz4Length(std::vector<char> &dst, size_t length)
+{
+    while (length >= 255)
+    {
+        dst.push_back((char)255);
+        length -= 255;
+    }
+    dst.push_back((char)length);
+}
+
+static void writeLz4Sequence(std::vector<char> &dst, const char *literals, size_t literalCount, size_t offset, size_t matchLength)
+{
+    size_t matchCode = matchLength >= LZ4_MIN_MATCH ? matchLength - LZ4_MIN_MATCH : 0;
+    dst.push_back((char)((std::min<size_t>(literalCount, 15) << 4) | std::min<size_t>(matchCode, 15)));
+    if (literalCount >= 15)
+        writeLz4Length(dst, literalCount - 15);
+    dst.insert(dst.end(), literals, literals + literalCount);
+    if (matchLength == 0)
+        return; // última sequência: só literais
+    dst.push_back((char)(offset & 0xFF));
+    dst.push_back((char)(offset >> 8));
+    if (matchCode >= 15)
+        writeLz4Length(dst, matchCode - 15);
+}
+
+bool lz4Compress(const char *src, size_t size, std::vector<char> &dst, size_t maxBytes)
+{
+    dst.clear();
+    if (size >= LZ4_NO_POSITION)
+        return false;
+    std::vector<uint32_t> table((size_t)1 << LZ4_HASH_BITS, LZ4_NO_POSITION);
+    size_t anchor = 0, pos = 0;
+    size_t matchLimit = size > LZ4_MATCH_LIMIT ? size - LZ4_MATCH_LIMIT : 0;
+    size_t matchEnd = size > LZ4_LAST_LITERALS ? size - LZ4_LAST_LITERALS : 0;
+
+    while (pos < matchLimit)
+    {
+        uint32_t sequence = read32(src + pos);
+        uint32_t &slot = table[(sequence * 2654435761u) >> (32 - LZ4_HASH_BITS)];
+        size_t candidate = slot;
+        slot = (uint32_t)pos;
+        if (candidate == LZ4_NO_POSITION || pos - candidate > 65535 || read32(src + candidate) != sequence)
+        {
+            ++pos;
+            continue;
+        }
+
+        // estende para trás sobre os literais pendentes e para frente até o limite
+        while (pos > anchor && candidate > 0 && src[pos - 1] == src[candidate - 1])
+        {
+            --pos;
+            --candidate;
+        }
+        size_t length = LZ4_MIN_MATCH;
+        while (pos + length < matchEnd && src[candidate + length] == src[pos + length])
+            ++length;
+
+        writeLz4Sequence(dst, src + anchor, pos - anchor, pos - candidate, length);
+        if (dst.size() > maxBytes)
+            return false;
+        pos += length;
+        anchor = pos;
+    }
+    writeLz4Sequence(dst, src + anchor, size - anchor, 0, 0);
+    return dst.size() <= maxBytes;
+}
+
+// Comprimento estendido (bytes 255 seguidos do resto); false se o bloco acabar
+static bool readLz4Length(const unsigned char *&ip, const unsigned char *end, size_t &length)
+{
+    unsigned char byte;
+    do
+    {
+        if (ip >= end)
+            return false;
+        byte = *ip++;
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+bool lz4Decompress(const char *src, size_t size, char *dst, size_t dstSize)
+{
+    const unsigned char *ip = (const unsigned char *)src;
+    const unsigned char *end = ip + size;
+    char *op = dst;
+    char *outEnd = dst + dstSize;
+    while (ip < end)
+    {
+        unsigned token = *ip++;
+        size_t literals = token >> 4;
+        if (literals == 15 && !readLz4Length(ip, end, literals))
+            return false;
+        if (literals > (size_t)(end - ip) || literals > (size_t)(outEnd - op))
+            return false;
+        memcpy(op, ip, literals);
+        op += literals;
+        ip += literals;
+        if (ip == end)
+            break; // última sequência
+
+        if (end - ip < 2)
+            return false;
+        size_t offset = ip[0] | ((size_t)ip[1] << 8);
+        ip += 2;
+        size_t length = token & 15;
+        if (length == 15 && !readLz4Length(ip, end, length))
+            return false;
+        length += LZ4_MIN_MATCH;
+        if (offset == 0 || offset > (size_t)(op - dst) || length > (size_t)(outEnd - op))
+            return false;
+
+        const char *match = op - offset;
+        if (offset >= length)
+            memcpy(op, match, length);
+        else
+            for (size_t i = 0; i < length; ++i) // sobreposto: repete o padrão
+                op[i] = match[i];
+        op += length;
+    }
+    return op == outEnd;
+}
+
+bool AssetPack::open(const std::string &path)
+{
+    close();
+    if (!m_file.open(path) || m_file.size() < sizeof(AssetPackHeader))
+    {
+        close();
+        return false;
+    }
+
+    AssetPackHeader header;
+    memcpy(&header, m_file.data(), sizeof(header));
+    uint64_t size = m_file.size();
+    if (header.magic != ASSET_PACK_MAGIC || header.version != ASSET_PACK_VERSION ||
+        header.tocOffset % alignof(AssetPackEntry) != 0 ||
+        header.tocOffset + (uint64_t)header.entryCount * sizeof(AssetPackEntry) > size ||
+        header.nameOffset + header.nameBytes > size)
+    {
+        std::cerr << "Pacote de assets invalido: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    // confere todas as entradas uma vez, para que find/read não precisem
+    const AssetPackEntry *entries = (const AssetPackEntry *)(m_file.data() + header.tocOffset);
+    for (uint32_t i = 0; i < header.entryCount; ++i)
+    {
+        const AssetPackEntry &entry = entries[i];
+        bool sizeOk = entry.compression == ASSET_PACK_LZ4 || (entry.compression == ASSET_PACK_STORED && entry.size == entry.rawSize);
+        if (!sizeOk || entry.offset + entry.size > size || entry.nameOffset + entry.nameLength > header.nameBytes)
+        {
+            std::cerr << "Pacote de assets invalido: " << path << std::endl;
+            close();
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    m_root = fs::absolute(path, ec).parent_path().string();
+    m_entries = entries;
+    m_entryCount = header.entryCount;
+    m_names = m_file.data() + header.nameOffset;
+    m_state.reset(new std::atomic<uint8_t>[m_entryCount]);
+    for (size_t i = 0; i < m_entryCount; ++i)
+        m_state[i] = ENTRY_UNCHECKED;
+    return true;
+}
+
+void AssetPack::close()
+{
+    m_file.close();
+    m_entries = nullptr;
+    m_entryCount = 0;
+    m_names = nullptr;
+    m_state.reset();
+}
+
+bool AssetPack::sourceMatches(const AssetPackEntry &entry, const std::string &path) const
+{
+    std::error_code ec;
+    fs::file_time_type time = fs::last_write_time(path, ec);
+    if (ec)
+        return true;
+    uint64_t size = fs::file_size(path, ec);
+    if (ec)
+        return true;
+    if (size != entry.sourceSize)
+        return false;
+    if ((int64_t)time.time_since_epoch().count() == entry.sourceMtime)
+        return true;
+    // mesma data perdida numa cópia ou checkout: o conteúdo decide
+    MappedFile source(path);
+    return source.isOpen() && hashBytes(source.data(), source.size()) == entry.sourceHash;
+}
+
+const AssetPackEntry *AssetPack::find(const std::string &path) const
+{
+    if (!m_entries)
+        return nullptr;
+    std::string name = packEntryName(m_root, path);
+    if (name.empty())
+        return nullptr;
+
+    auto nameOf = [this](const AssetPackEntry &entry)
+    { return std::string_view(m_names + entry.nameOffset, entry.nameLength); };
+    const AssetPackEntry *end = m_entries + m_entryCount;
+    const AssetPackEntry *it = std::lower_bound(m_entries, end, name, [&](const AssetPackEntry &entry, const std::string &key)
+                                                { return nameOf(entry) < key; });
+    if (it == end || nameOf(*it) != name)
+        return nullptr;
+
+    std::atomic<uint8_t> &state = m_state[it - m_entries];
+    if (state == ENTRY_UNCHECKED)
+    {
+        // duas threads podem conferir a mesma entrada; o resultado é o mesmo
+        bool matches = sourceMatches(*it, path);
+        uint8_t expected = ENTRY_UNCHECKED;
+        if (state.compare_exchange_strong(expected, matches ? ENTRY_VALID : ENTRY_STALE) && !matches)
+            std::cerr << "Aviso: " << path << " mudou depois do pacote de assets, usando o arquivo solto" << std::endl;
+    }
+    return state == ENTRY_STALE ? nullptr : it;
+}
+
+void AssetPack::markStale(const std::string &path)
+{
+    if (const AssetPackEntry *entry = find(path))
+        m_state[entry - m_entries] = ENTRY_STALE;
+}
+
+bool AssetPack::read(const std::string &path, AssetPackKind kind, AssetBytes &out) const
+{
+    const AssetPackEntry *entry = find(path);
+    if (!entry || entry->kind != kind)
+        return false;
+
+    const char *data = m_file.data() + entry->offset;
+    if (entry->compression == ASSET_PACK_STORED)
+    {
+        out.data = data;
+        out.size = (size_t)entry->size;
+        return true;
+    }
+    out.storage.resize((size_t)entry->rawSize);
+    if (!lz4Decompress(data, (size_t)entry->size, out.storage.data(), out.storage.size()))
+    {
+        std::cerr << "Entrada corrompida no pacote de assets: " << path << std::endl;
+        out.storage.clear();
+        return false;
+    }
+    out.data = out.storage.data();
+    out.size = out.storage.size();
+    return true;
+}
@@ -0,0 +1,126 @@
+#pragma once
+#include "ObjLoader.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Pacote de assets: um arquivo só (gerado pelo AssetPacker) com a cena, as
+// bibliotecas .mtl e os caches já processados das malhas (.meshcache) e das
+// texturas (.texcache), cada entrada alinhada a 64 bytes. O arquivo é mapeado
+// inteiro e as entradas armazenadas sem compressão são lidas no lugar; as
+// comprimidas com LZ4 são descomprimidas num buffer do chamador.
+//
+// As entradas são procuradas pelo caminho do arquivo fonte relativo à pasta do
+// pacote (packEntryName), então os carregadores continuam usando os mesmos
+// caminhos de antes e caem nos arquivos soltos quando a entrada não existe.
+// Cada entrada guarda o tamanho, a data e o hash do arquivo fonte: se o arquivo
+// solto existir e tiver mudado depois do empacotamento, ele vale no lugar da
+// entrada.
+
+const uint32_t ASSET_PACK_MAGIC = 0x4B435047; // "GPCK"
+const uint32_t ASSET_PACK_VERSION = 2;
+const uint64_t ASSET_PACK_ALIGNMENT = 64;
+
+enum AssetPackKind : uint32_t
+{
+    ASSET_PACK_RAW = 0,     // bytes do arquivo fonte (scene.json, .mtl)
+    ASSET_PACK_MESH = 1,    // conteúdo do .meshcache do .obj
+    ASSET_PACK_TEXTURE = 2, // conteúdo do .texcache da imagem
+};
+
+enum AssetPackCompression : uint32_t
+{
+    ASSET_PACK_STORED = 0,
+    ASSET_PACK_LZ4 = 1, // formato de bloco do LZ4
+};
+
+struct AssetPackHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t reserved;
+    uint64_t tocOffset;  // AssetPackEntry[entryCount], ordenadas pelo nome
+    uint64_t nameOffset; // nomes concatenados, sem '\0'
+    uint64_t nameBytes;
+};
+
+struct AssetPackEntry
+{
+    uint64_t nameOffset; // a partir de AssetPackHeader::nameOffset
+    uint32_t nameLength;
+    uint32_t kind;        // AssetPackKind
+    uint32_t compression; // AssetPackCompression
+    uint32_t reserved;
+    uint64_t offset;     // a partir do início do arquivo
+    uint64_t size;       // bytes gravados
+    uint64_t rawSize;    // bytes depois de descomprimir
+    uint64_t sourceHash; // hashBytes do arquivo fonte (deduplicação do AssetCache)
+    uint64_t sourceSize; // como cacheSourceKey, no momento do empacotamento
+    int64_t sourceMtime;
+};
+
+// Bytes de uma entrada: data aponta para o pacote mapeado ou para storage
+struct AssetBytes
+{
+    const char *data = nullptr;
+    size_t size = 0;
+    std::vector<char> storage; // só usado por entradas comprimidas
+};
+
+// Nome da entrada para path: relativo a root, com '/' e em minúsculas (os
+// caminhos da cena misturam "Modelos3D" e "modelos3D"); vazio se path não
+// estiver dentro de root
+std::string packEntryName(const std::string &root, const std::string &path);
+
+// Compressão LZ4 (formato de bloco) de src em dst; false se não couber em
+// maxBytes (dst fica com o conteúdo parcial)
+bool lz4Compress(const char *src, size_t size, std::vector<char> &dst, size_t maxBytes);
+
+// Descomprime exatamente dstSize bytes; false se o bloco estiver corrompido
+bool lz4Decompress(const char *src, size_t size, char *dst, size_t dstSize);
+
+// Pacote aberto. Depois de open() só há leituras (e markStale, atômico): pode
+// ser usado por várias threads ao mesmo tempo.
+class AssetPack
+{
+public:
+    // false se o arquivo não existir ou não for um pacote desta versão
+    bool open(const std::string &path);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+
+    // Entrada do arquivo fonte path ou nullptr; nullptr também quando o
+    // arquivo solto difere do empacotado (conferido uma vez por entrada)
+    const AssetPackEntry *find(const std::string &path) const;
+
+    // Lê a entrada de path se ela for do tipo kind; false se não existir
+    bool read(const std::string &path, AssetPackKind kind, AssetBytes &out) const;
+
+    // O arquivo fonte de path mudou no disco (recarga em tempo de execução):
+    // find e read passam a ignorar a entrada e os carregadores usam o arquivo solto
+    void markStale(const std::string &path);
+
+    size_t entryCount() const { return m_entryCount; }
+
+private:
+    enum EntryState : uint8_t
+    {
+        ENTRY_UNCHECKED, // arquivo solto ainda não comparado
+        ENTRY_VALID,
+        ENTRY_STALE, // markStale ou arquivo solto diferente
+    };
+
+    // Compara o arquivo solto com o tamanho, a data e, se a data mudou, o hash
+    // gravados na entrada; sem arquivo solto a entrada vale
+    bool sourceMatches(const AssetPackEntry &entry, const std::string &path) const;
+
+    MappedFile m_file;
+    std::string m_root; // pasta do pacote
+    const AssetPackEntry *m_entries = nullptr;
+    size_t m_entryCount = 0;
+    const char *m_names = nullptr;
+    std::unique_ptr<std::atomic<uint8_t>[]> m_state; // EntryState, por entrada
+};
@@ -0,0 +1,284 @@
+/* Gera o pacote de assets (AssetPack.h) lido pelo TrabalhoGrauB ao iniciar
+ *
+ * Lê o scene.json da pasta de assets e, para cada objeto da cena, guarda no
+ * pacote o cache binário da malha (.meshcache), a biblioteca .mtl (a da cena ou
+ * o mtllib do .obj) e o cache comprimido (.texcache) da textura difusa de cada
+ * material, gerando os caches que ainda não existirem. Com --lz4 cada entrada
+ * é comprimida quando isso economiza pelo menos 10%.
+ *
+ * Uso: ./AssetPacker [pasta de assets] [pasta dos modelos] [--lz4]
+ * Ex.: ./AssetPacker ../assets ../assets/Modelos3D --lz4
+ */
+
+#include "ObjLoader.h"
+#include "ObjLoader.cpp"
+#include "MeshOptimizer.h"
+#include "MeshOptimizer.cpp"
+#include "MeshSimplifier.h"
+#include "MeshSimplifier.cpp"
+#include "Meshlets.h"
+#include "Meshlets.cpp"
+#include "MeshCache.h"
+#include "MeshCache.cpp"
+#include "MtlLoader.h"
+#include "MtlLoader.cpp"
+#include "MipGenerator.h"
+#include "MipGenerator.cpp"
+#include "TextureCompressor.h"
+#include "TextureCompressor.cpp"
+#include "TextureCache.h"
+#include "TextureCache.cpp"
+#include "SceneReader.h"
+#include "SceneReader.cpp"
+#include "AssetPack.h"
+#include "AssetPack.cpp"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+using namespace std;
+
+struct PackInput
+{
+    AssetPackKind kind;
+    std::vector<char> data;
+    uint64_t sourceHash;
+    uint64_t sourceSize;
+    int64_t sourceMtime;
+};
+
+static const char *kindName(AssetPackKind kind)
+{
+    return kind == ASSET_PACK_MESH ? "malha" : kind == ASSET_PACK_TEXTURE ? "textura" : "arquivo";
+}
+
+// Entradas por nome: o std::map já deixa a tabela ordenada como AssetPack::find espera
+using PackInputs = std::map<std::string, PackInput>;
+
+// Guarda os bytes de file como a entrada do arquivo fonte sourcePath
+static bool addEntry(PackInputs &inputs, const std::string &root, const std::string &sourcePath, AssetPackKind kind,
+                     const MappedFile &file)
+{
+    std::string name = packEntryName(root, sourcePath);
+    if (name.empty())
+    {
+        cerr << sourcePath << " esta fora da pasta de assets " << root << endl;
+        return false;
+    }
+    if (inputs.count(name))
+        return true;
+
+    PackInput input;
+    if (!cacheSourceKey(sourcePath, input.sourceSize, input.sourceMtime, input.sourceHash))
+    {
+        cerr << "Arquivo nao encontrado: " << sourcePath << endl;
+        return false;
+    }
+    input.kind = kind;
+    input.data.assign(file.data(), file.data() + file.size());
+    inputs[name] = std::move(input);
+    return true;
+}
+
+// O cache da malha; materialLibrary recebe o mtllib do .obj
+static bool addMesh(PackInputs &inputs, const std::string &root, const std::string &objPath, std::string &materialLibrary)
+{
+    MeshCacheFile cache;
+    ObjMesh mesh;
+    std::vector<uint16_t> indices16;
+    MeshView view;
+    if (!loadMeshCached(objPath, cache, mesh, indices16, view))
+    {
+        cerr << "Erro ao abrir OBJ: " << objPath << endl;
+        return false;
+    }
+    // recém gerado: o cache acabou de ser gravado ao lado do .obj
+    if (!cache.file.isOpen() && !openMeshCache(objPath, cache))
+    {
+        cerr << "Nao foi possivel gravar " << meshCachePath(objPath) << endl;
+        return false;
+    }
+    materialLibrary = cache.view.materialLibrary;
+    return addEntry(inputs, root, objPath, ASSET_PACK_MESH, cache.file);
+}
+
+static bool addTexture(PackInputs &inputs, const std::string &root, const std::string &imagePath)
+{
+    TextureCacheFile cache;
+    if (!loadTextureCached(imagePath, cache))
+    {
+        cerr << "Falha ao carregar textura: " << imagePath << endl;
+        return false;
+    }
+    if (!cache.file.isOpen() && !openTextureCache(imagePath, cache))
+    {
+        cerr << "Nao foi possivel gravar " << textureCachePath(imagePath) << endl;
+        return false;
+    }
+    return addEntry(inputs, root, imagePath, ASSET_PACK_TEXTURE, cache.file);
+}
+
+// A biblioteca .mtl e a textura difusa de cada material (a única que o shader usa)
+static bool addMaterials(PackInputs &inputs, const std::string &root, const std::string &mtlPath)
+{
+    std::vector<Material> materials;
+    MappedFile file(mtlPath);
+    if (!loadMaterialLibrary(mtlPath, materials) || !addEntry(inputs, root, mtlPath, ASSET_PACK_RAW, file))
+        return false;
+
+    bool ok = true;
+    std::filesystem::path folder = std::filesystem::path(mtlPath).parent_path();
+    for (const Material &mat : materials)
+        if (!mat.map_Kd.empty())
+            ok = addTexture(inputs, root, (folder / mat.map_Kd).string()) && ok;
+    return ok;
+}
+
+static bool writePack(const std::string &path, const PackInputs &inputs, bool lz4)
+{
+    std::vector<AssetPackEntry> entries;
+    std::string names;
+    std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out)
+            return false;
+
+        AssetPackHeader header = {};
+        out.write((const char *)&header, sizeof(header));
+        const char zeros[ASSET_PACK_ALIGNMENT] = {};
+        auto pad = [&](uint64_t alignment)
+        {
+            uint64_t pos = (uint64_t)out.tellp();
+            out.write(zeros, (std::streamsize)(alignUp(pos, alignment) - pos));
+            return alignUp(pos, alignment);
+        };
+
+        cout << left << setw(40) << "entrada" << setw(10) << "tipo" << right << setw(12) << "fonte (KB)"
+             << setw(14) << "gravado (KB)" << "\n";
+        std::vector<char> compressed;
+        for (const auto &item : inputs)
+        {
+            const PackInput &input = item.second;
+            AssetPackEntry entry = {};
+            entry.nameOffset = names.size();
+            entry.nameLength = (uint32_t)item.first.size();
+            entry.kind = input.kind;
+            entry.rawSize = input.data.size();
+            entry.sourceHash = input.sourceHash;
+            entry.sourceSize = input.sourceSize;
+            entry.sourceMtime = input.sourceMtime;
+            names += item.first;
+
+            const char *data = input.data.data();
+            entry.size = input.data.size();
+            entry.compression = ASSET_PACK_STORED;
+            if (lz4 && lz4Compress(input.data.data(), input.data.size(), compressed, input.data.size() * 9 / 10))
+            {
+                data = compressed.data();
+                entry.size = compressed.size();
+                entry.compression = ASSET_PACK_LZ4;
+            }
+            entry.offset = pad(ASSET_PACK_ALIGNMENT);
+            out.write(data, (std::streamsize)entry.size);
+            entries.push_back(entry);
+
+            cout << left << setw(40) << item.first << setw(10) << kindName(input.kind) << right
+                 << setw(12) << entry.rawSize / 1024 << setw(14) << entry.size / 1024
+                 << (entry.compression == ASSET_PACK_LZ4 ? "  lz4" : "") << "\n";
+        }
+
+        header.magic = ASSET_PACK_MAGIC;
+        header.version = ASSET_PACK_VERSION;
+        header.entryCount = (uint32_t)entries.size();
+        header.nameOffset = pad(1);
+        header.nameBytes = names.size();
+        out.write(names.data(), (std::streamsize)names.size());
+        header.tocOffset = pad(ASSET_PACK_ALIGNMENT);
+        out.write((const char *)entries.data(), (std::streamsize)(entries.size() * sizeof(AssetPackEntry)));
+        out.seekp(0);
+        out.write((const char *)&header, sizeof(header));
+        if (!out)
+            return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec)
+    {
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    std::string root = "../assets";
+    std::string modelPath = "../assets/Modelos3D";
+    bool lz4 = false;
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--lz4") == 0)
+            lz4 = true;
+        else
+            positional.push_back(argv[i]);
+    }
+    if (positional.size() > 0)
+        root = positional[0];
+    if (positional.size() > 1)
+        modelPath = positional[1];
+
+    std::string scenePath = root + "/scene.json";
+    MappedFile scene(scenePath);
+    if (!scene.isOpen())
+    {
+        cerr << "Erro ao abrir arquivo de cena: " << scenePath << endl;
+        return 1;
+    }
+
+    PackInputs inputs;
+    bool ok = addEntry(inputs, root, scenePath, ASSET_PACK_RAW, scene);
+    SceneSettings settings;
+    ok = readScene(scene.data(), scene.size(), settings, [&](SceneObjectRecord &record)
+                   {
+        std::string objPath = modelPath + "/" + record.file;
+        std::string materialLibrary;
+        if (!addMesh(inputs, root, objPath, materialLibrary))
+        {
+            ok = false;
+            return;
+        }
+        // como em loadSceneFromFile/resolveMaterials: o "material" da cena tem
+        // prioridade sobre o mtllib do .obj
+        std::string mtlPath;
+        if (!record.material.empty())
+            mtlPath = modelPath + "/" + record.material;
+        else if (!materialLibrary.empty())
+            mtlPath = (std::filesystem::path(objPath).parent_path() / materialLibrary).string();
+        if (!mtlPath.empty())
+            ok = addMaterials(inputs, root, mtlPath) && ok; }) && ok;
+
+    std::string packPath = root + "/assets.pack";
+    if (!writePack(packPath, inputs, lz4))
+    {
+        cerr << "Nao foi possivel gravar " << packPath << endl;
+        return 1;
+    }
+
+    AssetPack pack;
+    if (!pack.open(packPath))
+        return 1;
+    cout << packPath << ": " << pack.entryCount() << " entradas, "
+         << std::filesystem::file_size(packPath) / 1024 << " KB" << endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,37 @@
+#include "AssetRegistry.h"
+#include "AssetPack.h"
+#include "ObjLoader.h"
+#include <filesystem>
+
+static const AssetPack *s_assetPack = nullptr;
+
+void setAssetPack(const AssetPack *pack)
+{
+    s_assetPack = pack;
+}
+
+std::string canonicalAssetPath(const std::string &path)
+{
+    std::error_code ec;
+    std::filesystem::path canonical = std::filesystem::weakly_canonical(path, ec);
+    if (ec)
+        return std::filesystem::absolute(path, ec).lexically_normal().string();
+    return canonical.string();
+}
+
+bool fileContentHash(const std::string &path, uint64_t &outHash)
+{
+    if (s_assetPack)
+    {
+        if (const AssetPackEntry *entry = s_assetPack->find(path))
+        {
+            outHash = entry->sourceHash;
+            return true;
+        }
+    }
+    MappedFile file(path);
+    if (!file.isOpen())
+        return false;
+    outHash = hashBytes(file.data(), file.size());
+    return true;
+}
@@ -0,0 +1,142 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+// Caminho absoluto normalizado ("a/../b/x.obj" e "b/x.obj" viram o mesmo)
+std::string canonicalAssetPath(const std::string &path);
+
+class AssetPack;
+
+// Hash do conteúdo do arquivo (hashBytes sobre o arquivo mapeado); false se não
+// abrir. Arquivos presentes no pacote de setAssetPack usam o hash gravado nele,
+// sem abrir o arquivo solto. Lê o arquivo inteiro: fora arquivos pequenos como
+// o .mtl, chamar das threads de trabalho e não da thread do GL.
+bool fileContentHash(const std::string &path, uint64_t &outHash);
+
+// Pacote consultado por fileContentHash (nullptr desliga); precisa viver até
+// setAssetPack(nullptr)
+void setAssetPack(const AssetPack *pack);
+
+// Cache de recursos compartilhados com contagem de referências.
+// acquire identifica o recurso só pelo caminho canônico e uma variante (ex.:
+// formato de vértice), sem ler o arquivo. O hash do conteúdo sai do job de
+// carregamento (o dos caches de malha e textura); com ele a completion chama
+// dedupe, que troca uma cópia idêntica por outro caminho pelo recurso que já
+// existe. Os handles são shared_ptr; quando o último handle some, o destrutor de
+// T libera o recurso (VAO, textura...).
+template <typename T>
+class AssetCache
+{
+public:
+    using Handle = std::shared_ptr<T>;
+
+    // load(path) devolve o recurso novo ou nullptr em caso de erro (não fica no cache)
+    template <typename Load>
+    Handle acquire(const std::string &path, const std::string &variant, Load load)
+    {
+        std::string key = canonicalAssetPath(path) + '|' + variant;
+        auto byPath = m_byPath.find(key);
+        if (byPath != m_byPath.end())
+        {
+            if (Handle handle = byPath->second.lock())
+            {
+                ++m_hits;
+                return handle;
+            }
+        }
+
+        Handle handle = load(path);
+        if (!handle)
+            return nullptr;
+        prune();
+        m_byPath[key] = handle;
+        ++m_loads;
+        return handle;
+    }
+
+    // Recurso vivo com esse conteúdo e variante (nullptr se nenhum)
+    Handle findContent(uint64_t contentHash, const std::string &variant) const
+    {
+        auto byContent = m_byContent.find(contentKey(contentHash, variant));
+        return byContent != m_byContent.end() ? byContent->second.lock() : nullptr;
+    }
+
+    // O conteúdo de handle ficou conhecido. Se outro recurso vivo tem o mesmo,
+    // os caminhos que apontavam para handle passam para ele, que é devolvido
+    // (quem segura handle troca quando quiser); senão handle fica registrado
+    // pelo conteúdo e é devolvido
+    Handle dedupe(const Handle &handle, uint64_t contentHash, const std::string &variant)
+    {
+        std::weak_ptr<T> &entry = m_byContent[contentKey(contentHash, variant)];
+        Handle existing = entry.lock();
+        if (!existing || existing == handle)
+        {
+            entry = handle;
+            return handle;
+        }
+        for (auto &byPath : m_byPath)
+            if (byPath.second.lock() == handle)
+                byPath.second = existing;
+        ++m_hits;
+        return existing;
+    }
+
+    // Recurso vivo carregado de path (nullptr se nenhum)
+    Handle find(const std::string &path, const std::string &variant) const
+    {
+        auto byPath = m_byPath.find(canonicalAssetPath(path) + '|' + variant);
+        return byPath != m_byPath.end() ? byPath->second.lock() : nullptr;
+    }
+
+    // path mudou no disco: carrega de novo e as próximas acquire devolvem o
+    // recurso novo. Quem tem handle do antigo continua com ele até trocá-lo;
+    // nullptr se load falhar (o antigo também sai do cache)
+    template <typename Load>
+    Handle reload(const std::string &path, const std::string &variant, Load load)
+    {
+        std::string key = canonicalAssetPath(path) + '|' + variant;
+        auto byPath = m_byPath.find(key);
+        if (byPath != m_byPath.end())
+        {
+            Handle previous = byPath->second.lock();
+            m_byPath.erase(byPath);
+            for (auto it = m_byContent.begin(); previous && it != m_byContent.end();)
+                it = it->second.lock() == previous ? m_byContent.erase(it) : std::next(it);
+        }
+        return acquire(path, variant, load);
+    }
+
+    // Recursos ainda referenciados por algum handle
+    size_t liveCount() const
+    {
+        size_t count = 0;
+        for (const auto &entry : m_byPath)
+            count += !entry.second.expired();
+        return count;
+    }
+
+    size_t loads() const { return m_loads; }
+    size_t hits() const { return m_hits; }
+
+private:
+    static uint64_t contentKey(uint64_t contentHash, const std::string &variant)
+    {
+        return contentHash ^ std::hash<std::string>()(variant);
+    }
+
+    // Remove entradas cujo recurso já foi liberado
+    void prune()
+    {
+        for (auto it = m_byPath.begin(); it != m_byPath.end();)
+            it = it->second.expired() ? m_byPath.erase(it) : std::next(it);
+        for (auto it = m_byContent.begin(); it != m_byContent.end();)
+            it = it->second.expired() ? m_byContent.erase(it) : std::next(it);
+    }
+
+    std::unordered_map<std::string, std::weak_ptr<T>> m_byPath;
+    std::unordered_map<uint64_t, std::weak_ptr<T>> m_byContent;
+    size_t m_loads = 0;
+    size_t m_hits = 0;
+};
@@ -0,0 +1,155 @@
+#include "AsyncLoader.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+AsyncLoader::AsyncLoader(unsigned threadCount)
+{
+    if (threadCount == 0)
+        threadCount = std::max(2u, std::thread::hardware_concurrency()) - 1;
+    m_threads.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i)
+        m_threads.emplace_back(&AsyncLoader::workerLoop, this);
+}
+
+AsyncLoader::~AsyncLoader()
+{
+    stop();
+}
+
+void AsyncLoader::submit(Job job)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping)
+            return;
+        m_jobs.push_back(std::move(job));
+        ++m_pending;
+    }
+    m_wake.notify_one();
+}
+
+void AsyncLoader::parallelFor(unsigned count, const std::function<void(unsigned)> &task)
+{
+    struct Batch
+    {
+        std::atomic<unsigned> next{0};
+        std::atomic<unsigned> done{0};
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+    auto batch = std::make_shared<Batch>();
+    // task só é usada enquanto houver partes a pegar, e esta função espera por todas
+    const std::function<void(unsigned)> *body = &task;
+    Task run = [batch, body, count]()
+    {
+        for (unsigned i = batch->next++; i < count; i = batch->next++)
+        {
+            (*body)(i);
+            if (++batch->done == count)
+            {
+                std::lock_guard<std::mutex> lock(batch->mutex);
+                batch->finished.notify_all();
+            }
+        }
+    };
+
+    unsigned helpers = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_stopping)
+            helpers = std::min<unsigned>(count > 0 ? count - 1 : 0, (unsigned)m_threads.size());
+        for (unsigned i = 0; i < helpers; ++i)
+            m_tasks.push_back(run);
+    }
+    for (unsigned i = 0; i < helpers; ++i)
+        m_wake.notify_one();
+
+    run();
+    std::unique_lock<std::mutex> lock(batch->mutex);
+    batch->finished.wait(lock, [&]
+                         { return batch->done == count; });
+}
+
+size_t AsyncLoader::runCompletions()
+{
+    std::vector<Completion> completed;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        completed.swap(m_completed);
+    }
+    // fora do lock: a conclusão pode enviar novos trabalhos
+    for (Completion &completion : completed)
+    {
+        if (completion)
+            completion();
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending -= completed.size();
+    }
+    return completed.size();
+}
+
+size_t AsyncLoader::pending() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_pending;
+}
+
+void AsyncLoader::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        m_jobs.clear();
+        m_tasks.clear(); // quem chamou parallelFor termina as partes sozinho
+    }
+    m_wake.notify_all();
+    for (std::thread &thread : m_threads)
+        thread.join();
+    m_threads.clear();
+
+    // destrói as conclusões aqui, enquanto quem chamou ainda tem o contexto GL
+    std::vector<Completion> completed;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        completed.swap(m_completed);
+        m_pending = 0;
+    }
+}
+
+void AsyncLoader::workerLoop()
+{
+    while (true)
+    {
+        Job job;
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this]
+                        { return m_stopping || !m_jobs.empty() || !m_tasks.empty(); });
+            if (m_stopping)
+                return;
+            if (!m_tasks.empty())
+            {
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+            }
+            else
+            {
+                job = std::move(m_jobs.front());
+                m_jobs.pop_front();
+            }
+        }
+        if (task)
+        {
+            task();
+            continue;
+        }
+
+        Completion completion = job();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_completed.push_back(std::move(completion));
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Carregamento em segundo plano: as threads de trabalho executam a parte de CPU
+// (parsing, decodificação de imagens) e devolvem uma "conclusão", que a thread
+// do OpenGL executa em runCompletions() para fazer o upload. Nenhuma função GL
+// é chamada pelas threads de trabalho, então o trabalho deve guardar o recurso
+// como weak_ptr: se o último handle sumir antes, o recurso é destruído na
+// thread GL e a conclusão simplesmente não encontra nada para preencher.
+class AsyncLoader
+{
+public:
+    using Completion = std::function<void()>;
+    using Job = std::function<Completion()>; // pode devolver uma conclusão vazia
+    using Task = std::function<void()>;
+
+    // threadCount 0: um a menos que os núcleos da máquina (a thread GL fica livre)
+    explicit AsyncLoader(unsigned threadCount = 0);
+    ~AsyncLoader();
+
+    AsyncLoader(const AsyncLoader &) = delete;
+    AsyncLoader &operator=(const AsyncLoader &) = delete;
+
+    void submit(Job job);
+
+    // Executa task(0..count-1) nas threads de trabalho e na thread que chama e
+    // só volta quando todas terminaram. Pode ser chamada de dentro de um
+    // trabalho: quem chama também pega partes, então nunca fica esperando por
+    // threads ocupadas. As partes passam na frente dos trabalhos da fila.
+    void parallelFor(unsigned count, const std::function<void(unsigned)> &task);
+
+    // Thread GL: executa as conclusões prontas e devolve quantas rodaram
+    size_t runCompletions();
+
+    // Trabalhos enviados cuja conclusão ainda não rodou
+    size_t pending() const;
+
+    // Para as threads; trabalhos na fila e conclusões não executadas são descartados
+    void stop();
+
+private:
+    void workerLoop();
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::deque<Job> m_jobs;
+    std::deque<Task> m_tasks; // partes de parallelFor
+    std::vector<Completion> m_completed;
+    std::vector<std::thread> m_threads;
+    size_t m_pending = 0;
+    bool m_stopping = false;
+};
@@ -38,29 +38,9 @@ void Camera::mouseCallback(double xpos, double ypos)
     m_lookAt = glm::normalize(m_lookAt);
 }
 
-void Camera::initCamera(GLuint shaderID)
-{
-    GLint camPosLoc = glGetUniformLocation(shaderID, "camPos");
-    glUniform3fv(camPosLoc, 1, glm::value_ptr(m_position));
-
-    GLint projectionLoc = glGetUniformLocation(shaderID, "projection");
-    glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)1000 / (float)1000, 0.1f, 100.0f);
-    glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, glm::value_ptr(projection));
-
-    m_viewLoc = glGetUniformLocation(shaderID, "view");
-    glm::mat4 view = glm::lookAt(
-        m_position, // posi��o da c�mera
-        m_lookAt,   // ponto para onde olha
-        m_cameraUp  // eixo "up" (para cima)
-    );
-    glUniformMatrix4fv(m_viewLoc, 1, GL_FALSE, glm::value_ptr(view));
-}
-
 void Camera::update(GLFWwindow *window)
 {
     processInput(window);
-    glm::mat4 view = glm::lookAt(m_position, m_position + m_lookAt, m_cameraUp);
-    glUniformMatrix4fv(m_viewLoc, 1, GL_FALSE, glm::value_ptr(view));
 }
 
 void Camera::processInput(GLFWwindow *window)
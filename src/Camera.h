@@ -11,7 +11,6 @@ public:
     void setPosition(const glm::vec3 &pos) { m_position = pos; }
     void setLookAt(glm::vec3 lookAt) { m_lookAt = lookAt; }
     void mouseCallback(double xpos, double ypos);
-    void initCamera(GLuint shaderID);
     void update(struct GLFWwindow *window);
     glm::vec3 getPosition() const { return m_position; }
     glm::vec3 getLookAt() const { return m_lookAt; }
@@ -27,9 +26,6 @@ private:
     glm::vec3 m_lookAt = glm::vec3(0.0f, 0.0f, 0.0f);
     glm::vec3 m_cameraUp = glm::vec3(0.0f, 1.0f, 0.0f);
 
-    GLint m_viewLoc;
-    GLuint m_shaderID;
-
     // Para controle de �ngulo
     float yaw = -90.0f; // Come�a olhando no -Z
     float pitch = 0.0f;
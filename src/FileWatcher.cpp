@@ -0,0 +1,128 @@
+#include "FileWatcher.h"
+#include <algorithm>
+#include <iostream>
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+static std::string canonicalWatchPath(const std::string &path)
+{
+    std::error_code ec;
+    fs::path canonical = fs::weakly_canonical(path, ec);
+    if (ec)
+        return fs::absolute(path, ec).lexically_normal().string();
+    return canonical.string();
+}
+
+void FileWatcher::start()
+{
+    if (m_running)
+        return;
+    m_running = true;
+    m_lastScan = std::chrono::steady_clock::now();
+#ifdef __linux__
+    m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_fd < 0)
+        std::cerr << "Aviso: inotify indisponivel, comparando datas dos arquivos" << std::endl;
+#endif
+}
+
+void FileWatcher::stop()
+{
+#ifdef __linux__
+    if (m_fd >= 0)
+        close(m_fd);
+#endif
+    m_fd = -1;
+    m_running = false;
+    m_files.clear();
+    m_folders.clear();
+    m_folderWatch.clear();
+}
+
+void FileWatcher::watch(const std::string &path)
+{
+    if (!m_running)
+        return;
+    std::string canonical = canonicalWatchPath(path);
+    if (m_files.count(canonical))
+        return;
+
+    std::error_code ec;
+    Watched &watched = m_files[canonical];
+    watched = {path, fs::last_write_time(canonical, ec), true};
+#ifdef __linux__
+    if (m_fd < 0)
+        return;
+    std::string folder = fs::path(canonical).parent_path().string();
+    auto known = m_folderWatch.find(folder);
+    if (known == m_folderWatch.end())
+    {
+        int wd = inotify_add_watch(m_fd, folder.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (wd < 0)
+            std::cerr << "Aviso: nao foi possivel observar " << folder << ", comparando datas" << std::endl;
+        else
+            m_folders[wd] = folder;
+        known = m_folderWatch.emplace(folder, wd).first;
+    }
+    watched.polled = known->second < 0;
+#endif
+}
+
+void FileWatcher::poll(std::vector<std::string> &changed)
+{
+    if (!m_running)
+        return;
+    size_t first = changed.size();
+    pollTimes(changed);
+#ifdef __linux__
+    if (m_fd >= 0)
+    {
+        alignas(inotify_event) char buffer[4096];
+        while (true)
+        {
+            ssize_t bytes = read(m_fd, buffer, sizeof(buffer));
+            if (bytes <= 0)
+                break; // EAGAIN: nada pendente
+            for (char *cursor = buffer; cursor < buffer + bytes;)
+            {
+                const inotify_event *event = (const inotify_event *)cursor;
+                cursor += sizeof(inotify_event) + event->len;
+                auto folder = m_folders.find(event->wd);
+                if (folder == m_folders.end() || event->len == 0)
+                    continue;
+                auto file = m_files.find((fs::path(folder->second) / event->name).string());
+                if (file != m_files.end())
+                    changed.push_back(file->second.path);
+            }
+        }
+    }
+#endif
+
+    // um save pode gerar mais de um evento
+    std::sort(changed.begin() + first, changed.end());
+    changed.erase(std::unique(changed.begin() + first, changed.end()), changed.end());
+}
+
+void FileWatcher::pollTimes(std::vector<std::string> &changed)
+{
+    auto now = std::chrono::steady_clock::now();
+    if (now - m_lastScan < std::chrono::milliseconds(250))
+        return;
+    m_lastScan = now;
+    for (auto &entry : m_files)
+    {
+        if (!entry.second.polled)
+            continue;
+        std::error_code ec;
+        fs::file_time_type mtime = fs::last_write_time(entry.first, ec);
+        if (!ec && mtime != entry.second.mtime)
+        {
+            entry.second.mtime = mtime;
+            changed.push_back(entry.second.path);
+        }
+    }
+}
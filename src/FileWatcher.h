@@ -0,0 +1,50 @@
+#pragma once
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Avisa quando arquivos observados mudam no disco. No Linux usa inotify nas
+// pastas dos arquivos (editores costumam gravar um temporário e renomear, o que
+// trocaria o inode de um arquivo observado diretamente); nos outros sistemas,
+// se o inotify não abrir ou se a pasta não puder ser observada, compara a data
+// de modificação a cada 250 ms.
+// Só a thread principal usa.
+class FileWatcher
+{
+public:
+    FileWatcher() = default;
+    ~FileWatcher() { stop(); }
+
+    FileWatcher(const FileWatcher &) = delete;
+    FileWatcher &operator=(const FileWatcher &) = delete;
+
+    void start();
+    void stop();
+    bool running() const { return m_running; }
+
+    // Passa a observar path (repetir o mesmo arquivo não faz nada)
+    void watch(const std::string &path);
+
+    // Acrescenta em changed os arquivos gravados desde a última chamada, uma vez
+    // cada, com o caminho usado no primeiro watch()
+    void poll(std::vector<std::string> &changed);
+
+private:
+    struct Watched
+    {
+        std::string path;
+        std::filesystem::file_time_type mtime;
+        bool polled; // sem watch do inotify na pasta: compara a data
+    };
+
+    void pollTimes(std::vector<std::string> &changed);
+
+    bool m_running = false;
+    int m_fd = -1;                                      // inotify; -1 = comparação de datas
+    std::unordered_map<std::string, Watched> m_files;   // caminho canônico
+    std::unordered_map<int, std::string> m_folders;     // watch do inotify -> pasta canônica
+    std::unordered_map<std::string, int> m_folderWatch; // pasta canônica -> watch; -1 se falhou
+    std::chrono::steady_clock::time_point m_lastScan;
+};
@@ -0,0 +1,45 @@
+#include "FrameConstants.h"
+#include <cstring>
+
+const char *FRAME_CONSTANTS_GLSL = R"glsl(
+layout (std140, binding = 0) uniform FrameConstants // FRAME_CONSTANTS_BINDING
+{
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    float ambientStrength;
+    vec3 lightPos;
+    float diffuseStrength;
+    vec3 lightColor;
+    float specularStrength;
+};
+)glsl";
+
+void FrameConstants::create()
+{
+    destroy();
+    glGenBuffers(1, &m_buffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameConstantsData), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_CONSTANTS_BINDING, m_buffer);
+}
+
+void FrameConstants::destroy()
+{
+    if (m_buffer)
+        glDeleteBuffers(1, &m_buffer);
+    m_buffer = 0;
+    m_written = false;
+}
+
+void FrameConstants::update(const FrameConstantsData &data)
+{
+    if (!m_buffer || (m_written && memcmp(&m_data, &data, sizeof(data)) == 0))
+        return;
+    m_data = data;
+    m_written = true;
+    glBindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(data), &data);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+// Constantes do quadro (câmera, projeção e luz) num uniform buffer ligado a um
+// binding fixo: escritas uma vez por quadro e lidas por todos os programas que
+// declaram o bloco (FRAME_CONSTANTS_GLSL), sem uniforms por programa.
+
+const GLuint FRAME_CONSTANTS_BINDING = 0;
+
+// Layout std140 do bloco; cada vec3 divide os 16 bytes com o float seguinte
+struct FrameConstantsData
+{
+    glm::mat4 view = glm::mat4(1.0f);
+    glm::mat4 projection = glm::mat4(1.0f);
+    glm::vec3 viewPos = glm::vec3(0.0f);
+    float ambientStrength = 1.0f;
+    glm::vec3 lightPos = glm::vec3(0.0f);
+    float diffuseStrength = 1.0f;
+    glm::vec3 lightColor = glm::vec3(1.0f);
+    float specularStrength = 1.0f;
+};
+static_assert(sizeof(FrameConstantsData) == 176, "FrameConstantsData precisa seguir o layout std140 do bloco");
+
+// Declaração do bloco para os shaders (ShaderProgram::build insere depois do
+// #version); os membros são usados pelo nome, como uniforms soltos
+extern const char *FRAME_CONSTANTS_GLSL;
+
+class FrameConstants
+{
+public:
+    FrameConstants() = default;
+    ~FrameConstants() { destroy(); }
+
+    FrameConstants(const FrameConstants &) = delete;
+    FrameConstants &operator=(const FrameConstants &) = delete;
+
+    // Cria o buffer e o liga em FRAME_CONSTANTS_BINDING
+    void create();
+    void destroy();
+
+    // Uma vez por quadro, antes dos draws; não envia nada se nada mudou
+    void update(const FrameConstantsData &data);
+
+private:
+    GLuint m_buffer = 0;
+    FrameConstantsData m_data;
+    bool m_written = false;
+};
@@ -0,0 +1,36 @@
+#include "GLExt.h"
+#include <GLFW/glfw3.h>
+
+PFNGLBUFFERSTORAGEPROC_EXT glext_glBufferStorage = nullptr;
+bool GLEXT_buffer_storage = false;
+PFNGLTEXSTORAGE3DPROC_EXT glext_glTexStorage3D = nullptr;
+bool GLEXT_texture_storage = false;
+bool GLEXT_texture_compression_s3tc = false;
+PFNGLMULTIDRAWELEMENTSINDIRECTPROC_EXT glext_glMultiDrawElementsIndirect = nullptr;
+bool GLEXT_multi_draw_indirect = false;
+PFNGLCOPYIMAGESUBDATAPROC_EXT glext_glCopyImageSubData = nullptr;
+bool GLEXT_copy_image = false;
+
+static bool versionAtLeast(int major, int minor)
+{
+    return GLVersion.major > major || (GLVersion.major == major && GLVersion.minor >= minor);
+}
+
+void loadGLExtensions()
+{
+    if (versionAtLeast(4, 4) || glfwExtensionSupported("GL_ARB_buffer_storage"))
+        glext_glBufferStorage = (PFNGLBUFFERSTORAGEPROC_EXT)glfwGetProcAddress("glBufferStorage");
+    GLEXT_buffer_storage = glext_glBufferStorage != nullptr;
+    if (versionAtLeast(4, 2) || glfwExtensionSupported("GL_ARB_texture_storage"))
+        glext_glTexStorage3D = (PFNGLTEXSTORAGE3DPROC_EXT)glfwGetProcAddress("glTexStorage3D");
+    GLEXT_texture_storage = glext_glTexStorage3D != nullptr;
+    GLEXT_texture_compression_s3tc = glfwExtensionSupported("GL_EXT_texture_compression_s3tc");
+    // baseInstance dos comandos precisa do 4.2 / ARB_base_instance
+    if (versionAtLeast(4, 3) ||
+        (glfwExtensionSupported("GL_ARB_multi_draw_indirect") && glfwExtensionSupported("GL_ARB_base_instance")))
+        glext_glMultiDrawElementsIndirect = (PFNGLMULTIDRAWELEMENTSINDIRECTPROC_EXT)glfwGetProcAddress("glMultiDrawElementsIndirect");
+    GLEXT_multi_draw_indirect = glext_glMultiDrawElementsIndirect != nullptr;
+    if (versionAtLeast(4, 3) || glfwExtensionSupported("GL_ARB_copy_image"))
+        glext_glCopyImageSubData = (PFNGLCOPYIMAGESUBDATAPROC_EXT)glfwGetProcAddress("glCopyImageSubData");
+    GLEXT_copy_image = glext_glCopyImageSubData != nullptr;
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <glad/glad.h>
+
+// Funções posteriores ao OpenGL 4.0 (o glad do projeto foi gerado só até 4.0).
+// loadGLExtensions() procura cada uma com glfwGetProcAddress, no mesmo padrão
+// de nomes do glad; o booleano correspondente diz se ela pode ser usada.
+
+// GL 4.4 / ARB_buffer_storage
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_COHERENT_BIT 0x0080
+#define GL_DYNAMIC_STORAGE_BIT 0x0100
+#define GL_CLIENT_STORAGE_BIT 0x0200
+#endif
+typedef void(APIENTRYP PFNGLBUFFERSTORAGEPROC_EXT)(GLenum target, GLsizeiptr size, const void *data, GLbitfield flags);
+extern PFNGLBUFFERSTORAGEPROC_EXT glext_glBufferStorage;
+#define glBufferStorage glext_glBufferStorage
+extern bool GLEXT_buffer_storage;
+
+// GL 4.2 / ARB_texture_storage: todos os níveis alocados de uma vez, imutáveis
+typedef void(APIENTRYP PFNGLTEXSTORAGE3DPROC_EXT)(GLenum target, GLsizei levels, GLenum internalformat, GLsizei width,
+                                                  GLsizei height, GLsizei depth);
+extern PFNGLTEXSTORAGE3DPROC_EXT glext_glTexStorage3D;
+#define glTexStorage3D glext_glTexStorage3D
+extern bool GLEXT_texture_storage;
+
+// EXT_texture_compression_s3tc (BC1/BC3): extensão, nunca entrou no núcleo
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+extern bool GLEXT_texture_compression_s3tc;
+
+// GL 4.3 / ARB_multi_draw_indirect: vários glDrawElementsInstancedBaseVertexBaseInstance
+// lidos do GL_DRAW_INDIRECT_BUFFER numa chamada só
+typedef void(APIENTRYP PFNGLMULTIDRAWELEMENTSINDIRECTPROC_EXT)(GLenum mode, GLenum type, const void *indirect,
+                                                               GLsizei drawcount, GLsizei stride);
+extern PFNGLMULTIDRAWELEMENTSINDIRECTPROC_EXT glext_glMultiDrawElementsIndirect;
+#define glMultiDrawElementsIndirect glext_glMultiDrawElementsIndirect
+extern bool GLEXT_multi_draw_indirect;
+
+// GL 4.3 / ARB_copy_image: cópia direta entre texturas, inclusive comprimidas
+typedef void(APIENTRYP PFNGLCOPYIMAGESUBDATAPROC_EXT)(GLuint srcName, GLenum srcTarget, GLint srcLevel, GLint srcX,
+                                                      GLint srcY, GLint srcZ, GLuint dstName, GLenum dstTarget,
+                                                      GLint dstLevel, GLint dstX, GLint dstY, GLint dstZ,
+                                                      GLsizei srcWidth, GLsizei srcHeight, GLsizei srcDepth);
+extern PFNGLCOPYIMAGESUBDATAPROC_EXT glext_glCopyImageSubData;
+#define glCopyImageSubData glext_glCopyImageSubData
+extern bool GLEXT_copy_image;
+
+// GL 4.3 / ARB_shader_storage_buffer_object: só constantes (glBindBufferBase é
+// do 3.0); os shaders #version 450 já exigem um contexto 4.5
+#ifndef GL_SHADER_STORAGE_BUFFER
+#define GL_SHADER_STORAGE_BUFFER 0x90D2
+#endif
+
+// Precisa de um contexto atual e do glad já carregado
+void loadGLExtensions();
@@ -0,0 +1,161 @@
+#include "GLUploader.h"
+#include <chrono>
+#include <iostream>
+
+bool GLUploader::start(GLFWwindow *mainWindow)
+{
+    if (m_context)
+        return true;
+
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    m_context = glfwCreateWindow(1, 1, "upload", nullptr, mainWindow);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+    if (!m_context)
+    {
+        std::cerr << "Aviso: contexto de upload nao criado, uploads na thread principal" << std::endl;
+        return false;
+    }
+
+    m_stopping = false;
+    m_thread = std::thread(&GLUploader::threadLoop, this);
+    return true;
+}
+
+void GLUploader::stop()
+{
+    if (!m_context)
+        return;
+    std::deque<Queued> discarded;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        discarded.swap(m_queue);
+    }
+    m_wake.notify_all();
+    m_thread.join();
+
+    // fences são compartilhadas: o contexto principal espera cada uma (a thread
+    // já fez glFlush depois delas) e publica, em ordem
+    for (Fenced &fenced : m_fenced)
+    {
+        GLenum status;
+        do
+            status = glClientWaitSync(fenced.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+        while (status == GL_TIMEOUT_EXPIRED);
+        glDeleteSync(fenced.fence);
+        if (fenced.publish)
+            fenced.publish();
+    }
+    m_fenced.clear();
+    for (Queued &task : discarded)
+        if (task.publish)
+            task.publish();
+    m_timings.clear();
+    m_pending = 0;
+
+    glfwDestroyWindow(m_context);
+    m_context = nullptr;
+}
+
+void GLUploader::submit(Task upload, Task publish, size_t bytes)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back({std::move(upload), std::move(publish), bytes});
+        ++m_pending;
+    }
+    m_wake.notify_one();
+}
+
+size_t GLUploader::publishReady()
+{
+    std::deque<Fenced> ready;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        // um só contexto envia as fences, então elas sinalizam na ordem da fila
+        while (!m_fenced.empty())
+        {
+            GLint status = GL_UNSIGNALED;
+            glGetSynciv(m_fenced.front().fence, GL_SYNC_STATUS, 1, nullptr, &status);
+            if (status != GL_SIGNALED)
+                break;
+            ready.push_back(std::move(m_fenced.front()));
+            m_fenced.pop_front();
+        }
+    }
+    for (Fenced &fenced : ready)
+    {
+        glDeleteSync(fenced.fence);
+        if (fenced.publish)
+            fenced.publish();
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending -= ready.size();
+    }
+    return ready.size();
+}
+
+size_t GLUploader::pending() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_pending;
+}
+
+size_t GLUploader::queued() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_queue.size();
+}
+
+void GLUploader::takeTimings(std::vector<UploadTiming> &out)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    out.insert(out.end(), m_timings.begin(), m_timings.end());
+    m_timings.clear();
+}
+
+void GLUploader::threadLoop()
+{
+    glfwMakeContextCurrent(m_context);
+    UploadTimer timer;
+    std::vector<UploadTiming> timings;
+    while (true)
+    {
+        Queued task;
+        {
+            // com consultas pendentes acorda de tempos em tempos para lê-las
+            std::unique_lock<std::mutex> lock(m_mutex);
+            auto wake = [this]
+            { return m_stopping || !m_queue.empty(); };
+            if (timer.waiting())
+                m_wake.wait_for(lock, std::chrono::milliseconds(2), wake);
+            else
+                m_wake.wait(lock, wake);
+            if (m_stopping)
+                break;
+        }
+        timings.clear();
+        timer.poll(timings);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_timings.insert(m_timings.end(), timings.begin(), timings.end());
+            if (m_queue.empty())
+                continue;
+            task = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        timer.begin();
+        task.upload();
+        timer.end(task.bytes, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glFlush(); // garante que a fence chegue à GPU sem esperar o próximo upload
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_fenced.push_back({fence, std::move(task.publish)});
+    }
+    timer.destroy();
+    glfwMakeContextCurrent(nullptr);
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include "UploadTimer.h"
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Thread de upload com um segundo contexto GL (janela invisível que compartilha
+// buffers, texturas e fences com a janela principal). Cada tarefa roda o upload
+// nesse contexto e grava uma fence; publishReady(), chamado pela thread
+// principal a cada quadro, executa o "publish" das tarefas cujas fences já
+// sinalizaram, sem nunca esperar pela GPU.
+//
+// VAOs não são compartilhados entre contextos: o upload cria só buffers e
+// texturas, e o VAO é montado no publish.
+//
+// Cada upload é medido com uma consulta de tempo no contexto da thread; quem
+// dosa os envios por quadro (UploadScheduler) lê as medições com takeTimings().
+class GLUploader
+{
+public:
+    using Task = std::function<void()>;
+
+    GLUploader() = default;
+    ~GLUploader() { stop(); }
+
+    GLUploader(const GLUploader &) = delete;
+    GLUploader &operator=(const GLUploader &) = delete;
+
+    // Thread principal (o GLFW exige): cria o contexto compartilhado e a thread;
+    // false se o contexto não pôde ser criado
+    bool start(GLFWwindow *mainWindow);
+
+    // Thread principal: encerra a thread e destrói o contexto. Uploads que a
+    // thread não começou são descartados, mas todo publish pendente roda (os
+    // enviados depois de esperar a fence), para que os recursos cujo alvo já
+    // sumiu sejam apagados
+    void stop();
+
+    bool running() const { return m_context != nullptr; }
+
+    // upload roda no contexto da thread de upload; publish (pode ser vazio), na
+    // thread principal. bytes só entra nas medições de tempo.
+    void submit(Task upload, Task publish, size_t bytes = 0);
+
+    // Thread principal: publica as tarefas concluídas pela GPU, em ordem
+    size_t publishReady();
+
+    // Tarefas enviadas e ainda não publicadas
+    size_t pending() const;
+
+    // Tarefas que a thread ainda não começou
+    size_t queued() const;
+
+    // Move para out as medições de upload concluídas desde a última chamada
+    void takeTimings(std::vector<UploadTiming> &out);
+
+private:
+    struct Queued
+    {
+        Task upload;
+        Task publish;
+        size_t bytes;
+    };
+
+    struct Fenced
+    {
+        GLsync fence;
+        Task publish;
+    };
+
+    void threadLoop();
+
+    GLFWwindow *m_context = nullptr;
+    std::thread m_thread;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::deque<Queued> m_queue;
+    std::deque<Fenced> m_fenced;
+    std::vector<UploadTiming> m_timings;
+    size_t m_pending = 0;
+    bool m_stopping = false;
+};
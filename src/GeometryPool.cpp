@@ -0,0 +1,117 @@
+#include "GeometryPool.h"
+
+void GeometryPool::FreeList::reset(size_t capacity)
+{
+    ranges.clear();
+    if (capacity > 0)
+        ranges[0] = capacity;
+    used = 0;
+}
+
+bool GeometryPool::FreeList::allocate(size_t count, size_t &outFirst)
+{
+    if (count == 0)
+    {
+        outFirst = 0;
+        return true;
+    }
+    for (auto it = ranges.begin(); it != ranges.end(); ++it)
+    {
+        if (it->second < count)
+            continue;
+        outFirst = it->first;
+        size_t remaining = it->second - count;
+        ranges.erase(it);
+        if (remaining > 0)
+            ranges[outFirst + count] = remaining;
+        used += count;
+        return true;
+    }
+    return false;
+}
+
+void GeometryPool::FreeList::release(size_t first, size_t count)
+{
+    if (count == 0)
+        return;
+    used -= count;
+    auto next = ranges.lower_bound(first);
+    if (next != ranges.begin())
+    {
+        auto previous = std::prev(next);
+        if (previous->first + previous->second == first)
+        {
+            first = previous->first;
+            count += previous->second;
+            ranges.erase(previous);
+        }
+    }
+    if (next != ranges.end() && first + count == next->first)
+    {
+        count += next->second;
+        ranges.erase(next);
+    }
+    ranges[first] = count;
+}
+
+void GeometryPool::create(size_t vertexSize, GLenum indexType, size_t vertexCapacity, size_t indexCapacity,
+                          const std::function<void()> &setupAttributes)
+{
+    destroy();
+    m_vertexSize = vertexSize;
+    m_indexType = indexType;
+    m_vertices.reset(vertexCapacity);
+    m_indices.reset(indexCapacity);
+
+    glGenVertexArrays(1, &m_vao);
+    glGenBuffers(1, &m_vertexBuffer);
+    glGenBuffers(1, &m_indexBuffer);
+    glBindVertexArray(m_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(vertexCapacity * vertexSize), nullptr, GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)(indexCapacity * indexSize()), nullptr, GL_STATIC_DRAW);
+    setupAttributes();
+
+    // o EBO fica associado ao VAO; só desvincula depois do VAO
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+void GeometryPool::destroy()
+{
+    if (m_vao)
+        glDeleteVertexArrays(1, &m_vao);
+    if (m_vertexBuffer)
+        glDeleteBuffers(1, &m_vertexBuffer);
+    if (m_indexBuffer)
+        glDeleteBuffers(1, &m_indexBuffer);
+    m_vao = m_vertexBuffer = m_indexBuffer = 0;
+    m_vertices.reset(0);
+    m_indices.reset(0);
+}
+
+bool GeometryPool::allocate(size_t vertexCount, size_t indexCount, GeometryRange &out)
+{
+    if (!m_vao)
+        return false;
+    size_t firstVertex, firstIndex;
+    if (!m_vertices.allocate(vertexCount, firstVertex))
+        return false;
+    if (!m_indices.allocate(indexCount, firstIndex))
+    {
+        m_vertices.release(firstVertex, vertexCount);
+        return false;
+    }
+    out = {firstVertex, vertexCount, firstIndex, indexCount};
+    return true;
+}
+
+void GeometryPool::release(const GeometryRange &range)
+{
+    if (!m_vao)
+        return;
+    m_vertices.release(range.firstVertex, range.vertexCount);
+    m_indices.release(range.firstIndex, range.indexCount);
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <glad/glad.h>
+#include <cstddef>
+#include <functional>
+#include <map>
+
+// Faixa de uma malha no pool, em vértices e em índices
+struct GeometryRange
+{
+    size_t firstVertex = 0;
+    size_t vertexCount = 0;
+    size_t firstIndex = 0;
+    size_t indexCount = 0;
+};
+
+// Vértices e índices de muitas malhas sub-alocados de um VBO e um EBO grandes,
+// sob um só VAO: todas as malhas do pool podem sair num único
+// glMultiDrawElementsIndirect (baseVertex e firstIndex de cada comando apontam
+// a faixa da malha). Um pool tem um layout de vértice e um tipo de índice.
+//
+// A capacidade é fixa (os buffers nunca são trocados, então as fatias enviadas
+// pela thread de upload não se perdem); quem não couber usa buffers próprios.
+// allocate e release só na thread principal.
+class GeometryPool
+{
+public:
+    GeometryPool() = default;
+    ~GeometryPool() { destroy(); }
+
+    GeometryPool(const GeometryPool &) = delete;
+    GeometryPool &operator=(const GeometryPool &) = delete;
+
+    // setupAttributes roda com o VAO e o VBO vinculados e aponta os atributos
+    // de vértice a partir do byte 0 do VBO
+    void create(size_t vertexSize, GLenum indexType, size_t vertexCapacity, size_t indexCapacity,
+                const std::function<void()> &setupAttributes);
+    void destroy();
+    bool isCreated() const { return m_vao != 0; }
+
+    // false se não houver faixa livre grande o bastante
+    bool allocate(size_t vertexCount, size_t indexCount, GeometryRange &out);
+    void release(const GeometryRange &range);
+
+    GLuint vao() const { return m_vao; }
+    GLuint vertexBuffer() const { return m_vertexBuffer; }
+    GLuint indexBuffer() const { return m_indexBuffer; }
+    size_t vertexSize() const { return m_vertexSize; }
+    size_t indexSize() const { return m_indexType == GL_UNSIGNED_SHORT ? 2 : 4; }
+    GLenum indexType() const { return m_indexType; }
+    size_t usedVertices() const { return m_vertices.used; }
+    size_t usedIndices() const { return m_indices.used; }
+
+private:
+    // Faixas livres por início, vizinhas unidas ao liberar; a primeira que
+    // couber é usada
+    struct FreeList
+    {
+        std::map<size_t, size_t> ranges; // início -> tamanho
+        size_t used = 0;
+
+        void reset(size_t capacity);
+        bool allocate(size_t count, size_t &outFirst);
+        void release(size_t first, size_t count);
+    };
+
+    GLuint m_vao = 0;
+    GLuint m_vertexBuffer = 0;
+    GLuint m_indexBuffer = 0;
+    size_t m_vertexSize = 0;
+    GLenum m_indexType = GL_UNSIGNED_INT;
+    FreeList m_vertices;
+    FreeList m_indices;
+};
@@ -0,0 +1,182 @@
+#include "IndirectDrawBuffer.h"
+#include <algorithm>
+
+void IndirectDrawBuffer::create(GLuint recordBinding, GLuint drawIdLocation, size_t capacity)
+{
+    destroy();
+    m_recordBinding = recordBinding;
+    m_drawIdLocation = drawIdLocation;
+    capacity = std::max<size_t>(capacity, 1);
+    glGenBuffers(1, &m_recordBuffer);
+    glGenBuffers(1, &m_commandBuffer);
+    glGenBuffers(1, &m_drawIdBuffer);
+    reserve(GL_SHADER_STORAGE_BUFFER, m_recordBuffer, m_recordCapacity, capacity, sizeof(DrawRecord));
+    reserve(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer, m_commandCapacity, capacity, sizeof(DrawCommand));
+    // glBufferData no mesmo nome mantém o buffer ligado no binding
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, m_recordBinding, m_recordBuffer);
+}
+
+void IndirectDrawBuffer::destroy()
+{
+    GLuint buffers[3] = {m_recordBuffer, m_commandBuffer, m_drawIdBuffer};
+    if (m_recordBuffer)
+        glDeleteBuffers(3, buffers);
+    m_recordBuffer = m_commandBuffer = m_drawIdBuffer = 0;
+    m_recordCapacity = m_commandCapacity = m_drawIdCapacity = 0;
+    m_records.clear();
+    m_lists.clear();
+    m_usedLists = m_lastList = 0;
+}
+
+void IndirectDrawBuffer::begin()
+{
+    m_records.clear();
+    for (size_t i = 0; i < m_usedLists; ++i)
+        m_lists[i].commands.clear();
+    m_usedLists = m_lastList = 0;
+}
+
+GLuint IndirectDrawBuffer::addRecord(const DrawRecord &record)
+{
+    m_records.push_back(record);
+    return (GLuint)(m_records.size() - 1);
+}
+
+void IndirectDrawBuffer::addCommand(GLuint vao, GLenum indexType, bool indirect, const DrawCommand &command)
+{
+    auto matches = [&](const CommandList &list)
+    { return list.vao == vao && list.indexType == indexType && list.indirect == indirect; };
+    if (m_lastList >= m_usedLists || !matches(m_lists[m_lastList]))
+    {
+        m_lastList = 0;
+        while (m_lastList < m_usedLists && !matches(m_lists[m_lastList]))
+            ++m_lastList;
+        if (m_lastList == m_usedLists)
+        {
+            if (m_usedLists == m_lists.size())
+                m_lists.push_back(CommandList());
+            CommandList &list = m_lists[m_usedLists++];
+            list.vao = vao;
+            list.indexType = indexType;
+            list.indirect = indirect;
+        }
+    }
+    m_lists[m_lastList].commands.push_back(command);
+}
+
+void IndirectDrawBuffer::reserve(GLenum target, GLuint buffer, size_t &capacity, size_t count, size_t elementSize)
+{
+    if (count <= capacity)
+        return;
+    capacity = std::max<size_t>(capacity, 1);
+    while (capacity < count)
+        capacity *= 2;
+    glBindBuffer(target, buffer);
+    glBufferData(target, (GLsizeiptr)(capacity * elementSize), nullptr, GL_STREAM_DRAW);
+    glBindBuffer(target, 0);
+}
+
+void IndirectDrawBuffer::attachDrawIds(GLuint first) const
+{
+    glBindBuffer(GL_ARRAY_BUFFER, m_drawIdBuffer);
+    glVertexAttribIPointer(m_drawIdLocation, 1, GL_UNSIGNED_INT, sizeof(GLuint), (void *)(first * sizeof(GLuint)));
+    glVertexAttribDivisor(m_drawIdLocation, 1);
+    glEnableVertexAttribArray(m_drawIdLocation);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+size_t IndirectDrawBuffer::submit()
+{
+    if (!m_recordBuffer || m_records.empty())
+        return 0;
+
+    // Registros: o buffer do quadro anterior é trocado por um novo em vez de
+    // esperar os draws que ainda o leem
+    reserve(GL_SHADER_STORAGE_BUFFER, m_recordBuffer, m_recordCapacity, m_records.size(), sizeof(DrawRecord));
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_recordBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, (GLsizeiptr)(m_recordCapacity * sizeof(DrawRecord)), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, (GLsizeiptr)(m_records.size() * sizeof(DrawRecord)), m_records.data());
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    // Ids 0, 1, 2...: só mudam quando o buffer cresce
+    if (m_records.size() > m_drawIdCapacity)
+    {
+        reserve(GL_ARRAY_BUFFER, m_drawIdBuffer, m_drawIdCapacity, m_records.size(), sizeof(GLuint));
+        std::vector<GLuint> ids(m_drawIdCapacity);
+        for (size_t i = 0; i < ids.size(); ++i)
+            ids[i] = (GLuint)i;
+        glBindBuffer(GL_ARRAY_BUFFER, m_drawIdBuffer);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)(ids.size() * sizeof(GLuint)), ids.data());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    // Comandos indiretos de todas as listas num buffer só
+    m_indirectCommands.clear();
+    for (size_t i = 0; i < m_usedLists; ++i)
+    {
+        CommandList &list = m_lists[i];
+        if (!list.indirect)
+            continue;
+        list.bufferOffset = m_indirectCommands.size() * sizeof(DrawCommand);
+        m_indirectCommands.insert(m_indirectCommands.end(), list.commands.begin(), list.commands.end());
+    }
+    if (!m_indirectCommands.empty())
+    {
+        reserve(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer, m_commandCapacity, m_indirectCommands.size(), sizeof(DrawCommand));
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, (GLsizeiptr)(m_commandCapacity * sizeof(DrawCommand)), nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, (GLsizeiptr)(m_indirectCommands.size() * sizeof(DrawCommand)),
+                        m_indirectCommands.data());
+    }
+
+    size_t calls = 0;
+    for (size_t i = 0; i < m_usedLists; ++i)
+    {
+        const CommandList &list = m_lists[i];
+        glBindVertexArray(list.vao);
+        if (list.indirect)
+        {
+            attachDrawIds(0);
+            glMultiDrawElementsIndirect(GL_TRIANGLES, list.indexType, (const void *)list.bufferOffset,
+                                        (GLsizei)list.commands.size(), 0);
+            ++calls;
+            continue;
+        }
+
+        // Sem draw indireto: comandos seguidos de uma instância sobre o mesmo
+        // registro (faixas de meshlets) viram um glMultiDrawElementsBaseVertex
+        size_t indexSize = list.indexType == GL_UNSIGNED_SHORT ? 2 : 4;
+        for (size_t first = 0, last; first < list.commands.size(); first = last)
+        {
+            const DrawCommand &command = list.commands[first];
+            attachDrawIds(command.baseInstance);
+            last = first + 1;
+            if (command.instanceCount != 1)
+            {
+                glDrawElementsInstancedBaseVertex(GL_TRIANGLES, (GLsizei)command.count, list.indexType,
+                                                  (const void *)(command.firstIndex * indexSize),
+                                                  (GLsizei)command.instanceCount, command.baseVertex);
+                ++calls;
+                continue;
+            }
+            while (last < list.commands.size() && list.commands[last].instanceCount == 1 &&
+                   list.commands[last].baseInstance == command.baseInstance)
+                ++last;
+            m_counts.clear();
+            m_offsets.clear();
+            m_baseVertices.clear();
+            for (size_t c = first; c < last; ++c)
+            {
+                m_counts.push_back((GLsizei)list.commands[c].count);
+                m_offsets.push_back((const void *)(list.commands[c].firstIndex * indexSize));
+                m_baseVertices.push_back(list.commands[c].baseVertex);
+            }
+            glMultiDrawElementsBaseVertex(GL_TRIANGLES, m_counts.data(), list.indexType, m_offsets.data(),
+                                          (GLsizei)m_counts.size(), m_baseVertices.data());
+            ++calls;
+        }
+    }
+    glBindVertexArray(0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    return calls;
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include "GLExt.h"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Draws de um quadro montados na CPU e enviados de uma vez: cada comando segue o
+// layout de glMultiDrawElementsIndirect, e as instâncias dele leem registros
+// (model, dequantização, material) de um shader storage buffer. O índice do
+// registro chega ao vertex shader por um atributo uint com divisor 1 sobre um
+// buffer de ids 0, 1, 2...: a instância i de um comando lê o id baseInstance + i.
+//
+// Comandos de um VAO de GeometryPool saem num glMultiDrawElementsIndirect por
+// VAO; os de VAOs próprios (malha fora do pool ou GL sem draw indireto) são
+// desenhados um a um, com o atributo de id apontado para o primeiro registro.
+
+// DrawElementsIndirectCommand do GL
+struct DrawCommand
+{
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLint baseVertex;
+    GLuint baseInstance;
+};
+static_assert(sizeof(DrawCommand) == 20, "DrawCommand precisa seguir o layout do GL");
+
+// Um registro no buffer; o mesmo layout (std430) do struct DrawData do shader
+struct DrawRecord
+{
+    glm::mat4 model;
+    glm::mat4 dequantize; // da malha; identidade no formato float
+    int materialIndex = 0;
+    int padding[3] = {0, 0, 0};
+};
+static_assert(sizeof(DrawRecord) == 144, "DrawRecord precisa seguir o layout std430 do shader");
+
+// Só a thread principal usa
+class IndirectDrawBuffer
+{
+public:
+    IndirectDrawBuffer() = default;
+    ~IndirectDrawBuffer() { destroy(); }
+
+    IndirectDrawBuffer(const IndirectDrawBuffer &) = delete;
+    IndirectDrawBuffer &operator=(const IndirectDrawBuffer &) = delete;
+
+    // recordBinding: binding do SSBO de registros; drawIdLocation: atributo
+    // uint com o índice do registro
+    void create(GLuint recordBinding, GLuint drawIdLocation, size_t capacity = 1024);
+    void destroy();
+
+    // Começo do quadro: descarta registros e comandos do anterior
+    void begin();
+
+    // Índice do registro (o baseInstance de quem o usar)
+    GLuint addRecord(const DrawRecord &record);
+
+    // indirect: o VAO é de um GeometryPool e o comando vai para o
+    // glMultiDrawElementsIndirect dele
+    void addCommand(GLuint vao, GLenum indexType, bool indirect, const DrawCommand &command);
+
+    // Envia registros e comandos e desenha tudo; devolve as chamadas de draw feitas
+    size_t submit();
+
+    size_t recordCount() const { return m_records.size(); }
+
+private:
+    // Comandos de um VAO, na ordem em que chegaram
+    struct CommandList
+    {
+        GLuint vao;
+        GLenum indexType;
+        bool indirect;
+        std::vector<DrawCommand> commands;
+        size_t bufferOffset; // em bytes no buffer de comandos (submit)
+    };
+
+    // Atributo de id do VAO vinculado apontando para o id first
+    void attachDrawIds(GLuint first) const;
+    // Faz caber count elementos de elementSize no buffer (glBufferData se crescer)
+    static void reserve(GLenum target, GLuint buffer, size_t &capacity, size_t count, size_t elementSize);
+
+    GLuint m_recordBuffer = 0;
+    GLuint m_commandBuffer = 0;
+    GLuint m_drawIdBuffer = 0;
+    GLuint m_recordBinding = 0;
+    GLuint m_drawIdLocation = 0;
+    size_t m_recordCapacity = 0;
+    size_t m_commandCapacity = 0;
+    size_t m_drawIdCapacity = 0;
+    std::vector<DrawRecord> m_records;
+    std::vector<CommandList> m_lists;
+    size_t m_usedLists = 0; // m_lists guarda os vetores entre quadros
+    size_t m_lastList = 0;  // comandos seguidos costumam ir para a mesma lista
+    std::vector<DrawCommand> m_indirectCommands;
+    std::vector<GLsizei> m_counts;
+    std::vector<const void *> m_offsets;
+    std::vector<GLint> m_baseVertices;
+};
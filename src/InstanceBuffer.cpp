@@ -0,0 +1,47 @@
+#include "InstanceBuffer.h"
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+
+void InstanceBuffer::create(size_t capacity)
+{
+    destroy();
+    m_capacity = std::max<size_t>(capacity, 1);
+    glGenBuffers(1, &m_buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(m_capacity * sizeof(glm::mat4)), nullptr, GL_STREAM_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void InstanceBuffer::destroy()
+{
+    if (m_buffer)
+        glDeleteBuffers(1, &m_buffer);
+    m_buffer = 0;
+    m_capacity = 0;
+}
+
+void InstanceBuffer::upload(const glm::mat4 *models, size_t count)
+{
+    if (!m_buffer || count == 0)
+        return;
+    while (m_capacity < count)
+        m_capacity *= 2;
+    glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(m_capacity * sizeof(glm::mat4)), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)(count * sizeof(glm::mat4)), glm::value_ptr(models[0]));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void InstanceBuffer::attach(GLuint vao, GLuint location, size_t first) const
+{
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+    for (GLuint column = 0; column < 4; ++column)
+    {
+        size_t offset = first * sizeof(glm::mat4) + column * sizeof(glm::vec4);
+        glVertexAttribPointer(location + column, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void *)offset);
+        glVertexAttribDivisor(location + column, 1);
+        glEnableVertexAttribArray(location + column);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+
+// Matrizes model por instância num vertex buffer: um glDraw*Instanced desenha
+// todas as cópias de uma malha, e cada instância lê a sua matriz de um atributo
+// mat4 com divisor 1 (uma coluna por location, de location a location + 3).
+class InstanceBuffer
+{
+public:
+    InstanceBuffer() = default;
+    ~InstanceBuffer() { destroy(); }
+
+    InstanceBuffer(const InstanceBuffer &) = delete;
+    InstanceBuffer &operator=(const InstanceBuffer &) = delete;
+
+    void create(size_t capacity = 64);
+    void destroy();
+
+    // Envia as matrizes do quadro (o buffer é trocado por um novo em vez de
+    // esperar os draws anteriores) e dobra de tamanho se não couberem
+    void upload(const glm::mat4 *models, size_t count);
+
+    // Vincula o VAO e aponta o atributo de instância para o buffer a partir da
+    // matriz first: a instância 0 do próximo draw lê models[first]. O VAO fica
+    // vinculado
+    void attach(GLuint vao, GLuint location, size_t first = 0) const;
+
+    size_t capacity() const { return m_capacity; }
+
+private:
+    GLuint m_buffer = 0;
+    size_t m_capacity = 0; // matrizes alocadas na GPU
+};
@@ -0,0 +1,653 @@
+/* Benchmark de carregamento de assets (sem janela/OpenGL)
+ *
+ * Compara o leitor de .obj antigo (getline + istringstream por linha) com o
+ * parser mapeado em memória de ObjLoader.cpp para todos os modelos de
+ * assets/Modelos3D, confere se os dois produzem os mesmos triângulos e mostra
+ * quanto a deduplicação de vértices economiza. Também mede a abertura do cache
+ * binário (.meshcache) que substitui o parsing a partir da segunda execução.
+ *
+ * Em seguida mostra o ACMR/ATVR (cache de vértices pós-transformação) de cada
+ * malha antes e depois de MeshOptimizer e confere que os triângulos continuam
+ * os mesmos, o tamanho/erro do formato de vértice compacto (VertexFormat), os
+ * níveis de detalhe gerados por MeshSimplifier e quantos triângulos o descarte
+ * por meshlet (Meshlets) elimina vendo a malha de várias direções.
+ *
+ * Por fim gera um .obj sintético (grade lado x lado, 2 triângulos por célula)
+ * e mede a escala do parser paralelo com o número de threads, e uma imagem
+ * RGBA sintética para comparar os mipmaps em gama (como glGenerateMipmap) com
+ * os de MipGenerator em espaço linear: escalar e vetorial (SSE2/NEON) numa
+ * faixa e repartido pelas threads de um AsyncLoader. A comparação com o glGenerateMipmap do driver precisa de
+ * contexto GL e fica no TrabalhoGrauB (--mip-benchmark imagem).
+ *
+ * Uso: ./LoadBenchmark [pasta dos modelos] [repetições] [lado da grade, 0 = pula]
+ *                      [lado da imagem, 0 = pula]
+ */
+
+#include "ObjLoader.h"
+#include "ObjLoader.cpp"
+#include "MeshOptimizer.h"
+#include "MeshOptimizer.cpp"
+#include "MeshSimplifier.h"
+#include "MeshSimplifier.cpp"
+#include "Meshlets.h"
+#include "Meshlets.cpp"
+#include "MeshCache.h"
+#include "MeshCache.cpp"
+#include "VertexFormat.h"
+#include "VertexFormat.cpp"
+#include "MipGenerator.h"
+#include "MipGenerator.cpp"
+#include "TextureCompressor.h"
+#include "TextureCompressor.cpp"
+#include "AsyncLoader.h"
+#include "AsyncLoader.cpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Cópia do laço de leitura usado originalmente em loadGeometry (TrabalhoGrauB/Modulo4/5/6)
+static bool legacyLoadOBJ(const std::string &objPath, std::vector<Vertex> &vertices)
+{
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> normals;
+    std::vector<glm::vec2> texCoords;
+
+    std::ifstream objFile(objPath);
+    if (!objFile.is_open())
+        return false;
+
+    std::string line;
+    while (getline(objFile, line))
+    {
+        std::istringstream iss(line);
+        std::string type;
+        iss >> type;
+
+        if (type == "v")
+        {
+            glm::vec3 pos;
+            iss >> pos.x >> pos.y >> pos.z;
+            positions.push_back(pos);
+        }
+        else if (type == "vt")
+        {
+            glm::vec2 uv;
+            iss >> uv.x >> uv.y;
+            texCoords.push_back(uv);
+        }
+        else if (type == "vn")
+        {
+            glm::vec3 norm;
+            iss >> norm.x >> norm.y >> norm.z;
+            normals.push_back(norm);
+        }
+        else if (type == "f")
+        {
+            for (int i = 0; i < 3; i++)
+            {
+                std::string v;
+                iss >> v;
+                std::replace(v.begin(), v.end(), '/', ' ');
+                std::istringstream viss(v);
+                int vi = 0, ti = 0, ni = 0;
+                viss >> vi >> ti >> ni;
+
+                Vertex vert;
+                vert.position = positions[vi - 1];
+                vert.texCoord = (ti > 0) ? texCoords[ti - 1] : glm::vec2(0.0f);
+                vert.normal = (ni > 0) ? normals[ni - 1] : glm::vec3(0.0f);
+                vertices.push_back(vert);
+            }
+        }
+    }
+    return true;
+}
+
+// Compara a lista de triângulos antiga com a malha indexada expandida
+static bool sameTriangles(const std::vector<Vertex> &soup, const ObjMesh &mesh)
+{
+    if (soup.size() != mesh.indices.size())
+        return false;
+    for (size_t i = 0; i < soup.size(); ++i)
+    {
+        const Vertex &a = soup[i];
+        const Vertex &b = mesh.vertices[mesh.indices[i]];
+        if (a.position != b.position || a.normal != b.normal || a.texCoord != b.texCoord)
+            return false;
+    }
+    return true;
+}
+
+static bool sameMesh(const ObjMesh &a, const ObjMesh &b)
+{
+    if (a.vertices.size() != b.vertices.size() || a.indices != b.indices)
+        return false;
+    for (size_t i = 0; i < a.vertices.size(); ++i)
+    {
+        const Vertex &va = a.vertices[i];
+        const Vertex &vb = b.vertices[i];
+        if (va.position != vb.position || va.normal != vb.normal || va.texCoord != vb.texCoord)
+            return false;
+    }
+    return true;
+}
+
+// Triângulos de cada submesh como índices na malha original (pelos dados do
+// vértice, que são únicos após a deduplicação), rotacionados para começar pelo
+// menor índice sem trocar o sentido, e ordenados
+static std::vector<std::vector<std::array<uint32_t, 3>>> canonicalTriangles(const ObjMesh &mesh, const ObjMesh &reference)
+{
+    std::map<std::string, uint32_t> original;
+    for (size_t i = 0; i < reference.vertices.size(); ++i)
+        original[std::string((const char *)&reference.vertices[i], sizeof(Vertex))] = (uint32_t)i;
+
+    std::vector<std::vector<std::array<uint32_t, 3>>> result;
+    for (const Submesh &sub : mesh.submeshes)
+    {
+        std::vector<std::array<uint32_t, 3>> triangles;
+        for (uint32_t i = sub.firstIndex; i + 2 < sub.firstIndex + sub.indexCount; i += 3)
+        {
+            std::array<uint32_t, 3> tri;
+            for (int k = 0; k < 3; ++k)
+                tri[k] = original[std::string((const char *)&mesh.vertices[mesh.indices[i + k]], sizeof(Vertex))];
+            while (tri[0] > tri[1] || tri[0] > tri[2])
+                tri = {tri[1], tri[2], tri[0]};
+            triangles.push_back(tri);
+        }
+        std::sort(triangles.begin(), triangles.end());
+        result.push_back(triangles);
+    }
+    return result;
+}
+
+// Maiores erros do formato compacto em relação aos floats originais
+struct PackingError
+{
+    float position; // fração da maior dimensão da caixa envolvente
+    float normal;   // graus
+    float texCoord;
+};
+
+static PackingError measurePacking(const ObjMesh &mesh)
+{
+    std::vector<PackedVertex> packed;
+    packVertices(mesh.vertices.data(), mesh.vertices.size(), mesh.boundsMin, mesh.boundsMax, packed);
+    glm::mat4 dequantize = dequantizeMatrix(mesh.boundsMin, mesh.boundsMax);
+    glm::vec3 extent = mesh.boundsMax - mesh.boundsMin;
+    float size = std::max(extent.x, std::max(extent.y, extent.z));
+
+    PackingError error = {0.0f, 0.0f, 0.0f};
+    for (size_t i = 0; i < packed.size(); ++i)
+    {
+        const Vertex &v = mesh.vertices[i];
+        const PackedVertex &p = packed[i];
+        glm::vec4 q(p.position[0] / 65535.0f, p.position[1] / 65535.0f, p.position[2] / 65535.0f, 1.0f);
+        glm::vec3 position = glm::vec3(dequantize * q);
+        if (size > 0.0f)
+            error.position = std::max(error.position, glm::length(position - v.position) / size);
+
+        float length = glm::length(v.normal);
+        if (length > 0.0f)
+        {
+            float cosine = glm::dot(glm::normalize(unpackNormal(p.normal)), v.normal / length);
+            float degrees = std::acos(std::min(1.0f, cosine)) * 180.0f / 3.14159265f;
+            error.normal = std::max(error.normal, degrees);
+        }
+
+        glm::vec2 uv(halfToFloat(p.texCoord[0]), halfToFloat(p.texCoord[1]));
+        error.texCoord = std::max(error.texCoord, std::max(std::fabs(uv.x - v.texCoord.x), std::fabs(uv.y - v.texCoord.y)));
+    }
+    return error;
+}
+
+// Estatísticas dos meshlets do nível 0 e fração de triângulos descartada pelo
+// frustum e pelo cone de normais, com a câmera em 26 direções ao redor da malha
+struct MeshletStats
+{
+    size_t count;
+    float averageTriangles;
+    float averageVertices;
+    float usableCones; // fração com cone < 90 graus
+    float culledByCone;
+    float culledTotal;
+};
+
+static MeshletStats measureMeshlets(const ObjMesh &mesh)
+{
+    MeshletStats stats = {0, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+    const MeshLod &lod = mesh.lods[0];
+    stats.count = lod.meshletCount;
+    if (stats.count == 0)
+        return stats;
+
+    size_t triangles = 0, vertices = 0, cones = 0;
+    for (uint32_t m = lod.firstMeshlet; m < lod.firstMeshlet + lod.meshletCount; ++m)
+    {
+        const Meshlet &meshlet = mesh.meshlets[m];
+        triangles += meshlet.indexCount / 3;
+        std::vector<uint32_t> unique(mesh.indices.begin() + meshlet.firstIndex,
+                                     mesh.indices.begin() + meshlet.firstIndex + meshlet.indexCount);
+        std::sort(unique.begin(), unique.end());
+        vertices += std::unique(unique.begin(), unique.end()) - unique.begin();
+        cones += meshlet.coneCutoff < 1.0f;
+    }
+    stats.averageTriangles = (float)triangles / stats.count;
+    stats.averageVertices = (float)vertices / stats.count;
+    stats.usableCones = (float)cones / stats.count;
+
+    // câmera a 1.5x o tamanho da malha, olhando para o centro
+    glm::vec3 center = (mesh.boundsMin + mesh.boundsMax) * 0.5f;
+    glm::vec3 extent = mesh.boundsMax - mesh.boundsMin;
+    float size = std::max(extent.x, std::max(extent.y, extent.z));
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 1.0f, 0.01f * size, 10.0f * size);
+    size_t views = 0, coneCulled = 0, totalCulled = 0;
+    for (int x = -1; x <= 1; ++x)
+        for (int y = -1; y <= 1; ++y)
+            for (int z = -1; z <= 1; ++z)
+            {
+                if (x == 0 && y == 0 && z == 0)
+                    continue;
+                glm::vec3 direction = glm::normalize(glm::vec3((float)x, (float)y, (float)z));
+                glm::vec3 eye = center + direction * (1.5f * size);
+                glm::vec3 up = y != 0 && x == 0 && z == 0 ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+                glm::mat4 view = glm::lookAt(eye, center, up);
+                MeshletCuller culler = makeMeshletCuller(projection * view, glm::mat4(1.0f), eye);
+                MeshletCuller coneOnly = culler;
+                for (int i = 0; i < 6; ++i)
+                    coneOnly.planes[i] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f); // frustum que aceita tudo
+
+                for (uint32_t m = lod.firstMeshlet; m < lod.firstMeshlet + lod.meshletCount; ++m)
+                {
+                    const Meshlet &meshlet = mesh.meshlets[m];
+                    if (!meshletVisible(meshlet, coneOnly))
+                        coneCulled += meshlet.indexCount / 3;
+                    if (!meshletVisible(meshlet, culler))
+                        totalCulled += meshlet.indexCount / 3;
+                }
+                ++views;
+            }
+    stats.culledByCone = (float)coneCulled / (float)(views * triangles);
+    stats.culledTotal = (float)totalCulled / (float)(views * triangles);
+    return stats;
+}
+
+// Grade side x side no plano XZ com v/vt/vn por vértice
+static bool writeSyntheticOBJ(const std::string &path, int side)
+{
+    FILE *f = fopen(path.c_str(), "wb");
+    if (!f)
+        return false;
+    static char buffer[1 << 20];
+    setvbuf(f, buffer, _IOFBF, sizeof(buffer));
+
+    fprintf(f, "# grade sintetica %dx%d\no grade\n", side, side);
+    for (int z = 0; z < side; ++z)
+        for (int x = 0; x < side; ++x)
+            fprintf(f, "v %.6f %.6f %.6f\n", x * 0.01f, 0.05f * ((x * 7 + z * 13) % 17), z * 0.01f);
+    for (int z = 0; z < side; ++z)
+        for (int x = 0; x < side; ++x)
+            fprintf(f, "vt %.6f %.6f\n", (float)x / (side - 1), (float)z / (side - 1));
+    for (int z = 0; z < side; ++z)
+        for (int x = 0; x < side; ++x)
+            fprintf(f, "vn %.4f %.4f %.4f\n", 0.0f, 1.0f, 0.0f);
+    for (int z = 0; z + 1 < side; ++z)
+    {
+        for (int x = 0; x + 1 < side; ++x)
+        {
+            int a = z * side + x + 1, b = a + 1, c = a + side, d = c + 1;
+            fprintf(f, "f %d/%d/%d %d/%d/%d %d/%d/%d\n", a, a, a, c, c, c, b, b, b);
+            fprintf(f, "f %d/%d/%d %d/%d/%d %d/%d/%d\n", b, b, b, c, c, c, d, d, d);
+        }
+    }
+    return fclose(f) == 0;
+}
+
+// Executa fn 'runs' vezes e devolve o menor tempo em milissegundos
+template <typename Fn>
+static double bestOf(int runs, Fn fn)
+{
+    double best = 1e30;
+    for (int i = 0; i < runs; ++i)
+    {
+        auto start = chrono::steady_clock::now();
+        fn();
+        auto stop = chrono::steady_clock::now();
+        best = std::min(best, chrono::duration<double, milli>(stop - start).count());
+    }
+    return best;
+}
+
+// Escala do parser paralelo em um .obj grande gerado na pasta temporária
+static bool syntheticScaling(int side, int runs)
+{
+    std::string path = (std::filesystem::temp_directory_path() / "graubcg_sintetico.obj").string();
+    if (!writeSyntheticOBJ(path, side))
+    {
+        cerr << "Nao foi possivel gravar " << path << endl;
+        return false;
+    }
+
+    MappedFile file(path);
+    runs = std::min(runs, 3);
+    ObjMesh serial;
+    double serialMs = bestOf(runs, [&]
+                             { parseOBJ(file.data(), file.size(), serial); });
+
+    cout << "\nParser paralelo em grade sintetica " << side << "x" << side << " (" << serial.indices.size() / 3
+         << " triangulos, " << file.size() / (1024 * 1024) << " MB)\n";
+    cout << right << setw(8) << "threads" << setw(12) << "ms" << setw(10) << "MB/s" << setw(10) << "escala" << setw(8) << "ok" << "\n";
+    cout << setw(8) << "serial" << fixed << setprecision(1) << setw(12) << serialMs
+         << setw(10) << file.size() / (1024.0 * 1024.0) / (serialMs / 1000.0) << setw(10) << "-" << setw(8) << "-" << "\n";
+
+    bool allOk = true;
+    // potências de 2 até o número de núcleos, terminando sempre nele
+    std::vector<unsigned> threadCounts;
+    unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned threads = 1; threads < hardware; threads *= 2)
+        threadCounts.push_back(threads);
+    threadCounts.push_back(hardware);
+
+    for (unsigned threads : threadCounts)
+    {
+        ObjMesh parallel;
+        double ms = bestOf(runs, [&]
+                           { parseOBJParallel(file.data(), file.size(), parallel, threads); });
+        bool ok = sameMesh(serial, parallel);
+        allOk = allOk && ok;
+        cout << setw(8) << threads << setw(12) << ms << setw(10) << file.size() / (1024.0 * 1024.0) / (ms / 1000.0)
+             << setw(9) << serialMs / ms << "x" << setw(8) << (ok ? "sim" : "NAO") << "\n";
+    }
+
+    file.close();
+    std::filesystem::remove(path);
+    return allOk;
+}
+
+// Mipmaps de uma imagem side x side (listras finas de alto contraste sobre um
+// gradiente, alfa variando): cadeia em gama contra a linear de MipGenerator,
+// no caminho escalar e no vetorial, que tem de dar os mesmos bytes. "cinza" é o nível 1x1 de um xadrez preto/branco: 188 em espaço linear, 128
+// em gama
+static bool syntheticMipmaps(int side, int runs)
+{
+    std::vector<unsigned char> pixels((size_t)side * side * 4);
+    for (int y = 0; y < side; ++y)
+        for (int x = 0; x < side; ++x)
+        {
+            unsigned char *p = &pixels[((size_t)y * side + x) * 4];
+            bool stripe = ((x ^ y) & 1) != 0;
+            p[0] = stripe ? 255 : 0;
+            p[1] = (unsigned char)(x * 255 / side);
+            p[2] = (unsigned char)(y * 255 / side);
+            p[3] = (unsigned char)((x + y) * 255 / (2 * side));
+        }
+    size_t bytes = pixels.size();
+
+    runs = std::min(runs, 5);
+    std::vector<unsigned char> gamma;
+    double gammaMs = bestOf(runs, [&]
+                            {
+        std::vector<unsigned char> level(pixels), next;
+        int width = side, height = side;
+        while (width > 1 || height > 1)
+        {
+            downsampleRGBA(level.data(), width, height, next);
+            width = std::max(1, width / 2);
+            height = std::max(1, height / 2);
+            level.swap(next);
+        }
+        gamma = level; });
+
+    cout << "\nMipmaps de imagem sintetica " << side << "x" << side << " RGBA (" << bytes / (1024 * 1024) << " MB)\n";
+    cout << left << setw(28) << "filtro" << right << setw(12) << "ms" << setw(10) << "MB/s" << setw(10) << "escala"
+         << setw(8) << "cinza" << setw(8) << "ok" << "\n";
+    cout << left << setw(28) << "gama (referencia)" << right << fixed << setprecision(1) << setw(12) << gammaMs
+         << setw(10) << bytes / (1024.0 * 1024.0) / (gammaMs / 1000.0) << setw(10) << "-" << setw(8) << (int)gamma[0]
+         << setw(8) << "-" << "\n";
+
+    // a referência é a cadeia escalar numa thread; as demais têm de dar os mesmos bytes
+    MipChain scalar;
+    bool allOk = true;
+    auto row = [&](const std::string &name, unsigned threads, bool simd)
+    {
+        setMipSimd(simd);
+        MipChain chain;
+        double ms = bestOf(runs, [&]
+                           { generateMipChain(pixels.data(), side, side, 4, chain, threads); });
+        std::string ok = "-";
+        if (scalar.levels.empty())
+            scalar = chain;
+        else
+        {
+            bool same = chain.data == scalar.data && chain.levels.size() == scalar.levels.size();
+            allOk = allOk && same;
+            ok = same ? "sim" : "NAO";
+        }
+        cout << left << setw(28) << name << right << setprecision(1) << setw(12) << ms
+             << setw(10) << bytes / (1024.0 * 1024.0) / (ms / 1000.0) << setprecision(2) << setw(9) << gammaMs / ms << "x"
+             << setw(8) << (int)chain.data[chain.levels.back().offset] << setw(8) << ok << "\n";
+    };
+
+    unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::string threads = std::to_string(hardware) + " threads";
+    const char *simd = mipSimdName();
+    row("linear escalar, 1 thread", 1, false);
+    if (simd)
+        row(std::string("linear ") + simd + ", 1 thread", 1, true);
+
+    AsyncLoader pool;
+    setMipParallelFor([&pool](unsigned count, const std::function<void(unsigned)> &task)
+                      { pool.parallelFor(count, task); });
+    row("linear escalar, " + threads, hardware, false);
+    if (simd)
+        row(std::string("linear ") + simd + ", " + threads, hardware, true);
+    pool.stop();
+    setMipParallelFor(nullptr);
+    setMipSimd(true);
+    return allOk;
+}
+
+int main(int argc, char **argv)
+{
+    std::string assetPath = argc > 1 ? argv[1] : "../assets/Modelos3D";
+    int runs = argc > 2 ? std::max(1, atoi(argv[2])) : 10;
+    int syntheticSide = argc > 3 ? atoi(argv[3]) : 1000;
+    int imageSide = argc > 4 ? atoi(argv[4]) : 2048;
+
+    const char *models[] = {"Cube.obj", "Suzanne.obj", "SuzanneSubdiv1.obj", "BerievA50.obj", "warehouse.obj"};
+
+    cout << "Parsing de .obj (melhor de " << runs << " execucoes)\n";
+    cout << left << setw(20) << "modelo" << right << setw(10) << "KB" << setw(10) << "cantos" << setw(10) << "unicos"
+         << setw(14) << "antigo (ms)" << setw(14) << "mmap (ms)" << setw(10) << "ganho"
+         << setw(16) << "paralelo (ms)" << setw(9) << "threads" << setw(8) << "ok" << "\n";
+
+    struct MemoryRow
+    {
+        const char *name;
+        size_t soupBytes;
+        size_t indexedBytes;
+        double parseMs;
+        double cacheMs;
+        VertexCacheStats before;
+        VertexCacheStats after;
+        double optimizeMs;
+        bool optimizeOk;
+        size_t vertexCount;
+        PackingError packing;
+        std::vector<MeshLod> lods;
+        double lodMs;
+        MeshletStats meshlets;
+        double meshletMs;
+        bool meshletOk;
+    };
+    std::vector<MemoryRow> memoryRows;
+
+    bool allOk = true;
+    for (const char *name : models)
+    {
+        std::string path = assetPath + "/" + name;
+        MappedFile probe(path);
+        if (!probe.isOpen())
+        {
+            cerr << "Arquivo nao encontrado: " << path << endl;
+            allOk = false;
+            continue;
+        }
+        size_t bytes = probe.size();
+        probe.close();
+
+        std::vector<Vertex> legacy;
+        ObjMesh mesh;
+        double legacyMs = bestOf(runs, [&]
+                                 { legacy.clear(); legacyLoadOBJ(path, legacy); });
+        MappedFile file(path);
+        double fastMs = bestOf(runs, [&]
+                               { parseOBJ(file.data(), file.size(), mesh); });
+        ObjMesh parallelMesh;
+        unsigned threads = objParseThreadCount(file.size());
+        double parallelMs = bestOf(runs, [&]
+                                   { parseOBJParallel(file.data(), file.size(), parallelMesh, threads); });
+        file.close();
+        bool ok = sameTriangles(legacy, mesh) && sameMesh(mesh, parallelMesh);
+        allOk = allOk && ok;
+
+        cout << left << setw(20) << name << right << setw(10) << bytes / 1024 << setw(10) << mesh.indices.size()
+             << setw(10) << mesh.vertices.size()
+             << fixed << setprecision(2) << setw(14) << legacyMs << setw(14) << fastMs
+             << setw(9) << legacyMs / fastMs << "x" << setw(16) << parallelMs << setw(9) << threads
+             << setw(8) << (ok ? "sim" : "NAO") << "\n";
+
+        // Memória na GPU: lista de triângulos vs. vértices únicos + índices
+        size_t soupBytes = legacy.size() * sizeof(Vertex);
+        size_t indexedBytes = mesh.vertices.size() * sizeof(Vertex) +
+                              mesh.indices.size() * (fitsIndex16(mesh) ? sizeof(uint16_t) : sizeof(uint32_t));
+
+        // Cache binário: grava uma vez e mede a abertura (inclui o hash do .obj)
+        double cacheMs = -1.0;
+        if (writeMeshCache(path, mesh))
+        {
+            MeshCacheFile cache;
+            cacheMs = bestOf(runs, [&]
+                             { openMeshCache(path, cache); });
+            ok = ok && cache.view.indexCount == mesh.indices.size();
+            allOk = allOk && ok;
+        }
+
+        // Reordenação para o cache de vértices (sempre sobre uma cópia da malha recém lida)
+        ObjMesh optimized;
+        double optimizeMs = bestOf(runs, [&]
+                                   { optimized = mesh; optimizeMesh(optimized); });
+        VertexCacheStats before = analyzeVertexCache(mesh.indices.data(), mesh.indices.size(), mesh.vertices.size());
+        VertexCacheStats after = analyzeVertexCache(optimized.indices.data(), optimized.indices.size(), optimized.vertices.size());
+        bool optimizeOk = canonicalTriangles(mesh, mesh) == canonicalTriangles(optimized, mesh);
+        allOk = allOk && optimizeOk;
+
+        // Níveis de detalhe sobre a malha já otimizada, como em loadMeshCached
+        ObjMesh withLods;
+        double lodMs = bestOf(runs, [&]
+                              { withLods = optimized; generateLods(withLods); });
+
+        // Meshlets sobre todos os níveis, como em loadMeshCached
+        ObjMesh withMeshlets;
+        double meshletMs = bestOf(runs, [&]
+                                  { withMeshlets = withLods; buildMeshlets(withMeshlets); });
+        bool meshletOk = canonicalTriangles(withLods, mesh) == canonicalTriangles(withMeshlets, mesh);
+        allOk = allOk && meshletOk;
+
+        memoryRows.push_back({name, soupBytes, indexedBytes, fastMs, cacheMs, before, after, optimizeMs, optimizeOk,
+                              mesh.vertices.size(), measurePacking(mesh),
+                              withLods.lods, lodMs, measureMeshlets(withMeshlets), meshletMs, meshletOk});
+    }
+
+    cout << "\nMemoria de geometria na GPU\n";
+    cout << left << setw(20) << "modelo" << right << setw(16) << "triangulos (KB)" << setw(16) << "indexado (KB)" << setw(10) << "reducao" << "\n";
+    for (const MemoryRow &row : memoryRows)
+    {
+        cout << left << setw(20) << row.name << right << setw(16) << row.soupBytes / 1024 << setw(16) << row.indexedBytes / 1024
+             << fixed << setprecision(2) << setw(9) << (double)row.soupBytes / row.indexedBytes << "x\n";
+    }
+
+    cout << "\nCache binario (.meshcache)\n";
+    cout << left << setw(20) << "modelo" << right << setw(14) << "parse (ms)" << setw(14) << "cache (ms)" << setw(10) << "ganho" << "\n";
+    for (const MemoryRow &row : memoryRows)
+    {
+        cout << left << setw(20) << row.name << right << fixed << setprecision(3) << setw(14) << row.parseMs;
+        if (row.cacheMs < 0.0)
+            cout << setw(14) << "-" << setw(10) << "-" << "\n";
+        else
+            cout << setw(14) << row.cacheMs << setprecision(2) << setw(9) << row.parseMs / row.cacheMs << "x\n";
+    }
+
+    cout << "\nCache de vertices (FIFO de " << VERTEX_CACHE_SIZE << " entradas)\n";
+    cout << left << setw(20) << "modelo" << right << setw(12) << "ACMR antes" << setw(12) << "ACMR depois"
+         << setw(12) << "ATVR antes" << setw(12) << "ATVR depois" << setw(14) << "otimizar (ms)" << setw(8) << "ok" << "\n";
+    for (const MemoryRow &row : memoryRows)
+    {
+        cout << left << setw(20) << row.name << right << fixed << setprecision(3)
+             << setw(12) << row.before.acmr << setw(12) << row.after.acmr
+             << setw(12) << row.before.atvr << setw(12) << row.after.atvr
+             << setprecision(2) << setw(14) << row.optimizeMs << setw(8) << (row.optimizeOk ? "sim" : "NAO") << "\n";
+    }
+
+    cout << "\nFormato de vertice compacto (" << sizeof(Vertex) << " -> " << sizeof(PackedVertex) << " bytes)\n";
+    cout << left << setw(20) << "modelo" << right << setw(14) << "float (KB)" << setw(14) << "compacto (KB)"
+         << setw(14) << "erro pos." << setw(14) << "erro normal" << setw(12) << "erro uv" << "\n";
+    for (const MemoryRow &row : memoryRows)
+    {
+        cout << left << setw(20) << row.name << right << setw(14) << row.vertexCount * sizeof(Vertex) / 1024
+             << setw(14) << row.vertexCount * sizeof(PackedVertex) / 1024
+             << scientific << setprecision(2) << setw(14) << row.packing.position
+             << fixed << setw(13) << row.packing.normal << "g"
+             << scientific << setw(12) << row.packing.texCoord << fixed << "\n";
+    }
+
+    cout << "\nNiveis de detalhe (triangulos / erro relativo ao tamanho da malha)\n";
+    cout << left << setw(20) << "modelo" << right;
+    for (unsigned l = 0; l < MESH_LOD_COUNT; ++l)
+        cout << setw(10) << "LOD" + std::to_string(l) << setw(9) << "erro";
+    cout << setw(12) << "gerar (ms)" << "\n";
+    for (const MemoryRow &row : memoryRows)
+    {
+        cout << left << setw(20) << row.name << right;
+        for (unsigned l = 0; l < MESH_LOD_COUNT; ++l)
+        {
+            if (l < row.lods.size())
+                cout << setw(10) << row.lods[l].indexCount / 3 << fixed << setprecision(4) << setw(9) << row.lods[l].error;
+            else
+                cout << setw(10) << "-" << setw(9) << "-";
+        }
+        cout << setprecision(2) << setw(12) << row.lodMs << "\n";
+    }
+
+    cout << "\nMeshlets do LOD0 (ate " << MESHLET_MAX_VERTICES << " vertices / " << MESHLET_MAX_TRIANGLES
+         << " triangulos) e descarte com a camera em 26 direcoes\n";
+    cout << left << setw(20) << "modelo" << right << setw(10) << "meshlets" << setw(12) << "tri/meshlet"
+         << setw(12) << "vert/mesh." << setw(10) << "cones" << setw(12) << "cone (%)" << setw(14) << "+frustum (%)"
+         << setw(12) << "gerar (ms)" << setw(8) << "ok" << "\n";
+    for (const MemoryRow &row : memoryRows)
+    {
+        const MeshletStats &m = row.meshlets;
+        cout << left << setw(20) << row.name << right << setw(10) << m.count << fixed << setprecision(1)
+             << setw(12) << m.averageTriangles << setw(12) << m.averageVertices << setw(9) << 100.0f * m.usableCones << "%"
+             << setw(12) << 100.0f * m.culledByCone << setw(14) << 100.0f * m.culledTotal
+             << setprecision(2) << setw(12) << row.meshletMs << setw(8) << (row.meshletOk ? "sim" : "NAO") << "\n";
+    }
+
+    if (syntheticSide >= 2)
+        allOk = syntheticScaling(syntheticSide, runs) && allOk;
+    if (imageSide >= 2)
+        allOk = syntheticMipmaps(imageSide, runs) && allOk;
+
+    return allOk ? 0 : 1;
+}
@@ -0,0 +1,87 @@
+#include "MaterialBuffer.h"
+#include <algorithm>
+
+void MaterialBuffer::create(GLuint binding, size_t capacity)
+{
+    destroy();
+    m_binding = binding;
+    m_capacity = std::max<size_t>(capacity, 1);
+    glGenBuffers(1, &m_buffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_buffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, (GLsizeiptr)(m_capacity * sizeof(GpuMaterial)), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, m_binding, m_buffer);
+}
+
+void MaterialBuffer::destroy()
+{
+    if (m_buffer)
+        glDeleteBuffers(1, &m_buffer);
+    m_buffer = 0;
+    m_capacity = 0;
+    m_records.clear();
+    m_free.clear();
+    m_dirtyBegin = SIZE_MAX;
+    m_dirtyEnd = 0;
+}
+
+int MaterialBuffer::allocate(const GpuMaterial &material)
+{
+    int index;
+    if (!m_free.empty())
+    {
+        index = m_free.back();
+        m_free.pop_back();
+        m_records[index] = material;
+    }
+    else
+    {
+        index = (int)m_records.size();
+        m_records.push_back(material);
+    }
+    markDirty(index);
+    return index;
+}
+
+void MaterialBuffer::release(int index)
+{
+    if (index >= 0 && index < (int)m_records.size())
+        m_free.push_back(index);
+}
+
+void MaterialBuffer::set(int index, const GpuMaterial &material)
+{
+    if (index < 0 || index >= (int)m_records.size() || m_records[index] == material)
+        return;
+    m_records[index] = material;
+    markDirty(index);
+}
+
+void MaterialBuffer::markDirty(int index)
+{
+    m_dirtyBegin = std::min(m_dirtyBegin, (size_t)index);
+    m_dirtyEnd = std::max(m_dirtyEnd, (size_t)index + 1);
+}
+
+void MaterialBuffer::flush()
+{
+    if (!m_buffer || m_dirtyBegin >= m_dirtyEnd)
+        return;
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_buffer);
+    if (m_records.size() > m_capacity)
+    {
+        // glBufferData no mesmo nome mantém o buffer ligado no binding
+        while (m_capacity < m_records.size())
+            m_capacity *= 2;
+        glBufferData(GL_SHADER_STORAGE_BUFFER, (GLsizeiptr)(m_capacity * sizeof(GpuMaterial)), nullptr, GL_DYNAMIC_DRAW);
+        m_dirtyBegin = 0;
+        m_dirtyEnd = m_records.size();
+    }
+    size_t bytes = (m_dirtyEnd - m_dirtyBegin) * sizeof(GpuMaterial);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, (GLintptr)(m_dirtyBegin * sizeof(GpuMaterial)), (GLsizeiptr)bytes,
+                    m_records.data() + m_dirtyBegin);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    m_uploadedBytes += bytes;
+    m_dirtyBegin = SIZE_MAX;
+    m_dirtyEnd = 0;
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include "GLExt.h"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Todos os materiais carregados num só shader storage buffer (std430): cada
+// draw passa só o índice do material, e os dados de um material vão para a GPU
+// uma vez quando ele é carregado ou muda (textura que terminou de carregar,
+// .mtl recarregado), não a cada draw de cada quadro.
+
+// Um material no buffer; o mesmo layout do struct MaterialData do shader
+struct GpuMaterial
+{
+    glm::vec4 Ka = glm::vec4(1.0f);
+    glm::vec4 Kd = glm::vec4(1.0f);
+    glm::vec4 Ks = glm::vec4(1.0f, 1.0f, 1.0f, 32.0f); // w = Ns
+    int texturePage = -1;                               // -1: sem textura, -2: provisória
+    int textureLayer = 0;
+    int padding[2] = {0, 0};
+
+    bool operator==(const GpuMaterial &other) const
+    {
+        return Ka == other.Ka && Kd == other.Kd && Ks == other.Ks && texturePage == other.texturePage &&
+               textureLayer == other.textureLayer;
+    }
+};
+static_assert(sizeof(GpuMaterial) == 64, "GpuMaterial precisa seguir o layout std430 do shader");
+
+// Só a thread principal usa
+class MaterialBuffer
+{
+public:
+    MaterialBuffer() = default;
+    ~MaterialBuffer() { destroy(); }
+
+    MaterialBuffer(const MaterialBuffer &) = delete;
+    MaterialBuffer &operator=(const MaterialBuffer &) = delete;
+
+    // Cria o buffer e o liga no binding do SSBO
+    void create(GLuint binding, size_t capacity = 256);
+    void destroy();
+
+    // Reserva um índice com esse conteúdo / devolve o índice
+    int allocate(const GpuMaterial &material);
+    void release(int index);
+
+    // Troca o conteúdo (nada acontece se for igual ao atual)
+    void set(int index, const GpuMaterial &material);
+
+    // Uma vez por quadro, antes dos draws: envia os registros alterados (um
+    // glBufferSubData da faixa suja; o buffer dobra de tamanho se encheu)
+    void flush();
+
+    size_t liveCount() const { return m_records.size() - m_free.size(); }
+    size_t uploadedBytes() const { return m_uploadedBytes; }
+
+private:
+    void markDirty(int index);
+
+    GLuint m_buffer = 0;
+    GLuint m_binding = 0;
+    size_t m_capacity = 0; // registros alocados na GPU
+    std::vector<GpuMaterial> m_records;
+    std::vector<int> m_free;
+    size_t m_dirtyBegin = SIZE_MAX, m_dirtyEnd = 0;
+    size_t m_uploadedBytes = 0;
+};
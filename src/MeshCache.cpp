@@ -0,0 +1,263 @@
+#include "MeshCache.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "Meshlets.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+static_assert(sizeof(Vertex) == 32, "layout de Vertex gravado no cache mudou");
+static_assert(sizeof(Submesh) == 36, "layout de Submesh gravado no cache mudou");
+static_assert(sizeof(MeshLod) == 24, "layout de MeshLod gravado no cache mudou");
+static_assert(sizeof(Meshlet) == 40, "layout de Meshlet gravado no cache mudou");
+
+namespace fs = std::filesystem;
+
+static uint64_t alignUp(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+bool cacheSourceKey(const std::string &sourcePath, uint64_t &size, int64_t &mtime, uint64_t &hash)
+{
+    std::error_code ec;
+    fs::file_time_type time = fs::last_write_time(sourcePath, ec);
+    if (ec)
+        return false;
+    MappedFile source(sourcePath);
+    if (!source.isOpen())
+        return false;
+    size = source.size();
+    mtime = (int64_t)time.time_since_epoch().count();
+    hash = hashBytes(source.data(), source.size());
+    return true;
+}
+
+std::string meshCachePath(const std::string &objPath)
+{
+    return objPath + ".meshcache";
+}
+
+// Confere o cabeçalho e se todos os arrays cabem em size antes de apontar a
+// view para eles
+static bool parseMeshCache(const char *data, size_t size, MeshCacheHeader &header, MeshView &view)
+{
+    if (size < sizeof(MeshCacheHeader))
+        return false;
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != MESH_CACHE_MAGIC || header.version != MESH_CACHE_VERSION ||
+        header.vertexStride != sizeof(Vertex) || (header.indexSize != 2 && header.indexSize != 4) ||
+        header.lodCount == 0)
+        return false;
+
+    uint64_t vertexEnd = header.vertexOffset + (uint64_t)header.vertexCount * sizeof(Vertex);
+    uint64_t indexEnd = header.indexOffset + (uint64_t)header.indexCount * header.indexSize;
+    uint64_t submeshEnd = header.submeshOffset + (uint64_t)header.submeshCount * sizeof(Submesh);
+    uint64_t lodEnd = header.lodOffset + (uint64_t)header.lodCount * sizeof(MeshLod);
+    uint64_t meshletEnd = header.meshletOffset + (uint64_t)header.meshletCount * sizeof(Meshlet);
+    uint64_t stringEnd = header.stringOffset + header.stringBytes;
+    if (vertexEnd > size || indexEnd > size || submeshEnd > size || lodEnd > size ||
+        meshletEnd > size || stringEnd > size)
+        return false;
+
+    // mtllib seguido de materialCount nomes
+    std::vector<std::string> strings;
+    const char *cursor = data + header.stringOffset;
+    const char *stringsEnd = data + stringEnd;
+    while (cursor < stringsEnd)
+    {
+        const char *zero = (const char *)memchr(cursor, '\0', stringsEnd - cursor);
+        if (!zero)
+            return false;
+        strings.emplace_back(cursor, zero);
+        cursor = zero + 1;
+    }
+    if (strings.size() != (size_t)header.materialCount + 1)
+        return false;
+    const Submesh *submeshes = (const Submesh *)(data + header.submeshOffset);
+    for (uint32_t s = 0; s < header.submeshCount; ++s)
+        if (submeshes[s].material >= header.materialCount)
+            return false;
+
+    view.vertices = (const Vertex *)(data + header.vertexOffset);
+    view.vertexCount = header.vertexCount;
+    view.indices = data + header.indexOffset;
+    view.indexCount = header.indexCount;
+    view.indexSize = header.indexSize;
+    view.submeshes = submeshes;
+    view.submeshCount = header.submeshCount;
+    view.lods = (const MeshLod *)(data + header.lodOffset);
+    view.lodCount = header.lodCount;
+    view.meshlets = (const Meshlet *)(data + header.meshletOffset);
+    view.meshletCount = header.meshletCount;
+    view.materialLibrary = strings[0];
+    view.materials.assign(strings.begin() + 1, strings.end());
+    view.boundsMin = glm::vec3(header.boundsMin[0], header.boundsMin[1], header.boundsMin[2]);
+    view.boundsMax = glm::vec3(header.boundsMax[0], header.boundsMax[1], header.boundsMax[2]);
+    view.sourceHash = header.sourceHash;
+    return true;
+}
+
+static bool mapValidCache(const std::string &objPath, MeshCacheFile &outCache)
+{
+    MappedFile &file = outCache.file;
+    MeshCacheHeader header;
+    if (!file.open(meshCachePath(objPath)) || !parseMeshCache(file.data(), file.size(), header, outCache.view))
+        return false;
+
+    uint64_t size, hash;
+    int64_t mtime;
+    if (!cacheSourceKey(objPath, size, mtime, hash))
+        return false;
+    return header.sourceSize == size && header.sourceMtime == mtime && header.sourceHash == hash;
+}
+
+bool openMeshCache(const std::string &objPath, MeshCacheFile &outCache)
+{
+    if (mapValidCache(objPath, outCache))
+        return true;
+    outCache.file.close();
+    outCache.view = MeshView();
+    return false;
+}
+
+bool readMeshCache(const char *data, size_t size, MeshView &outView)
+{
+    MeshCacheHeader header;
+    if (parseMeshCache(data, size, header, outView))
+        return true;
+    outView = MeshView();
+    return false;
+}
+
+bool writeMeshCache(const std::string &objPath, const ObjMesh &mesh, uint64_t *sourceHash)
+{
+    MeshCacheHeader header = {};
+    header.magic = MESH_CACHE_MAGIC;
+    header.version = MESH_CACHE_VERSION;
+    if (!cacheSourceKey(objPath, header.sourceSize, header.sourceMtime, header.sourceHash))
+        return false;
+    if (sourceHash)
+        *sourceHash = header.sourceHash;
+
+    std::vector<uint16_t> indices16;
+    MeshView view = makeMeshView(mesh, indices16);
+
+    header.vertexCount = view.vertexCount;
+    header.vertexStride = sizeof(Vertex);
+    header.indexCount = view.indexCount;
+    header.indexSize = view.indexSize;
+    header.submeshCount = view.submeshCount;
+    header.lodCount = view.lodCount;
+    header.meshletCount = view.meshletCount;
+    header.materialCount = (uint32_t)view.materials.size();
+    for (int i = 0; i < 3; ++i)
+    {
+        header.boundsMin[i] = view.boundsMin[i];
+        header.boundsMax[i] = view.boundsMax[i];
+    }
+    header.vertexOffset = alignUp(sizeof(header), 16);
+    header.indexOffset = alignUp(header.vertexOffset + (uint64_t)view.vertexCount * sizeof(Vertex), 16);
+    header.submeshOffset = alignUp(header.indexOffset + (uint64_t)view.indexCount * view.indexSize, 16);
+    header.lodOffset = alignUp(header.submeshOffset + (uint64_t)view.submeshCount * sizeof(Submesh), 16);
+    header.meshletOffset = alignUp(header.lodOffset + (uint64_t)view.lodCount * sizeof(MeshLod), 16);
+    header.stringOffset = alignUp(header.meshletOffset + (uint64_t)view.meshletCount * sizeof(Meshlet), 16);
+
+    std::string strings = view.materialLibrary + '\0';
+    for (const std::string &name : view.materials)
+        strings += name + '\0';
+    header.stringBytes = strings.size();
+
+    std::string path = meshCachePath(objPath);
+    // temporário por thread: o mesmo .obj pode estar sendo carregado em paralelo
+    std::ostringstream tmpName;
+    tmpName << path << ".tmp" << std::this_thread::get_id();
+    std::string tmpPath = tmpName.str();
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out)
+            return false;
+
+        const char zeros[16] = {};
+        auto writeAt = [&](uint64_t offset, const void *data, size_t bytes)
+        {
+            uint64_t pos = (uint64_t)out.tellp();
+            out.write(zeros, (std::streamsize)(offset - pos));
+            out.write((const char *)data, (std::streamsize)bytes);
+        };
+        out.write((const char *)&header, sizeof(header));
+        writeAt(header.vertexOffset, view.vertices, (size_t)view.vertexCount * sizeof(Vertex));
+        writeAt(header.indexOffset, view.indices, (size_t)view.indexCount * view.indexSize);
+        writeAt(header.submeshOffset, view.submeshes, (size_t)view.submeshCount * sizeof(Submesh));
+        writeAt(header.lodOffset, view.lods, (size_t)view.lodCount * sizeof(MeshLod));
+        writeAt(header.meshletOffset, view.meshlets, (size_t)view.meshletCount * sizeof(Meshlet));
+        writeAt(header.stringOffset, strings.data(), strings.size());
+        if (!out)
+            return false;
+    }
+
+    std::error_code ec;
+    fs::rename(tmpPath, path, ec);
+    if (ec)
+    {
+        fs::remove(tmpPath, ec);
+        return false;
+    }
+    return true;
+}
+
+MeshView makeMeshView(const ObjMesh &mesh, std::vector<uint16_t> &indices16)
+{
+    MeshView view;
+    view.vertices = mesh.vertices.data();
+    view.vertexCount = (uint32_t)mesh.vertices.size();
+    view.indexCount = (uint32_t)mesh.indices.size();
+    if (fitsIndex16(mesh))
+    {
+        indices16.assign(mesh.indices.begin(), mesh.indices.end());
+        view.indices = indices16.data();
+        view.indexSize = 2;
+    }
+    else
+    {
+        view.indices = mesh.indices.data();
+        view.indexSize = 4;
+    }
+    view.submeshes = mesh.submeshes.data();
+    view.submeshCount = (uint32_t)mesh.submeshes.size();
+    view.lods = mesh.lods.data();
+    view.lodCount = (uint32_t)mesh.lods.size();
+    view.meshlets = mesh.meshlets.data();
+    view.meshletCount = (uint32_t)mesh.meshlets.size();
+    view.materials = mesh.materials;
+    view.materialLibrary = mesh.materialLibrary;
+    view.boundsMin = mesh.boundsMin;
+    view.boundsMax = mesh.boundsMax;
+    return view;
+}
+
+bool loadMeshCached(const std::string &objPath, MeshCacheFile &cache, ObjMesh &mesh,
+                    std::vector<uint16_t> &indices16, MeshView &outView)
+{
+    if (openMeshCache(objPath, cache))
+    {
+        outView = cache.view;
+        return true;
+    }
+
+    if (!loadOBJ(objPath, mesh))
+        return false;
+    optimizeMesh(mesh);
+    generateLods(mesh);
+    buildMeshlets(mesh);
+    uint64_t sourceHash = 0;
+    if (!writeMeshCache(objPath, mesh, &sourceHash))
+        std::cerr << "Aviso: nao foi possivel gravar " << meshCachePath(objPath) << std::endl;
+
+    outView = makeMeshView(mesh, indices16);
+    outView.sourceHash = sourceHash;
+    return true;
+}
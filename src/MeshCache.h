@@ -0,0 +1,100 @@
+#pragma once
+#include "ObjLoader.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Cache binário de malhas: "<arquivo>.obj.meshcache" ao lado do .obj.
+// Guarda os arrays finais (vértices, índices já em 16/32 bits, submeshes, níveis
+// de detalhe, meshlets, nomes dos materiais e caixa envolvente) alinhados, para que o arquivo mapeado vá direto para o
+// glBufferData. Só é aceito se tamanho, data de modificação e hash do .obj
+// baterem com os gravados no cabeçalho.
+
+// Incrementar sempre que o layout ou o processamento da malha mudar
+const uint32_t MESH_CACHE_VERSION = 5; // 2: MeshOptimizer, 3: níveis de detalhe, 4: meshlets, 5: materiais
+const uint32_t MESH_CACHE_MAGIC = 0x4843424D; // "MBCH"
+
+struct MeshCacheHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t sourceSize;
+    int64_t sourceMtime;
+    uint64_t sourceHash;
+
+    uint32_t vertexCount;
+    uint32_t vertexStride;
+    uint32_t indexCount;
+    uint32_t indexSize; // 2 ou 4 bytes
+    uint32_t submeshCount;
+    uint32_t lodCount;
+    uint32_t meshletCount;
+    uint32_t materialCount;
+    float boundsMin[3];
+    float boundsMax[3];
+
+    // deslocamentos a partir do início do arquivo (múltiplos de 16)
+    uint64_t vertexOffset;
+    uint64_t indexOffset;
+    uint64_t submeshOffset;
+    uint64_t lodOffset;
+    uint64_t meshletOffset;
+    uint64_t stringOffset; // mtllib e os nomes dos materiais, terminados em '\0'
+    uint64_t stringBytes;
+};
+
+// Geometria pronta para upload, apontando para o cache mapeado ou para um ObjMesh
+struct MeshView
+{
+    const Vertex *vertices = nullptr;
+    uint32_t vertexCount = 0;
+    const void *indices = nullptr;
+    uint32_t indexCount = 0;
+    uint32_t indexSize = 4;
+    const Submesh *submeshes = nullptr;
+    uint32_t submeshCount = 0;
+    const MeshLod *lods = nullptr;
+    uint32_t lodCount = 0;
+    const Meshlet *meshlets = nullptr;
+    uint32_t meshletCount = 0;
+    std::vector<std::string> materials; // Submesh::material indexa esta lista
+    std::string materialLibrary;
+    glm::vec3 boundsMin = glm::vec3(0.0f);
+    glm::vec3 boundsMax = glm::vec3(0.0f);
+    uint64_t sourceHash = 0; // hash do .obj de origem (0 se desconhecido)
+};
+
+// Cache aberto: o mapeamento precisa viver enquanto a view for usada
+struct MeshCacheFile
+{
+    MappedFile file;
+    std::vector<char> unpacked; // entrada comprimida de um AssetPack
+    bool fromPack = false;
+    MeshView view;
+};
+
+std::string meshCachePath(const std::string &objPath);
+
+// Tamanho, data de modificação e hash do arquivo fonte gravados nos cabeçalhos
+// dos caches; falha se o arquivo não existir
+bool cacheSourceKey(const std::string &sourcePath, uint64_t &size, int64_t &mtime, uint64_t &hash);
+
+// Abre o cache do .obj se existir e ainda corresponder ao arquivo fonte
+bool openMeshCache(const std::string &objPath, MeshCacheFile &outCache);
+
+// Monta a view sobre um cache já em memória (entrada de AssetPack), sem
+// conferir o arquivo fonte; data precisa viver enquanto a view for usada
+bool readMeshCache(const char *data, size_t size, MeshView &outView);
+
+// Grava o cache (arquivo temporário + rename, nunca deixa um cache pela metade);
+// sourceHash, se dado, recebe o hash do .obj calculado para o cabeçalho
+bool writeMeshCache(const std::string &objPath, const ObjMesh &mesh, uint64_t *sourceHash = nullptr);
+
+// Monta uma view sobre o ObjMesh; índices de 16 bits são gerados em indices16
+MeshView makeMeshView(const ObjMesh &mesh, std::vector<uint16_t> &indices16);
+
+// Caminho completo usado por loadGeometry: tenta o cache, senão faz o parsing
+// do .obj, otimiza a malha, gera os níveis de detalhe e os meshlets e grava o
+// cache para a próxima execução
+bool loadMeshCached(const std::string &objPath, MeshCacheFile &cache, ObjMesh &mesh,
+                    std::vector<uint16_t> &indices16, MeshView &outView);
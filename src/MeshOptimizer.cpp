@@ -0,0 +1,348 @@
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// Cache FIFO simulado: o vértice v está no cache se foi inserido há menos de
+// cacheSize inserções (timestamp cresce a cada miss)
+
+struct FifoCache
+{
+    std::vector<uint32_t> insertedAt;
+    uint32_t time;
+    unsigned size;
+
+    FifoCache(size_t vertexCount, unsigned cacheSize)
+        : insertedAt(vertexCount, 0), time(cacheSize + 1), size(cacheSize) {}
+
+    // devolve 1 se foi miss (e insere o vértice), 0 se já estava no cache
+    unsigned access(uint32_t v)
+    {
+        if (time - insertedAt[v] > size)
+        {
+            insertedAt[v] = time++;
+            return 1;
+        }
+        return 0;
+    }
+
+    // esvazia o cache sem percorrer o array
+    void reset() { time += size + 1; }
+};
+
+VertexCacheStats analyzeVertexCache(const uint32_t *indices, size_t indexCount, size_t vertexCount, unsigned cacheSize)
+{
+    VertexCacheStats stats = {0.0f, 0.0f};
+    if (indexCount < 3)
+        return stats;
+
+    FifoCache cache(vertexCount, cacheSize);
+    std::vector<bool> used(vertexCount, false);
+    size_t misses = 0, usedCount = 0;
+    for (size_t i = 0; i < indexCount; ++i)
+    {
+        misses += cache.access(indices[i]);
+        if (!used[indices[i]])
+        {
+            used[indices[i]] = true;
+            ++usedCount;
+        }
+    }
+    stats.acmr = (float)misses / (float)(indexCount / 3);
+    stats.atvr = (float)misses / (float)usedCount;
+    return stats;
+}
+
+// ---------------------------------------------------------------------------
+// Tom Forsyth, "Linear-Speed Vertex Cache Optimisation" (2006)
+
+const int FORSYTH_CACHE_SIZE = 32;
+const int FORSYTH_MAX_VALENCE = 32; // acima disso o bônus por valência já é desprezível
+
+struct ForsythScoreTable
+{
+    float cache[FORSYTH_CACHE_SIZE];
+    float valence[FORSYTH_MAX_VALENCE + 1];
+
+    ForsythScoreTable()
+    {
+        const float cacheDecayPower = 1.5f;
+        const float lastTriScore = 0.75f;
+        const float valenceBoostScale = 2.0f;
+        const float valenceBoostPower = 0.5f;
+
+        // os 3 vértices do último triângulo recebem nota fixa para não favorecer strips
+        for (int i = 0; i < FORSYTH_CACHE_SIZE; ++i)
+        {
+            if (i < 3)
+                cache[i] = lastTriScore;
+            else
+                cache[i] = powf(1.0f - (float)(i - 3) / (FORSYTH_CACHE_SIZE - 3), cacheDecayPower);
+        }
+        // vértices com poucos triângulos restantes são priorizados para não ficarem órfãos
+        valence[0] = 0.0f;
+        for (int i = 1; i <= FORSYTH_MAX_VALENCE; ++i)
+            valence[i] = valenceBoostScale * powf((float)i, -valenceBoostPower);
+    }
+
+    float score(int cachePosition, uint32_t remaining) const
+    {
+        if (remaining == 0)
+            return -1.0f;
+        float s = cachePosition >= 0 ? cache[cachePosition] : 0.0f;
+        return s + valence[std::min<uint32_t>(remaining, FORSYTH_MAX_VALENCE)];
+    }
+};
+
+void optimizeVertexCache(uint32_t *indices, size_t indexCount, size_t vertexCount)
+{
+    static const ForsythScoreTable table;
+    size_t triCount = indexCount / 3;
+    if (triCount < 2)
+        return;
+
+    // adjacência vértice -> triângulos; remaining[v] = triângulos ainda não emitidos
+    std::vector<uint32_t> remaining(vertexCount, 0);
+    for (size_t i = 0; i < triCount * 3; ++i)
+        remaining[indices[i]]++;
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; ++v)
+        offsets[v + 1] = offsets[v] + remaining[v];
+    std::vector<uint32_t> adjacency(triCount * 3);
+    {
+        std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t t = 0; t < triCount; ++t)
+            for (int k = 0; k < 3; ++k)
+                adjacency[fill[indices[t * 3 + k]]++] = (uint32_t)t;
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v)
+        vertexScore[v] = table.score(-1, remaining[v]);
+
+    std::vector<float> triScore(triCount);
+    std::vector<bool> emitted(triCount, false);
+    for (size_t t = 0; t < triCount; ++t)
+        triScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+
+    std::vector<uint32_t> output;
+    output.reserve(triCount * 3);
+
+    uint32_t cache[FORSYTH_CACHE_SIZE + 3];
+    int cacheCount = 0;
+    size_t scanCursor = 0; // próximo candidato quando o cache não oferece nenhum triângulo
+
+    int best = (int)(std::max_element(triScore.begin(), triScore.end()) - triScore.begin());
+    while (best >= 0)
+    {
+        const uint32_t *tri = indices + best * 3;
+        emitted[best] = true;
+        output.insert(output.end(), tri, tri + 3);
+
+        // remove o triângulo da lista ativa dos seus vértices
+        for (int k = 0; k < 3; ++k)
+        {
+            uint32_t v = tri[k];
+            uint32_t *begin = &adjacency[offsets[v]];
+            uint32_t *end = begin + remaining[v];
+            uint32_t *it = std::find(begin, end, (uint32_t)best);
+            std::swap(*it, *(end - 1));
+            remaining[v]--;
+        }
+
+        // novo cache: vértices do triângulo na frente, depois o cache antigo sem eles
+        uint32_t newCache[FORSYTH_CACHE_SIZE + 3];
+        int newCount = 0;
+        for (int k = 0; k < 3; ++k)
+            newCache[newCount++] = tri[k];
+        for (int i = 0; i < cacheCount; ++i)
+        {
+            uint32_t v = cache[i];
+            if (v != tri[0] && v != tri[1] && v != tri[2])
+                newCache[newCount++] = v;
+        }
+
+        // atualiza notas dos vértices (os que saíram do cache ficam com posição -1)
+        for (int i = 0; i < newCount; ++i)
+        {
+            uint32_t v = newCache[i];
+            int pos = i < FORSYTH_CACHE_SIZE ? i : -1;
+            cachePosition[v] = pos;
+            vertexScore[v] = table.score(pos, remaining[v]);
+        }
+
+        // reavalia os triângulos que tocam o cache e escolhe o melhor
+        best = -1;
+        float bestScore = -1.0f;
+        for (int i = 0; i < newCount; ++i)
+        {
+            uint32_t v = newCache[i];
+            for (uint32_t a = 0; a < remaining[v]; ++a)
+            {
+                uint32_t t = adjacency[offsets[v] + a];
+                float score = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+                triScore[t] = score;
+                if (score > bestScore)
+                {
+                    bestScore = score;
+                    best = (int)t;
+                }
+            }
+        }
+
+        cacheCount = std::min(newCount, FORSYTH_CACHE_SIZE);
+        std::copy(newCache, newCache + cacheCount, cache);
+
+        // beco sem saída: recomeça pelo próximo triângulo ainda não emitido
+        if (best < 0)
+        {
+            while (scanCursor < triCount && emitted[scanCursor])
+                ++scanCursor;
+            if (scanCursor < triCount)
+                best = (int)scanCursor;
+        }
+    }
+
+    std::copy(output.begin(), output.end(), indices);
+}
+
+// ---------------------------------------------------------------------------
+// Sander, Nehab, Barczak, "Fast Triangle Reordering for Vertex Locality and
+// Reduced Overdraw" (2007): divide a ordem do cache em clusters e desenha
+// primeiro os que apontam para fora da malha
+
+struct TriangleCluster
+{
+    size_t begin, end; // em triângulos
+    float sortKey;
+};
+
+void optimizeOverdraw(uint32_t *indices, size_t indexCount, const Vertex *vertices, size_t vertexCount, float threshold)
+{
+    size_t triCount = indexCount / 3;
+    if (triCount < 2)
+        return;
+
+    FifoCache cache(vertexCount, VERTEX_CACHE_SIZE);
+    auto triangleMisses = [&](size_t t)
+    {
+        return cache.access(indices[t * 3]) + cache.access(indices[t * 3 + 1]) + cache.access(indices[t * 3 + 2]);
+    };
+
+    // fronteiras rígidas: triângulos em que o cache "recomeça" (3 misses)
+    std::vector<size_t> hard;
+    for (size_t t = 0; t < triCount; ++t)
+    {
+        if (triangleMisses(t) == 3 || t == 0)
+            hard.push_back(t);
+    }
+    hard.push_back(triCount);
+
+    // fronteiras suaves: dentro de cada cluster rígido, corta sempre que o ACMR
+    // acumulado já estiver dentro de threshold vezes o ACMR do cluster inteiro
+    std::vector<TriangleCluster> clusters;
+    for (size_t h = 0; h + 1 < hard.size(); ++h)
+    {
+        size_t start = hard[h], end = hard[h + 1];
+
+        cache.reset();
+        unsigned clusterMisses = 0;
+        for (size_t t = start; t < end; ++t)
+            clusterMisses += triangleMisses(t);
+        float limit = threshold * (float)clusterMisses / (float)(end - start);
+
+        cache.reset();
+        size_t clusterStart = start;
+        unsigned misses = 0;
+        for (size_t t = start; t < end; ++t)
+        {
+            misses += triangleMisses(t);
+            if (t + 1 == end || (float)misses / (float)(t + 1 - clusterStart) <= limit)
+            {
+                clusters.push_back({clusterStart, t + 1, 0.0f});
+                clusterStart = t + 1;
+                misses = 0;
+                cache.reset();
+            }
+        }
+    }
+
+    // centroide da malha (média ponderada pela área dos triângulos)
+    glm::vec3 meshCentroid(0.0f);
+    float meshArea = 0.0f;
+    for (size_t t = 0; t < triCount; ++t)
+    {
+        const glm::vec3 &a = vertices[indices[t * 3]].position;
+        const glm::vec3 &b = vertices[indices[t * 3 + 1]].position;
+        const glm::vec3 &c = vertices[indices[t * 3 + 2]].position;
+        float area = glm::length(glm::cross(b - a, c - a));
+        meshCentroid += (a + b + c) * (area / 3.0f);
+        meshArea += area;
+    }
+    if (meshArea > 0.0f)
+        meshCentroid /= meshArea;
+
+    // chave: quanto o cluster está "de frente para fora" em relação ao centro
+    for (TriangleCluster &cluster : clusters)
+    {
+        glm::vec3 centroid(0.0f), normal(0.0f);
+        float area = 0.0f;
+        for (size_t t = cluster.begin; t < cluster.end; ++t)
+        {
+            const glm::vec3 &a = vertices[indices[t * 3]].position;
+            const glm::vec3 &b = vertices[indices[t * 3 + 1]].position;
+            const glm::vec3 &c = vertices[indices[t * 3 + 2]].position;
+            glm::vec3 n = glm::cross(b - a, c - a);
+            float triArea = glm::length(n);
+            centroid += (a + b + c) * (triArea / 3.0f);
+            normal += n;
+            area += triArea;
+        }
+        float normalLength = glm::length(normal);
+        if (area > 0.0f && normalLength > 0.0f)
+            cluster.sortKey = glm::dot(centroid / area - meshCentroid, normal / normalLength);
+    }
+
+    std::stable_sort(clusters.begin(), clusters.end(), [](const TriangleCluster &a, const TriangleCluster &b)
+                     { return a.sortKey > b.sortKey; });
+
+    std::vector<uint32_t> output;
+    output.reserve(triCount * 3);
+    for (const TriangleCluster &cluster : clusters)
+        output.insert(output.end(), indices + cluster.begin * 3, indices + cluster.end * 3);
+    std::copy(output.begin(), output.end(), indices);
+}
+
+// ---------------------------------------------------------------------------
+
+void optimizeVertexFetch(ObjMesh &mesh)
+{
+    const uint32_t unused = 0xFFFFFFFFu;
+    std::vector<uint32_t> remap(mesh.vertices.size(), unused);
+    std::vector<Vertex> vertices;
+    vertices.reserve(mesh.vertices.size());
+
+    for (uint32_t &index : mesh.indices)
+    {
+        if (remap[index] == unused)
+        {
+            remap[index] = (uint32_t)vertices.size();
+            vertices.push_back(mesh.vertices[index]);
+        }
+        index = remap[index];
+    }
+    mesh.vertices.swap(vertices);
+}
+
+void optimizeMesh(ObjMesh &mesh)
+{
+    for (const Submesh &sub : mesh.submeshes)
+    {
+        uint32_t *indices = mesh.indices.data() + sub.firstIndex;
+        optimizeVertexCache(indices, sub.indexCount, mesh.vertices.size());
+        optimizeOverdraw(indices, sub.indexCount, mesh.vertices.data(), mesh.vertices.size());
+    }
+    optimizeVertexFetch(mesh);
+}
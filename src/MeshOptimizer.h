@@ -0,0 +1,37 @@
+#pragma once
+#include "ObjLoader.h"
+#include <cstddef>
+#include <cstdint>
+
+// Reordenação de malhas indexadas para a GPU, aplicada depois do parsing e
+// antes de gravar o .meshcache:
+//  1. ordem dos triângulos para o cache pós-transformação (algoritmo de Forsyth)
+//  2. agrupamento dos triângulos em clusters ordenados de fora para dentro,
+//     para o early-Z descartar mais fragmentos (Sander et al., "Tipsify")
+//  3. ordem dos vértices pela primeira vez em que são usados (localidade de fetch)
+
+// Tamanho do cache FIFO simulado nas métricas (ordem de grandeza das GPUs atuais)
+const unsigned VERTEX_CACHE_SIZE = 16;
+
+struct VertexCacheStats
+{
+    float acmr; // cache misses por triângulo (ideal ~0.5, pior caso 3.0)
+    float atvr; // cache misses por vértice usado (ideal 1.0)
+};
+
+VertexCacheStats analyzeVertexCache(const uint32_t *indices, size_t indexCount, size_t vertexCount,
+                                    unsigned cacheSize = VERTEX_CACHE_SIZE);
+
+// Reordena os triângulos de indices (in-place) para reuso do cache de vértices
+void optimizeVertexCache(uint32_t *indices, size_t indexCount, size_t vertexCount);
+
+// Reordena clusters de triângulos (já otimizados para cache) para reduzir overdraw;
+// threshold é quanto o ACMR pode piorar (1.05 = 5%) em troca de clusters menores
+void optimizeOverdraw(uint32_t *indices, size_t indexCount, const Vertex *vertices, size_t vertexCount,
+                      float threshold = 1.05f);
+
+// Renumera os vértices na ordem de primeiro uso e descarta os que não são referenciados
+void optimizeVertexFetch(ObjMesh &mesh);
+
+// Aplica as três etapas em cada submesh, preservando as faixas de índices
+void optimizeMesh(ObjMesh &mesh);
@@ -0,0 +1,500 @@
+#include "MeshSimplifier.h"
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+
+// Quádrica simétrica 4x4 (só o triângulo superior) acumulada com peso;
+// evaluate devolve a distância quadrática média aos planos
+struct Quadric
+{
+    double a00, a01, a02, a03, a11, a12, a13, a22, a23, a33;
+    double weight;
+};
+
+static void addPlane(Quadric &q, const glm::vec3 &n, float d, double weight)
+{
+    q.a00 += weight * n.x * n.x;
+    q.a01 += weight * n.x * n.y;
+    q.a02 += weight * n.x * n.z;
+    q.a03 += weight * n.x * d;
+    q.a11 += weight * n.y * n.y;
+    q.a12 += weight * n.y * n.z;
+    q.a13 += weight * n.y * d;
+    q.a22 += weight * n.z * n.z;
+    q.a23 += weight * n.z * d;
+    q.a33 += weight * d * d;
+    q.weight += weight;
+}
+
+static void addQuadric(Quadric &q, const Quadric &other)
+{
+    q.a00 += other.a00;
+    q.a01 += other.a01;
+    q.a02 += other.a02;
+    q.a03 += other.a03;
+    q.a11 += other.a11;
+    q.a12 += other.a12;
+    q.a13 += other.a13;
+    q.a22 += other.a22;
+    q.a23 += other.a23;
+    q.a33 += other.a33;
+    q.weight += other.weight;
+}
+
+static double evaluate(const Quadric &q, const glm::vec3 &p)
+{
+    double x = p.x, y = p.y, z = p.z;
+    double e = q.a00 * x * x + 2 * q.a01 * x * y + 2 * q.a02 * x * z + 2 * q.a03 * x +
+               q.a11 * y * y + 2 * q.a12 * y * z + 2 * q.a13 * y +
+               q.a22 * z * z + 2 * q.a23 * z + q.a33;
+    return q.weight > 0.0 ? std::fabs(e) / q.weight : 0.0;
+}
+
+struct Collapse
+{
+    uint32_t from, to;
+    float cost;
+};
+
+// Como cada posição pode se mover: livre, só ao longo da borda aberta, só ao
+// longo da costura (as duas cópias do vértice juntas) ou nunca
+enum VertexKind
+{
+    KIND_MANIFOLD,
+    KIND_BORDER,
+    KIND_SEAM,
+    KIND_LOCKED,
+};
+
+static uint64_t edgeKey(uint32_t a, uint32_t b)
+{
+    if (a > b)
+        std::swap(a, b);
+    return ((uint64_t)a << 32) | b;
+}
+
+// Topologia por posição: vértices com a mesma posição (costuras de UV/normal)
+// formam uma classe representada pelo primeiro deles
+struct SimplifyTopology
+{
+    std::vector<uint32_t> positionClass; // vértice -> representante
+    std::vector<uint32_t> wedgeNext;     // lista circular dos vértices da mesma classe
+    std::vector<uint8_t> kind;           // por representante
+    std::vector<uint8_t> borderEdge;     // aresta de posição é borda ou costura (por triângulo/lado)
+};
+
+static void buildTopology(const std::vector<uint32_t> &indices, const Vertex *vertices, size_t vertexCount,
+                          SimplifyTopology &topo)
+{
+    std::vector<bool> referenced(vertexCount, false);
+    for (uint32_t index : indices)
+        referenced[index] = true;
+
+    std::unordered_map<glm::vec3, uint32_t, PositionHash, PositionEqual> first;
+    first.reserve(vertexCount);
+    topo.positionClass.resize(vertexCount);
+    topo.wedgeNext.resize(vertexCount);
+    std::vector<uint32_t> wedgeCount(vertexCount, 0);
+    for (size_t v = 0; v < vertexCount; ++v)
+    {
+        topo.positionClass[v] = (uint32_t)v;
+        topo.wedgeNext[v] = (uint32_t)v;
+        if (!referenced[v])
+            continue;
+        auto it = first.emplace(vertices[v].position, (uint32_t)v).first;
+        uint32_t rep = it->second;
+        topo.positionClass[v] = rep;
+        if (rep != v)
+        {
+            topo.wedgeNext[v] = topo.wedgeNext[rep];
+            topo.wedgeNext[rep] = (uint32_t)v;
+        }
+        wedgeCount[rep]++;
+    }
+
+    // uso de cada aresta entre posições e entre vértices
+    struct PositionEdge
+    {
+        uint32_t count;
+        uint64_t vertexEdge;
+    };
+    std::unordered_map<uint64_t, PositionEdge> positionEdges;
+    std::unordered_map<uint64_t, uint32_t> vertexEdges;
+    positionEdges.reserve(indices.size());
+    vertexEdges.reserve(indices.size());
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+            uint32_t a = indices[i + k], b = indices[i + (k + 1) % 3];
+            PositionEdge &edge = positionEdges[edgeKey(topo.positionClass[a], topo.positionClass[b])];
+            edge.count++;
+            edge.vertexEdge = edgeKey(a, b);
+            vertexEdges[edgeKey(a, b)]++;
+        }
+    }
+
+    std::vector<uint32_t> borders(vertexCount, 0), seams(vertexCount, 0);
+    std::vector<bool> complex(vertexCount, false);
+    for (const auto &entry : positionEdges)
+    {
+        uint32_t a = (uint32_t)(entry.first >> 32), b = (uint32_t)entry.first;
+        const PositionEdge &edge = entry.second;
+        if (edge.count == 1)
+        {
+            borders[a]++;
+            borders[b]++;
+        }
+        else if (edge.count == 2 && vertexEdges[edge.vertexEdge] == 1)
+        {
+            seams[a]++;
+            seams[b]++;
+        }
+        else if (edge.count > 2)
+            complex[a] = complex[b] = true;
+    }
+
+    topo.kind.assign(vertexCount, KIND_LOCKED);
+    for (size_t v = 0; v < vertexCount; ++v)
+    {
+        if (topo.positionClass[v] != v || !referenced[v] || complex[v])
+            continue;
+        if (wedgeCount[v] == 1 && borders[v] == 0)
+            topo.kind[v] = KIND_MANIFOLD;
+        else if (wedgeCount[v] == 1 && borders[v] == 2)
+            topo.kind[v] = KIND_BORDER;
+        else if (wedgeCount[v] == 2 && borders[v] == 0 && seams[v] == 2)
+            topo.kind[v] = KIND_SEAM;
+    }
+
+    // lados de triângulo que ficam em borda ou costura (recebem planos extras nas quádricas)
+    topo.borderEdge.assign(indices.size(), 0);
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+            uint32_t a = indices[i + k], b = indices[i + (k + 1) % 3];
+            const PositionEdge &edge = positionEdges[edgeKey(topo.positionClass[a], topo.positionClass[b])];
+            topo.borderEdge[i + k] = edge.count == 1 || (edge.count == 2 && vertexEdges[edgeKey(a, b)] == 1);
+        }
+    }
+}
+
+size_t simplifyMesh(uint32_t *destination, const uint32_t *indices, size_t indexCount,
+                    const Vertex *vertices, size_t vertexCount, size_t targetIndexCount,
+                    float maxError, float *outError)
+{
+    indexCount -= indexCount % 3;
+    std::vector<uint32_t> result(indices, indices + indexCount);
+    float resultError = 0.0f;
+
+    // posições normalizadas pela maior dimensão: o erro já sai relativo ao tamanho do trecho
+    std::vector<glm::vec3> positions(vertexCount);
+    glm::vec3 boundsMin(0.0f), boundsMax(0.0f);
+    for (size_t i = 0; i < indexCount; ++i)
+    {
+        const glm::vec3 &p = vertices[indices[i]].position;
+        boundsMin = i == 0 ? p : glm::min(boundsMin, p);
+        boundsMax = i == 0 ? p : glm::max(boundsMax, p);
+    }
+    glm::vec3 extent = boundsMax - boundsMin;
+    float size = std::max(extent.x, std::max(extent.y, extent.z));
+    float invSize = size > 0.0f ? 1.0f / size : 0.0f;
+    for (size_t v = 0; v < vertexCount; ++v)
+        positions[v] = (vertices[v].position - boundsMin) * invSize;
+
+    SimplifyTopology topo;
+    buildTopology(result, vertices, vertexCount, topo);
+    const std::vector<uint32_t> &positionClass = topo.positionClass;
+
+    // quádricas por posição: plano de cada triângulo ponderado pela área, mais um
+    // plano perpendicular em cada lado de borda/costura para o contorno não encolher
+    std::vector<Quadric> quadrics(vertexCount, Quadric());
+    for (size_t i = 0; i < result.size(); i += 3)
+    {
+        const glm::vec3 &p0 = positions[result[i]];
+        const glm::vec3 &p1 = positions[result[i + 1]];
+        const glm::vec3 &p2 = positions[result[i + 2]];
+        glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+        float area = glm::length(n);
+        if (area == 0.0f)
+            continue;
+        n /= area;
+        float d = -glm::dot(n, p0);
+        for (int k = 0; k < 3; ++k)
+            addPlane(quadrics[positionClass[result[i + k]]], n, d, area);
+
+        for (int k = 0; k < 3; ++k)
+        {
+            if (!topo.borderEdge[i + k])
+                continue;
+            uint32_t a = result[i + k], b = result[i + (k + 1) % 3];
+            glm::vec3 edge = positions[b] - positions[a];
+            float length = glm::length(edge);
+            if (length == 0.0f)
+                continue;
+            glm::vec3 edgeNormal = glm::normalize(glm::cross(edge, n));
+            float edgeD = -glm::dot(edgeNormal, positions[a]);
+            addPlane(quadrics[positionClass[a]], edgeNormal, edgeD, length * length);
+            addPlane(quadrics[positionClass[b]], edgeNormal, edgeD, length * length);
+        }
+    }
+
+    std::vector<uint32_t> remap(vertexCount);
+    std::vector<bool> touched(vertexCount);
+    std::vector<uint32_t> offsets(vertexCount + 1), adjacency;
+    std::vector<Collapse> collapses;
+
+    // triângulos ao redor de v que usam algum vértice da classe target; devolve
+    // quantos são e o primeiro vértice dessa classe encontrado em outWedge
+    auto trianglesToward = [&](uint32_t v, uint32_t target, uint32_t &outWedge)
+    {
+        uint32_t count = 0;
+        for (uint32_t a = offsets[v]; a < offsets[v + 1]; ++a)
+        {
+            const uint32_t *tri = &result[adjacency[a] * 3];
+            for (int k = 0; k < 3; ++k)
+            {
+                if (positionClass[tri[k]] == target)
+                {
+                    if (count++ == 0)
+                        outWedge = tri[k];
+                    break;
+                }
+            }
+        }
+        return count;
+    };
+
+    // vértices que se movem no colapso from -> to (costura move as duas cópias);
+    // devolve false se a aresta não permite esse tipo de colapso
+    auto collapseWedges = [&](uint32_t from, uint32_t to, uint32_t outFrom[2], uint32_t outTo[2], int &outCount)
+    {
+        uint32_t fromClass = positionClass[from], toClass = positionClass[to];
+        outFrom[0] = from;
+        outTo[0] = to;
+        outCount = 1;
+        uint32_t wedge = 0;
+        switch (topo.kind[fromClass])
+        {
+        case KIND_MANIFOLD:
+            return true;
+        case KIND_BORDER:
+            return trianglesToward(from, toClass, wedge) == 1;
+        case KIND_SEAM:
+        {
+            uint32_t other = topo.wedgeNext[from];
+            uint32_t otherTo = 0;
+            if (trianglesToward(from, toClass, wedge) != 1 || wedge != to ||
+                trianglesToward(other, toClass, otherTo) != 1 || otherTo == to)
+                return false;
+            outFrom[1] = other;
+            outTo[1] = otherTo;
+            outCount = 2;
+            return true;
+        }
+        default:
+            return false;
+        }
+    };
+
+    while (result.size() > targetIndexCount)
+    {
+        // adjacência vértice -> triângulos da iteração atual
+        std::fill(offsets.begin(), offsets.end(), 0);
+        for (uint32_t index : result)
+            offsets[index + 1]++;
+        for (size_t v = 0; v < vertexCount; ++v)
+            offsets[v + 1] += offsets[v];
+        adjacency.resize(result.size());
+        {
+            std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+            for (size_t i = 0; i < result.size(); ++i)
+                adjacency[fill[result[i]]++] = (uint32_t)(i / 3);
+        }
+
+        // candidatos: cada aresta nos dois sentidos, o vértice de origem se move até o destino
+        collapses.clear();
+        for (size_t i = 0; i < result.size(); i += 3)
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                uint32_t a = result[i + k];
+                uint32_t b = result[i + (k + 1) % 3];
+                for (int dir = 0; dir < 2; ++dir, std::swap(a, b))
+                {
+                    if (topo.kind[positionClass[a]] == KIND_LOCKED || positionClass[a] == positionClass[b])
+                        continue;
+                    Quadric q = quadrics[positionClass[a]];
+                    addQuadric(q, quadrics[positionClass[b]]);
+                    float cost = (float)evaluate(q, positions[b]);
+                    if (cost <= maxError * maxError)
+                        collapses.push_back({a, b, cost});
+                }
+            }
+        }
+        if (collapses.empty())
+            break;
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse &x, const Collapse &y)
+                  { return x.cost < y.cost; });
+
+        // cada colapso remove ~2 triângulos; vizinhanças tocadas esperam a próxima iteração
+        size_t trianglesToRemove = (result.size() - targetIndexCount) / 3;
+        size_t collapseLimit = trianglesToRemove / 2 + 1;
+        for (size_t v = 0; v < vertexCount; ++v)
+            remap[v] = (uint32_t)v;
+        std::fill(touched.begin(), touched.end(), false);
+
+        size_t collapsed = 0;
+        for (const Collapse &c : collapses)
+        {
+            if (collapsed >= collapseLimit)
+                break;
+            if (touched[c.from] || touched[c.to])
+                continue;
+            uint32_t from[2], to[2];
+            int wedgeCount = 0;
+            if (!collapseWedges(c.from, c.to, from, to, wedgeCount))
+                continue;
+            if (wedgeCount == 2 && (touched[from[1]] || touched[to[1]]))
+                continue;
+
+            // rejeita colapsos que viram algum triângulo ao redor do vértice
+            bool flips = false;
+            for (int w = 0; w < wedgeCount && !flips; ++w)
+            {
+                for (uint32_t a = offsets[from[w]]; a < offsets[from[w] + 1] && !flips; ++a)
+                {
+                    const uint32_t *tri = &result[adjacency[a] * 3];
+                    if (tri[0] == to[w] || tri[1] == to[w] || tri[2] == to[w])
+                        continue;
+                    glm::vec3 p[3], q[3];
+                    for (int k = 0; k < 3; ++k)
+                    {
+                        p[k] = positions[tri[k]];
+                        q[k] = tri[k] == from[w] ? positions[to[w]] : p[k];
+                    }
+                    glm::vec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+                    glm::vec3 after = glm::cross(q[1] - q[0], q[2] - q[0]);
+                    flips = glm::dot(before, after) <= 0.25f * glm::length(before) * glm::length(after);
+                }
+            }
+            if (flips)
+                continue;
+
+            addQuadric(quadrics[positionClass[c.to]], quadrics[positionClass[c.from]]);
+            resultError = std::max(resultError, c.cost);
+            for (int w = 0; w < wedgeCount; ++w)
+            {
+                remap[from[w]] = to[w];
+                for (uint32_t a = offsets[from[w]]; a < offsets[from[w] + 1]; ++a)
+                {
+                    const uint32_t *tri = &result[adjacency[a] * 3];
+                    touched[tri[0]] = touched[tri[1]] = touched[tri[2]] = true;
+                }
+            }
+            ++collapsed;
+        }
+        if (collapsed == 0)
+            break;
+
+        // aplica os colapsos e descarta triângulos degenerados
+        size_t write = 0;
+        for (size_t i = 0; i < result.size(); i += 3)
+        {
+            uint32_t a = remap[result[i]], b = remap[result[i + 1]], c = remap[result[i + 2]];
+            if (a == b || b == c || a == c)
+                continue;
+            result[write++] = a;
+            result[write++] = b;
+            result[write++] = c;
+        }
+        result.resize(write);
+    }
+
+    std::copy(result.begin(), result.end(), destination);
+    if (outError)
+        *outError = std::sqrt(resultError);
+    return result.size();
+}
+
+void generateLods(ObjMesh &mesh)
+{
+    if (mesh.lods.empty())
+        return;
+    mesh.lods.resize(1);
+    size_t submeshesPerLod = mesh.submeshes.size();
+    mesh.submeshes.resize(submeshesPerLod);
+    mesh.indices.resize(mesh.lods[0].indexCount);
+
+    // simplifyMesh mede o erro relativo ao submesh; os níveis guardam relativo à malha
+    auto largestSide = [](const glm::vec3 &boundsMin, const glm::vec3 &boundsMax)
+    {
+        glm::vec3 extent = boundsMax - boundsMin;
+        return std::max(extent.x, std::max(extent.y, extent.z));
+    };
+    float meshSize = largestSide(mesh.boundsMin, mesh.boundsMax);
+
+    std::vector<uint32_t> simplified;
+    for (unsigned level = 1; level < MESH_LOD_COUNT; ++level)
+    {
+        const MeshLod previous = mesh.lods.back();
+        MeshLod lod = {(uint32_t)mesh.submeshes.size(), (uint32_t)mesh.indices.size(), 0, previous.error, 0, 0};
+
+        for (size_t s = 0; s < submeshesPerLod; ++s)
+        {
+            Submesh sub = mesh.submeshes[previous.firstSubmesh + s];
+            float subScale = meshSize > 0.0f ? largestSide(sub.boundsMin, sub.boundsMax) / meshSize : 1.0f;
+            size_t target = (size_t)(sub.indexCount / 3 * MESH_LOD_REDUCTION) * 3;
+            simplified.resize(sub.indexCount);
+
+            // o erro se acumula entre níveis; cada um só usa o que sobrou do limite
+            float budget = subScale > 0.0f ? (MESH_LOD_MAX_ERROR - previous.error) / subScale : 0.0f;
+            float error = 0.0f;
+            size_t count = simplifyMesh(simplified.data(), mesh.indices.data() + sub.firstIndex, sub.indexCount,
+                                        mesh.vertices.data(), mesh.vertices.size(), target, budget, &error);
+            optimizeVertexCache(simplified.data(), count, mesh.vertices.size());
+
+            sub.firstIndex = (uint32_t)mesh.indices.size();
+            sub.indexCount = (uint32_t)count;
+            mesh.indices.insert(mesh.indices.end(), simplified.begin(), simplified.begin() + count);
+            mesh.submeshes.push_back(sub);
+            lod.indexCount += (uint32_t)count;
+            lod.error = std::max(lod.error, previous.error + error * subScale);
+        }
+
+        // nível que quase não reduz só gastaria memória
+        if (lod.indexCount > previous.indexCount * 0.9f)
+        {
+            mesh.submeshes.resize(lod.firstSubmesh);
+            mesh.indices.resize(lod.firstIndex);
+            break;
+        }
+        mesh.lods.push_back(lod);
+    }
+}
+
+unsigned selectLod(const MeshLod *lods, unsigned lodCount, unsigned currentLod, float pixelsPerUnit)
+{
+    if (lodCount == 0)
+        return 0;
+    currentLod = std::min(currentLod, lodCount - 1);
+
+    // nível mais simples cujo erro projetado ainda fica abaixo do limite
+    unsigned target = 0;
+    for (unsigned l = 1; l < lodCount; ++l)
+    {
+        if (lods[l].error * pixelsPerUnit <= MESH_LOD_PIXEL_ERROR)
+            target = l;
+    }
+
+    if (target > currentLod)
+    {
+        // simplificar exige folga; senão fica no nível atual
+        while (target > currentLod && lods[target].error * pixelsPerUnit > MESH_LOD_PIXEL_ERROR * MESH_LOD_HYSTERESIS)
+            --target;
+    }
+    return target;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include "ObjLoader.h"
+#include <cstddef>
+#include <cstdint>
+
+// Simplificação por colapso de arestas com métricas de erro quádricas
+// (Garland & Heckbert, "Surface Simplification Using Quadric Error Metrics").
+// Vértices em costuras de UV/normal (mesma posição com atributos diferentes)
+// só andam ao longo da costura, levando as duas cópias juntas, e vértices de
+// borda só andam ao longo da borda; assim as costuras não se abrem nos níveis
+// mais simples. O resultado reaproveita o buffer de vértices original.
+
+// Níveis gerados (incluindo o original), redução de triângulos por nível e
+// erro máximo acumulado, relativo à maior dimensão da caixa envolvente
+const unsigned MESH_LOD_COUNT = 4;
+const float MESH_LOD_REDUCTION = 0.5f;
+const float MESH_LOD_MAX_ERROR = 0.05f;
+
+// Escreve em destination (capacidade indexCount) até targetIndexCount índices
+// que aproximam a malha; devolve quantos foram escritos e o erro em outError
+size_t simplifyMesh(uint32_t *destination, const uint32_t *indices, size_t indexCount,
+                    const Vertex *vertices, size_t vertexCount, size_t targetIndexCount,
+                    float maxError, float *outError);
+
+// Acrescenta até MESH_LOD_COUNT - 1 níveis em mesh.lods/submeshes/indices a
+// partir do nível 0; para quando a simplificação já não reduz a malha
+void generateLods(ObjMesh &mesh);
+
+// Escolhe o nível para o próximo quadro. pixelsPerUnit converte erro relativo
+// em pixels na distância atual; só troca para um nível mais simples com folga,
+// para não ficar alternando na fronteira (histerese)
+const float MESH_LOD_PIXEL_ERROR = 1.0f;
+const float MESH_LOD_HYSTERESIS = 0.75f;
+unsigned selectLod(const MeshLod *lods, unsigned lodCount, unsigned currentLod, float pixelsPerUnit);
@@ -0,0 +1,326 @@
+#include "Meshlets.h"
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+
+// Triângulos examinados a partir de cursor quando o meshlet fica sem vizinhos
+static const size_t MESHLET_FALLBACK_WINDOW = 256;
+
+// Esfera (centro da caixa + maior distância) e cone de normais dos triângulos
+// de indices; triangleIds aponta a normal de cada um em triangleNormals
+static void meshletBounds(const ObjMesh &mesh, const uint32_t *indices, size_t indexCount,
+                          const std::vector<glm::vec3> &triangleNormals, const uint32_t *triangleIds, Meshlet &out)
+{
+    glm::vec3 boundsMin = mesh.vertices[indices[0]].position, boundsMax = boundsMin;
+    for (size_t i = 1; i < indexCount; ++i)
+    {
+        boundsMin = glm::min(boundsMin, mesh.vertices[indices[i]].position);
+        boundsMax = glm::max(boundsMax, mesh.vertices[indices[i]].position);
+    }
+    out.center = (boundsMin + boundsMax) * 0.5f;
+    out.radius = 0.0f;
+    for (size_t i = 0; i < indexCount; ++i)
+        out.radius = std::max(out.radius, glm::length(mesh.vertices[indices[i]].position - out.center));
+
+    glm::vec3 axis(0.0f);
+    size_t triangleCount = indexCount / 3;
+    for (size_t t = 0; t < triangleCount; ++t)
+        axis += triangleNormals[triangleIds[t]];
+    float axisLength = glm::length(axis);
+
+    out.coneAxis = glm::vec3(0.0f, 0.0f, 1.0f);
+    out.coneCutoff = 1.0f;
+    if (axisLength <= 0.0f)
+        return;
+    axis /= axisLength;
+
+    float minDot = 1.0f;
+    for (size_t t = 0; t < triangleCount; ++t)
+    {
+        const glm::vec3 &n = triangleNormals[triangleIds[t]];
+        if (n != glm::vec3(0.0f))
+            minDot = std::min(minDot, glm::dot(n, axis));
+    }
+    // abertura de 90 graus ou mais: sempre há algum triângulo de frente
+    if (minDot <= 0.0f)
+        return;
+    out.coneAxis = axis;
+    out.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+}
+
+// Agrupa os triângulos da faixa [firstIndex, firstIndex + indexCount) em meshlets,
+// reescrevendo a faixa na nova ordem
+static void buildRange(ObjMesh &mesh, uint32_t firstIndex, uint32_t indexCount)
+{
+    uint32_t *indices = mesh.indices.data() + firstIndex;
+    size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0)
+        return;
+
+    std::vector<glm::vec3> normals(triangleCount), centroids(triangleCount);
+    for (size_t t = 0; t < triangleCount; ++t)
+    {
+        const glm::vec3 &a = mesh.vertices[indices[t * 3]].position;
+        const glm::vec3 &b = mesh.vertices[indices[t * 3 + 1]].position;
+        const glm::vec3 &c = mesh.vertices[indices[t * 3 + 2]].position;
+        glm::vec3 n = glm::cross(b - a, c - a);
+        float length = glm::length(n);
+        normals[t] = length > 0.0f ? n / length : glm::vec3(0.0f);
+        centroids[t] = (a + b + c) / 3.0f;
+    }
+
+    // índices locais compactados: por vértice (conta no limite do meshlet) e por
+    // posição (vizinhança, que atravessa as costuras de UV/normal)
+    std::vector<uint32_t> local(indices, indices + triangleCount * 3);
+    std::vector<uint32_t> unique(local);
+    std::sort(unique.begin(), unique.end());
+    unique.erase(std::unique(unique.begin(), unique.end()), unique.end());
+    for (uint32_t &v : local)
+        v = (uint32_t)(std::lower_bound(unique.begin(), unique.end(), v) - unique.begin());
+
+    std::vector<uint32_t> positionOf(unique.size());
+    uint32_t positionCount = 0;
+    {
+        std::unordered_map<glm::vec3, uint32_t, PositionHash, PositionEqual> first;
+        first.reserve(unique.size());
+        for (size_t v = 0; v < unique.size(); ++v)
+        {
+            auto it = first.emplace(mesh.vertices[unique[v]].position, positionCount);
+            if (it.second)
+                ++positionCount;
+            positionOf[v] = it.first->second;
+        }
+    }
+
+    std::vector<uint32_t> offsets(positionCount + 1, 0), adjacency(triangleCount * 3);
+    for (uint32_t v : local)
+        offsets[positionOf[v] + 1]++;
+    for (size_t p = 0; p < positionCount; ++p)
+        offsets[p + 1] += offsets[p];
+    {
+        std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < local.size(); ++i)
+            adjacency[fill[positionOf[local[i]]]++] = (uint32_t)(i / 3);
+    }
+
+    std::vector<bool> used(triangleCount, false);
+    std::vector<uint32_t> order; // triângulos na ordem dos meshlets
+    order.reserve(triangleCount);
+    std::vector<uint32_t> vertexStamp(unique.size(), 0), positionStamp(positionCount, 0);
+    std::vector<uint32_t> meshletPositions;
+    uint32_t stamp = 0; // *Stamp[x] == stamp: x já está no meshlet atual
+    size_t cursor = 0;
+
+    while (order.size() < triangleCount)
+    {
+        while (used[cursor])
+            ++cursor;
+
+        size_t meshletStart = order.size();
+        size_t vertexCount = 0;
+        meshletPositions.clear();
+        ++stamp;
+        glm::vec3 normalSum(0.0f);
+        glm::vec3 boundsMin = centroids[cursor], boundsMax = boundsMin;
+
+        uint32_t next = (uint32_t)cursor;
+        while (true)
+        {
+            used[next] = true;
+            order.push_back(next);
+            normalSum += normals[next];
+            for (int k = 0; k < 3; ++k)
+            {
+                uint32_t v = local[next * 3 + k];
+                if (vertexStamp[v] != stamp)
+                {
+                    vertexStamp[v] = stamp;
+                    ++vertexCount;
+                    const glm::vec3 &p = mesh.vertices[unique[v]].position;
+                    boundsMin = glm::min(boundsMin, p);
+                    boundsMax = glm::max(boundsMax, p);
+                }
+                if (positionStamp[positionOf[v]] != stamp)
+                {
+                    positionStamp[positionOf[v]] = stamp;
+                    meshletPositions.push_back(positionOf[v]);
+                }
+            }
+            if (order.size() - meshletStart >= MESHLET_MAX_TRIANGLES)
+                break;
+
+            auto addedVertices = [&](uint32_t t)
+            {
+                unsigned added = 0;
+                for (int k = 0; k < 3; ++k)
+                    added += vertexStamp[local[t * 3 + k]] != stamp;
+                return added;
+            };
+
+            // vizinho que acrescenta menos vértices; empate decidido pela normal mais
+            // parecida com a média, para o cone ficar estreito
+            int best = -1;
+            float bestScore = 1e30f;
+            glm::vec3 averageNormal = glm::length(normalSum) > 0.0f ? glm::normalize(normalSum) : glm::vec3(0.0f);
+            for (uint32_t p : meshletPositions)
+            {
+                for (uint32_t a = offsets[p]; a < offsets[p + 1]; ++a)
+                {
+                    uint32_t t = adjacency[a];
+                    if (used[t])
+                        continue;
+                    unsigned added = addedVertices(t);
+                    if (vertexCount + added > MESHLET_MAX_VERTICES)
+                        continue;
+                    float score = (float)added - 0.5f * glm::dot(normals[t], averageNormal);
+                    if (score < bestScore)
+                    {
+                        bestScore = score;
+                        best = (int)t;
+                    }
+                }
+            }
+
+            // sem vizinhos (peça solta): aproveita o triângulo livre mais próximo que
+            // ainda caiba na esfera atual, para não sobrarem meshlets minúsculos.
+            // Só olha uma janela a partir de cursor: malhas com muitas ilhas
+            // cairiam aqui quase a cada triângulo
+            if (best < 0 && vertexCount + 3 <= MESHLET_MAX_VERTICES)
+            {
+                while (cursor < triangleCount && used[cursor])
+                    ++cursor;
+                glm::vec3 center = (boundsMin + boundsMax) * 0.5f;
+                float radius = glm::length(boundsMax - boundsMin) * 0.5f;
+                float bestDistance = radius;
+                size_t windowEnd = std::min(triangleCount, cursor + MESHLET_FALLBACK_WINDOW);
+                for (size_t t = cursor; t < windowEnd; ++t)
+                {
+                    if (used[t])
+                        continue;
+                    float distance = glm::length(centroids[t] - center);
+                    if (distance <= bestDistance)
+                    {
+                        bestDistance = distance;
+                        best = (int)t;
+                    }
+                }
+            }
+            if (best < 0)
+                break;
+            next = (uint32_t)best;
+        }
+
+        std::vector<uint32_t> meshletIndices;
+        for (size_t i = meshletStart; i < order.size(); ++i)
+            for (int k = 0; k < 3; ++k)
+                meshletIndices.push_back(indices[order[i] * 3 + k]);
+
+        Meshlet meshlet;
+        meshlet.firstIndex = firstIndex + (uint32_t)meshletStart * 3;
+        meshlet.indexCount = (uint32_t)meshletIndices.size();
+        meshletBounds(mesh, meshletIndices.data(), meshletIndices.size(), normals, order.data() + meshletStart, meshlet);
+        mesh.meshlets.push_back(meshlet);
+    }
+
+    // reescreve a faixa na ordem dos meshlets
+    std::vector<uint32_t> reordered;
+    reordered.reserve(triangleCount * 3);
+    for (uint32_t t : order)
+        reordered.insert(reordered.end(), indices + t * 3, indices + t * 3 + 3);
+    std::copy(reordered.begin(), reordered.end(), indices);
+}
+
+void buildMeshlets(ObjMesh &mesh)
+{
+    mesh.meshlets.clear();
+    size_t submeshesPerLod = mesh.lods.empty() ? 0 : mesh.submeshes.size() / mesh.lods.size();
+
+    // índice global -> local do meshlet; só as entradas usadas são limpas depois,
+    // para o otimizador trabalhar com no máximo MESHLET_MAX_VERTICES vértices
+    const uint32_t unmapped = 0xFFFFFFFFu;
+    std::vector<uint32_t> localIndex(mesh.vertices.size(), unmapped);
+    std::vector<uint32_t> globalIndex;
+    std::vector<uint32_t> local;
+
+    for (MeshLod &lod : mesh.lods)
+    {
+        lod.firstMeshlet = (uint32_t)mesh.meshlets.size();
+        for (size_t s = 0; s < submeshesPerLod; ++s)
+        {
+            const Submesh &sub = mesh.submeshes[lod.firstSubmesh + s];
+            buildRange(mesh, sub.firstIndex, sub.indexCount);
+        }
+        lod.meshletCount = (uint32_t)mesh.meshlets.size() - lod.firstMeshlet;
+
+        // ordem boa para o cache dentro de cada meshlet
+        for (uint32_t m = lod.firstMeshlet; m < lod.firstMeshlet + lod.meshletCount; ++m)
+        {
+            const Meshlet &meshlet = mesh.meshlets[m];
+            uint32_t *indices = mesh.indices.data() + meshlet.firstIndex;
+            globalIndex.clear();
+            local.resize(meshlet.indexCount);
+            for (uint32_t i = 0; i < meshlet.indexCount; ++i)
+            {
+                uint32_t &mapped = localIndex[indices[i]];
+                if (mapped == unmapped)
+                {
+                    mapped = (uint32_t)globalIndex.size();
+                    globalIndex.push_back(indices[i]);
+                }
+                local[i] = mapped;
+            }
+            optimizeVertexCache(local.data(), local.size(), globalIndex.size());
+            for (uint32_t i = 0; i < meshlet.indexCount; ++i)
+                indices[i] = globalIndex[local[i]];
+            for (uint32_t v : globalIndex)
+                localIndex[v] = unmapped;
+        }
+    }
+}
+
+MeshletCuller makeMeshletCuller(const glm::mat4 &viewProjection, const glm::mat4 &model, const glm::vec3 &cameraPos)
+{
+    // planos de Gribb/Hartmann em clip space, levados ao espaço do objeto por (P V M)^T
+    glm::mat4 m = glm::transpose(viewProjection * model);
+    glm::vec4 row0 = m[0], row1 = m[1], row2 = m[2], row3 = m[3];
+
+    MeshletCuller culler;
+    culler.planes[0] = row3 + row0;
+    culler.planes[1] = row3 - row0;
+    culler.planes[2] = row3 + row1;
+    culler.planes[3] = row3 - row1;
+    culler.planes[4] = row3 + row2;
+    culler.planes[5] = row3 - row2;
+    for (int i = 0; i < 6; ++i)
+        culler.planeLength[i] = glm::length(glm::vec3(culler.planes[i]));
+    culler.camera = glm::vec3(glm::inverse(model) * glm::vec4(cameraPos, 1.0f));
+    return culler;
+}
+
+bool sphereVisible(const glm::vec3 &center, float radius, const MeshletCuller &culler)
+{
+    for (int i = 0; i < 6; ++i)
+    {
+        const glm::vec4 &p = culler.planes[i];
+        if (glm::dot(glm::vec3(p), center) + p.w < -radius * culler.planeLength[i])
+            return false;
+    }
+    return true;
+}
+
+bool meshletVisible(const Meshlet &meshlet, const MeshletCuller &culler)
+{
+    if (!sphereVisible(meshlet.center, meshlet.radius, culler))
+        return false;
+
+    // todos os triângulos de costas: a câmera está dentro do cone "de trás"
+    if (meshlet.coneCutoff < 1.0f)
+    {
+        glm::vec3 toCenter = meshlet.center - culler.camera;
+        if (glm::dot(toCenter, meshlet.coneAxis) >= meshlet.coneCutoff * glm::length(toCenter) + meshlet.radius)
+            return false;
+    }
+    return true;
+}
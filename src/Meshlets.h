@@ -0,0 +1,32 @@
+#pragma once
+#include "ObjLoader.h"
+#include <cstddef>
+#include <cstdint>
+
+// Divisão da malha em meshlets: cada nível de detalhe e submesh tem seus
+// triângulos reagrupados em blocos de até MESHLET_MAX_VERTICES vértices e
+// MESHLET_MAX_TRIANGLES triângulos vizinhos. Cada bloco ocupa uma faixa do
+// buffer de índices, então os visíveis são desenhados com glMultiDrawElements.
+const unsigned MESHLET_MAX_VERTICES = 64;
+const unsigned MESHLET_MAX_TRIANGLES = 124;
+
+// Reordena os triângulos de cada nível/submesh e preenche mesh.meshlets e
+// os campos firstMeshlet/meshletCount de mesh.lods
+void buildMeshlets(ObjMesh &mesh);
+
+// Planos do frustum e câmera levados para o espaço do objeto, para testar os
+// meshlets sem transformar cada um. Vale para escala uniforme no model.
+struct MeshletCuller
+{
+    glm::vec4 planes[6];  // ax + by + cz + d >= 0 dentro
+    float planeLength[6]; // |(a, b, c)|, para comparar com o raio
+    glm::vec3 camera;
+};
+
+MeshletCuller makeMeshletCuller(const glm::mat4 &viewProjection, const glm::mat4 &model, const glm::vec3 &cameraPos);
+
+// false se a esfera (no espaço do objeto) está toda fora do frustum
+bool sphereVisible(const glm::vec3 &center, float radius, const MeshletCuller &culler);
+
+// false se o meshlet está fora do frustum ou com todos os triângulos de costas
+bool meshletVisible(const Meshlet &meshlet, const MeshletCuller &culler);
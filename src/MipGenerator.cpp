@@ -0,0 +1,240 @@
+#include "MipGenerator.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MIP_SIMD_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define MIP_SIMD_NEON 1
+#endif
+
+// Abaixo disso (pixels de saída) uma faixa só é mais rápida que repartir
+static const int MIP_PARALLEL_MIN_PIXELS = 256 * 256;
+static const int MIP_LINEAR_STEPS = 4096; // resolução da volta linear -> sRGB
+
+// Tabelas de conversão, montadas uma vez
+struct SrgbTables
+{
+    float toLinear[256];
+    unsigned char fromLinear[MIP_LINEAR_STEPS + 1];
+
+    SrgbTables()
+    {
+        for (int i = 0; i < 256; ++i)
+        {
+            float c = i / 255.0f;
+            toLinear[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+        }
+        for (int i = 0; i <= MIP_LINEAR_STEPS; ++i)
+        {
+            float l = (float)i / MIP_LINEAR_STEPS;
+            float c = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+            fromLinear[i] = (unsigned char)std::lround(std::min(std::max(c, 0.0f), 1.0f) * 255.0f);
+        }
+    }
+};
+
+static const SrgbTables &srgbTables()
+{
+    static const SrgbTables tables;
+    return tables;
+}
+
+static MipParallelFor g_mipParallelFor;
+static bool g_mipSimd = true;
+
+void setMipParallelFor(MipParallelFor parallelFor)
+{
+    g_mipParallelFor = std::move(parallelFor);
+}
+
+const char *mipSimdName()
+{
+#if defined(MIP_SIMD_SSE2)
+    return "SSE2";
+#elif defined(MIP_SIMD_NEON)
+    return "NEON";
+#else
+    return nullptr;
+#endif
+}
+
+void setMipSimd(bool enabled)
+{
+    g_mipSimd = enabled;
+}
+
+size_t mipPitch(int width, int channels)
+{
+    return ((size_t)width * channels + 3) & ~(size_t)3;
+}
+
+unsigned mipBandCount(int width, int height)
+{
+    if (width * height < MIP_PARALLEL_MIN_PIXELS)
+        return 1;
+    unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    return std::min<unsigned>(hardware, (unsigned)(width * height / MIP_PARALLEL_MIN_PIXELS) + 1);
+}
+
+#if defined(MIP_SIMD_SSE2) || defined(MIP_SIMD_NEON)
+// 4 pixels de saída por vez, a partir de colunas inteiras (x * 2 + 1 < width).
+// A ida para o linear continua na tabela (nem SSE2 nem NEON têm gather): as
+// consultas montam um vetor por amostra do 2x2, com um pixel por posição. A
+// soma, a escala para o índice da volta e o alfa saem em vetores, na mesma
+// ordem de operações do escalar, então o resultado é idêntico. Devolve quantos
+// pixels fez.
+static int downsampleRowSimd(const unsigned char *row0, const unsigned char *row1, int channels, int count,
+                             unsigned char *out, const SrgbTables &tables)
+{
+    const int stride = channels * 2; // bytes de entrada por pixel de saída
+    int x = 0;
+    for (; x + 4 <= count; x += 4, row0 += stride * 4, row1 += stride * 4, out += channels * 4)
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+            const float *lin = tables.toLinear;
+            const unsigned char *a = row0 + k, *b = row1 + k;
+            int32_t index[4];
+#if defined(MIP_SIMD_SSE2)
+            // um vetor por amostra do 2x2 (linha 0 e 1, coluna par e ímpar), um pixel por posição
+            __m128 sum = _mm_setr_ps(lin[a[0]], lin[a[stride]], lin[a[stride * 2]], lin[a[stride * 3]]);
+            sum = _mm_add_ps(sum, _mm_setr_ps(lin[a[channels]], lin[a[stride + channels]], lin[a[stride * 2 + channels]],
+                                              lin[a[stride * 3 + channels]]));
+            sum = _mm_add_ps(sum, _mm_setr_ps(lin[b[0]], lin[b[stride]], lin[b[stride * 2]], lin[b[stride * 3]]));
+            sum = _mm_add_ps(sum, _mm_setr_ps(lin[b[channels]], lin[b[stride + channels]], lin[b[stride * 2 + channels]],
+                                              lin[b[stride * 3 + channels]]));
+            sum = _mm_mul_ps(_mm_mul_ps(sum, _mm_set1_ps(0.25f)), _mm_set1_ps((float)MIP_LINEAR_STEPS));
+            _mm_storeu_si128((__m128i *)index, _mm_cvttps_epi32(_mm_add_ps(sum, _mm_set1_ps(0.5f))));
+#else
+            auto gather = [lin, stride](const unsigned char *p)
+            {
+                float32x4_t v = vdupq_n_f32(lin[p[0]]);
+                v = vsetq_lane_f32(lin[p[stride]], v, 1);
+                v = vsetq_lane_f32(lin[p[stride * 2]], v, 2);
+                return vsetq_lane_f32(lin[p[stride * 3]], v, 3);
+            };
+            float32x4_t sum = vaddq_f32(vaddq_f32(vaddq_f32(gather(a), gather(a + channels)), gather(b)), gather(b + channels));
+            sum = vmulq_n_f32(vmulq_n_f32(sum, 0.25f), (float)MIP_LINEAR_STEPS);
+            vst1q_s32(index, vcvtq_s32_f32(vaddq_f32(sum, vdupq_n_f32(0.5f))));
+#endif
+            for (int i = 0; i < 4; ++i)
+                out[i * channels + k] = tables.fromLinear[index[i]];
+        }
+        if (channels != 4)
+            continue;
+
+        // alfa: 8 pixels de entrada por linha, somados aos pares
+        uint16_t alpha[4];
+#if defined(MIP_SIMD_SSE2)
+        __m128i low = _mm_add_epi32(_mm_srli_epi32(_mm_loadu_si128((const __m128i *)row0), 24),
+                                    _mm_srli_epi32(_mm_loadu_si128((const __m128i *)row1), 24));
+        __m128i high = _mm_add_epi32(_mm_srli_epi32(_mm_loadu_si128((const __m128i *)(row0 + 16)), 24),
+                                     _mm_srli_epi32(_mm_loadu_si128((const __m128i *)(row1 + 16)), 24));
+        __m128i sums = _mm_madd_epi16(_mm_packs_epi32(low, high), _mm_set1_epi16(1));
+        sums = _mm_srli_epi32(_mm_add_epi32(sums, _mm_set1_epi32(2)), 2);
+        int32_t alpha32[4];
+        _mm_storeu_si128((__m128i *)alpha32, sums);
+        for (int i = 0; i < 4; ++i)
+            alpha[i] = (uint16_t)alpha32[i];
+#else
+        uint16x4_t sums = vadd_u16(vpaddl_u8(vld4_u8(row0).val[3]), vpaddl_u8(vld4_u8(row1).val[3]));
+        vst1_u16(alpha, vshr_n_u16(vadd_u16(sums, vdup_n_u16(2)), 2));
+#endif
+        for (int i = 0; i < 4; ++i)
+            out[i * 4 + 3] = (unsigned char)alpha[i];
+    }
+    return x;
+}
+#endif
+
+// Linhas [rowBegin, rowEnd) do nível de saída
+static void downsampleRows(const unsigned char *src, size_t srcPitch, int width, int height, int channels,
+                           unsigned char *dst, size_t dstPitch, int w, int rowBegin, int rowEnd)
+{
+    const SrgbTables &tables = srgbTables();
+    for (int y = rowBegin; y < rowEnd; ++y)
+    {
+        // lados ímpares ou de tamanho 1: a segunda linha/coluna repete a primeira
+        const unsigned char *row0 = src + std::min(y * 2, height - 1) * srcPitch;
+        const unsigned char *row1 = src + std::min(y * 2 + 1, height - 1) * srcPitch;
+        unsigned char *out = dst + y * dstPitch;
+        int x = 0;
+#if defined(MIP_SIMD_SSE2) || defined(MIP_SIMD_NEON)
+        if (g_mipSimd)
+        {
+            x = downsampleRowSimd(row0, row1, channels, width / 2, out, tables);
+            out += (size_t)x * channels;
+        }
+#endif
+        for (; x < w; ++x)
+        {
+            size_t x0 = (size_t)std::min(x * 2, width - 1) * channels;
+            size_t x1 = (size_t)std::min(x * 2 + 1, width - 1) * channels;
+            const unsigned char *p[4] = {row0 + x0, row0 + x1, row1 + x0, row1 + x1};
+            for (int k = 0; k < 3; ++k)
+            {
+                float sum = tables.toLinear[p[0][k]] + tables.toLinear[p[1][k]] + tables.toLinear[p[2][k]] + tables.toLinear[p[3][k]];
+                out[k] = tables.fromLinear[(int)(sum * 0.25f * MIP_LINEAR_STEPS + 0.5f)];
+            }
+            if (channels == 4)
+                out[3] = (unsigned char)((p[0][3] + p[1][3] + p[2][3] + p[3][3] + 2) / 4);
+            out += channels;
+        }
+    }
+}
+
+void downsampleLinear(const unsigned char *src, size_t srcPitch, int width, int height, int channels,
+                      unsigned char *dst, size_t dstPitch, unsigned bandCount)
+{
+    int w = std::max(1, width / 2), h = std::max(1, height / 2);
+    if (bandCount == 0)
+        bandCount = mipBandCount(w, h);
+    bandCount = std::min<unsigned>(bandCount, (unsigned)h);
+    if (bandCount <= 1 || !g_mipParallelFor)
+    {
+        downsampleRows(src, srcPitch, width, height, channels, dst, dstPitch, w, 0, h);
+        return;
+    }
+
+    int band = (h + (int)bandCount - 1) / (int)bandCount;
+    g_mipParallelFor((unsigned)((h + band - 1) / band), [&](unsigned i)
+                     {
+        int begin = (int)i * band;
+        downsampleRows(src, srcPitch, width, height, channels, dst, dstPitch, w, begin, std::min(h, begin + band)); });
+}
+
+void generateMipChain(const unsigned char *pixels, int width, int height, int channels, MipChain &out,
+                      unsigned bandCount)
+{
+    out.channels = channels;
+    out.levels.clear();
+    size_t total = 0;
+    for (int w = width, h = height;; w = std::max(1, w / 2), h = std::max(1, h / 2))
+    {
+        size_t pitch = mipPitch(w, channels);
+        out.levels.push_back({w, h, pitch, total, pitch * h});
+        total += pitch * h;
+        if (w == 1 && h == 1)
+            break;
+    }
+    out.data.assign(total, 0);
+
+    const MipLevel &base = out.levels[0];
+    size_t rowBytes = (size_t)width * channels;
+    for (int y = 0; y < height; ++y)
+        memcpy(out.data.data() + y * base.pitch, pixels + y * rowBytes, rowBytes);
+
+    for (size_t l = 1; l < out.levels.size(); ++l)
+    {
+        const MipLevel &src = out.levels[l - 1];
+        const MipLevel &dst = out.levels[l];
+        downsampleLinear(out.data.data() + src.offset, src.pitch, src.width, src.height, channels,
+                         out.data.data() + dst.offset, dst.pitch, bandCount);
+    }
+}
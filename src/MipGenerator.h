@@ -0,0 +1,64 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+// Cadeia de mipmaps gerada na CPU, no lugar de glGenerateMipmap. O filtro de
+// caixa 2x2 trabalha em espaço linear: as cores (sRGB) passam por uma tabela
+// para luz linear, são somadas e voltam para sRGB por outra tabela; o alfa é
+// filtrado direto. Médias em gama escurecem bordas e detalhes finos nos níveis
+// menores, que é o que os drivers fazem com texturas RGB8.
+// Com SSE2 (x86-64) ou NEON a soma do 2x2, a conversão para o índice da tabela
+// de volta e o alfa saem 4 pixels por vez; as consultas às tabelas continuam
+// escalares. O resultado é o mesmo do caminho escalar, que fica para os outros
+// processadores e para comparação (setMipSimd).
+// Níveis grandes são divididos em faixas de linhas, repartidas pelo pool
+// registrado em setMipParallelFor.
+
+struct MipLevel
+{
+    int width;
+    int height;
+    size_t pitch;  // bytes por linha, alinhado a 4 (GL_UNPACK_ALIGNMENT padrão)
+    size_t offset; // em MipChain::data
+    size_t size;
+};
+
+struct MipChain
+{
+    int channels = 4;
+    std::vector<MipLevel> levels; // do original até 1x1
+    std::vector<unsigned char> data;
+};
+
+// Bytes por linha como o GL lê: width * channels alinhado a 4
+size_t mipPitch(int width, int channels);
+
+// Executa task(0..count-1), possivelmente em paralelo, e volta quando todas terminaram
+using MipParallelFor = std::function<void(unsigned count, const std::function<void(unsigned)> &task)>;
+
+// Pool que executa as faixas (no programa, AsyncLoader::parallelFor). Sem pool,
+// o padrão, as faixas rodam na thread que chama. Só deve ser trocado sem
+// nenhuma geração em andamento.
+void setMipParallelFor(MipParallelFor parallelFor);
+
+// Conjunto de instruções do caminho vetorial ("SSE2", "NEON"), nullptr se a
+// compilação não tem nenhum
+const char *mipSimdName();
+
+// Liga (o padrão) ou desliga o caminho vetorial, para medir o escalar; como
+// setMipParallelFor, só com nenhuma geração em andamento
+void setMipSimd(bool enabled);
+
+// Faixas para reduzir um nível com width x height pixels de saída
+unsigned mipBandCount(int width, int height);
+
+// Um nível a partir do anterior (metade de cada lado, mínimo 1) em espaço
+// linear; channels 3 ou 4. bandCount 0: mipBandCount
+void downsampleLinear(const unsigned char *src, size_t srcPitch, int width, int height, int channels,
+                      unsigned char *dst, size_t dstPitch, unsigned bandCount = 0);
+
+// Copia pixels (linhas contíguas, sem alinhamento) para o nível 0 e gera os
+// demais até 1x1
+void generateMipChain(const unsigned char *pixels, int width, int height, int channels, MipChain &out,
+                      unsigned bandCount = 0);
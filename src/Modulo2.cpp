@@ -23,11 +23,15 @@ using namespace std;
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include "ShaderProgram.h"
+#include "ShaderProgram.cpp"
+#include "InstanceBuffer.h"
+#include "InstanceBuffer.cpp"
+
 // Protótipo da função de callback de teclado
 void key_callback(GLFWwindow *window, int key, int scancode, int action, int mode);
 
 // Protótipos das funções
-int setupShader();
 int setupGeometry();
 
 // Dimensões da janela (pode ser alterado em tempo de execução)
@@ -37,7 +41,7 @@ const GLuint WIDTH = 1000, HEIGHT = 1000;
 const GLchar *vertexShaderSource = "#version 450\n"
 								   "layout (location = 0) in vec3 position;\n"
 								   "layout (location = 1) in vec3 color;\n"
-								   "uniform mat4 model;\n"
+								   "layout (location = 4) in mat4 model;\n" // por instância (InstanceBuffer)
 								   "uniform mat4 view;\n"
 								   "uniform mat4 projection;\n"
 								   "out vec4 finalColor;\n"
@@ -102,30 +106,31 @@ int main()
 	glViewport(0, 0, width, height);
 
 	// Compilando e buildando o programa de shader
-	GLuint shaderID = setupShader();
+	ShaderProgram shader;
+	shader.build(vertexShaderSource, fragmentShaderSource);
 
 	// Gerando um buffer simples, com a geometria de um triângulo
 	GLuint VAO = setupGeometry();
 
-	glUseProgram(shaderID);
+	shader.use();
 	// Localizações dos uniforms
-	GLint modelLoc = glGetUniformLocation(shaderID, "model");
-	GLint viewLoc = glGetUniformLocation(shaderID, "view");
-	GLint projectionLoc = glGetUniformLocation(shaderID, "projection");
+	GLint viewLoc = shader.location("view");
+	GLint projectionLoc = shader.location("projection");
 
 	// Matriz de visualização (posição da câmera)
 	glm::mat4 view = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -3.0f));
-	glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
+	shader.setMat4(viewLoc, view);
 
 	// Matriz de projeção (perspectiva)
 	glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)WIDTH / HEIGHT, 0.1f, 100.0f);
-	glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, glm::value_ptr(projection));
-
-	glm::mat4 model = glm::mat4(1); // matriz identidade;
+	shader.setMat4(projectionLoc, projection);
 
-	//
-	model = glm::rotate(model, /*(GLfloat)glfwGetTime()*/ glm::radians(90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
-	glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
+	// Uma matriz model por cubo: os 9 saem num draw instanciado
+	InstanceBuffer instances;
+	instances.create(9);
+	instances.attach(VAO, 4);
+	glBindVertexArray(0);
+	std::vector<glm::mat4> models;
 
 	glEnable(GL_DEPTH_TEST);
 
@@ -157,6 +162,7 @@ int main()
 
 		float angle = (GLfloat)glfwGetTime();
 
+		models.clear();
 		for (unsigned int i = 0; i < cubePositions.size(); i++)
 		{
 			glm::mat4 model = glm::mat4(1.0f);
@@ -170,17 +176,20 @@ int main()
 			else if (rotateZ)
 				model = glm::rotate(model, angle * (i + 1), glm::vec3(0.0f, 0.0f, 1.0f));
 
-			glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-
-			glDrawArrays(GL_TRIANGLES, 0, 36);
-			glDrawArrays(GL_POINTS, 0, 36);
+			models.push_back(model);
 		}
+		instances.upload(models.data(), models.size());
+
+		glDrawArraysInstanced(GL_TRIANGLES, 0, 36, (GLsizei)models.size());
+		glDrawArraysInstanced(GL_POINTS, 0, 36, (GLsizei)models.size());
 
 		glBindVertexArray(0);
 		glfwSwapBuffers(window);
 	}
 	// Pede pra OpenGL desalocar os buffers
 	glDeleteVertexArrays(1, &VAO);
+	instances.destroy();
+	shader.destroy();
 	// Finaliza a execução da GLFW, limpando os recursos alocados por ela
 	glfwTerminate();
 	return 0;
@@ -216,58 +225,6 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
 	}
 }
 
-// Esta função está basntante hardcoded - objetivo é compilar e "buildar" um programa de
-//  shader simples e único neste exemplo de código
-//  O código fonte do vertex e fragment shader está nos arrays vertexShaderSource e
-//  fragmentShader source no iniçio deste arquivo
-//  A função retorna o identificador do programa de shader
-int setupShader()
-{
-	// Vertex shader
-	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-	glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-	glCompileShader(vertexShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	GLint success;
-	GLchar infoLog[512];
-	glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n"
-				  << infoLog << std::endl;
-	}
-	// Fragment shader
-	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-	glCompileShader(fragmentShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n"
-				  << infoLog << std::endl;
-	}
-	// Linkando os shaders e criando o identificador do programa de shader
-	GLuint shaderProgram = glCreateProgram();
-	glAttachShader(shaderProgram, vertexShader);
-	glAttachShader(shaderProgram, fragmentShader);
-	glLinkProgram(shaderProgram);
-	// Checando por erros de linkagem
-	glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-	if (!success)
-	{
-		glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n"
-				  << infoLog << std::endl;
-	}
-	glDeleteShader(vertexShader);
-	glDeleteShader(fragmentShader);
-
-	return shaderProgram;
-}
-
 // Esta função está bastante harcoded - objetivo é criar os buffers que armazenam a
 // geometria de um triângulo
 // Apenas atributo coordenada nos vértices
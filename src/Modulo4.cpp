@@ -31,20 +31,18 @@ using namespace std;
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
+// Leitor de .obj compartilhado
+#include "ObjLoader.h"
+#include "ObjLoader.cpp"
+#include "ShaderProgram.h"
+#include "ShaderProgram.cpp"
+
 // Protótipo da função de callback de teclado
 void key_callback(GLFWwindow *window, int key, int scancode, int action, int mode);
 
-struct Vertex
-{
-	glm::vec3 position;
-	glm::vec3 normal;
-	glm::vec2 texCoord;
-	glm::vec3 color;
-};
 // Protótipos das funções
-int setupShader();
 int setupGeometry();
-GLuint loadGeometry(const std::string &objPath, const std::string &mtlPath, const std::string &texFolder, GLuint &outTexID, size_t &outVertexCount);
+GLuint loadGeometry(const std::string &objPath, const std::string &mtlPath, const std::string &texFolder, GLuint &outTexID, size_t &outIndexCount);
 
 GLuint loadTexture(std::string filePath, int &width, int &height);
 
@@ -165,22 +163,23 @@ int main()
 	glViewport(0, 0, width, height);
 
 	// Compilando e buildando o programa de shader
-	GLuint shaderID = setupShader();
+	ShaderProgram shader;
+	shader.build(vertexShaderSource, fragmentShaderSource);
 
 	GLuint VAO;
 	GLuint texID;
-	size_t vertexCount = 0;
-	VAO = loadGeometry("../assets/modelos3D/Suzanne.obj", "../assets/modelos3D/Suzanne.mtl", "../assets/modelos3D", texID, vertexCount);
+	size_t indexCount = 0;
+	VAO = loadGeometry("../assets/modelos3D/Suzanne.obj", "../assets/modelos3D/Suzanne.mtl", "../assets/modelos3D", texID, indexCount);
 
-	glUseProgram(shaderID);
+	shader.use();
 	glBindTexture(GL_TEXTURE_2D, texID);						// pertence a texture  ser mostrada
-	glUniform1i(glGetUniformLocation(shaderID, "texture1"), 0); // slot 0
+	shader.setInt("texture1", 0); // slot 0
 
 	glm::mat4 model = glm::mat4(1); // matriz identidade;
-	GLint modelLoc = glGetUniformLocation(shaderID, "model");
+	GLint modelLoc = shader.location("model");
 	//
 	model = glm::rotate(model, /*(GLfloat)glfwGetTime()*/ glm::radians(90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
-	glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
+	shader.setMat4(modelLoc, model);
 
 	glEnable(GL_DEPTH_TEST);
 
@@ -196,19 +195,19 @@ int main()
 		glm::vec3(0.0f, 1.0f, 0.0f)	 // up vector
 	);
 
-	GLint viewLoc = glGetUniformLocation(shaderID, "view");
-	GLint projLoc = glGetUniformLocation(shaderID, "projection");
+	GLint viewLoc = shader.location("view");
+	GLint projLoc = shader.location("projection");
 
-	glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
-	glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
+	shader.setMat4(viewLoc, view);
+	shader.setMat4(projLoc, projection);
 
 	glm::vec3 lightPos(1.2f, 1.0f, 2.0f);
 	glm::vec3 viewPos(2.0f, 2.0f, 2.0f); // mesma posição da câmera usada na view
 	glm::vec3 lightColor(1.0f, 1.0f, 1.0f);
 
-	GLint lightPosLoc = glGetUniformLocation(shaderID, "lightPos");
-	GLint viewPosLoc = glGetUniformLocation(shaderID, "viewPos");
-	GLint lightColorLoc = glGetUniformLocation(shaderID, "lightColor");
+	GLint lightPosLoc = shader.location("lightPos");
+	GLint viewPosLoc = shader.location("viewPos");
+	GLint lightColorLoc = shader.location("lightColor");
 
 	// Loop da aplicação - "game loop"
 	while (!glfwWindowShouldClose(window))
@@ -218,7 +217,7 @@ int main()
 		glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-		glUseProgram(shaderID); // IMPORTANTE!
+		shader.use(); // IMPORTANTE!
 
 		// Atualiza angulação e rotação
 		float angle = (GLfloat)glfwGetTime();
@@ -230,18 +229,18 @@ int main()
 		else if (rotateZ)
 			model = glm::rotate(model, angle, glm::vec3(0, 0, 1));
 
-		glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-		glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
-		glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
-		glUniform3fv(lightPosLoc, 1, glm::value_ptr(lightPos));
-		glUniform3fv(viewPosLoc, 1, glm::value_ptr(viewPos));
-		glUniform3fv(lightColorLoc, 1, glm::value_ptr(lightColor));
+		shader.setMat4(modelLoc, model);
+		shader.setMat4(viewLoc, view);
+		shader.setMat4(projLoc, projection);
+		shader.setVec3(lightPosLoc, lightPos);
+		shader.setVec3(viewPosLoc, viewPos);
+		shader.setVec3(lightColorLoc, lightColor);
 
 		glActiveTexture(GL_TEXTURE0);
 		glBindTexture(GL_TEXTURE_2D, texID);
 		glBindVertexArray(VAO);
 
-		glDrawArrays(GL_TRIANGLES, 0, vertexCount);
+		glDrawElements(GL_TRIANGLES, (GLsizei)indexCount, GL_UNSIGNED_INT, 0);
 
 		glBindVertexArray(0);
 		glfwSwapBuffers(window);
@@ -249,14 +248,10 @@ int main()
 
 	// Pede pra OpenGL desalocar os buffers
 	glDeleteVertexArrays(1, &VAO);
+	shader.destroy();
 	// Finaliza a execução da GLFW, limpando os recursos alocados por ela
 	glfwTerminate();
 
-	glUseProgram(shaderID);
-	glUniform3fv(lightPosLoc, 1, glm::value_ptr(lightPos));
-	glUniform3fv(viewPosLoc, 1, glm::value_ptr(viewPos));
-	glUniform3fv(lightColorLoc, 1, glm::value_ptr(lightColor));
-
 	return 0;
 }
 
@@ -290,118 +285,17 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
 	}
 }
 
-// Esta função está basntante hardcoded - objetivo é compilar e "buildar" um programa de
-//  shader simples e único neste exemplo de código
-//  O código fonte do vertex e fragment shader está nos arrays vertexShaderSource e
-//  fragmentShader source no iniçio deste arquivo
-//  A função retorna o identificador do programa de shader
-int setupShader()
-{
-	// Vertex shader
-	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-	glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-	glCompileShader(vertexShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	GLint success;
-	GLchar infoLog[512];
-	glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n"
-				  << infoLog << std::endl;
-	}
-	// Fragment shader
-	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-	glCompileShader(fragmentShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n"
-				  << infoLog << std::endl;
-	}
-	// Linkando os shaders e criando o identificador do programa de shader
-	GLuint shaderProgram = glCreateProgram();
-	glAttachShader(shaderProgram, vertexShader);
-	glAttachShader(shaderProgram, fragmentShader);
-	glLinkProgram(shaderProgram);
-	// Checando por erros de linkagem
-	glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-	if (!success)
-	{
-		glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n"
-				  << infoLog << std::endl;
-	}
-	glDeleteShader(vertexShader);
-	glDeleteShader(fragmentShader);
-
-	return shaderProgram;
-}
-
-GLuint loadGeometry(const std::string &objPath, const std::string &mtlPath, const std::string &texFolder, GLuint &outTexID, size_t &outVertexCount)
+GLuint loadGeometry(const std::string &objPath, const std::string &mtlPath, const std::string &texFolder, GLuint &outTexID, size_t &outIndexCount)
 
 {
-	std::vector<glm::vec3> positions;
-	std::vector<glm::vec3> normals;
-	std::vector<glm::vec2> texCoords;
-	std::vector<Vertex> vertices;
-
-	std::ifstream objFile(objPath);
-	std::string line;
-	std::string texFile;
-
-	while (std::getline(objFile, line))
+	ObjMesh mesh;
+	if (!loadOBJ(objPath, mesh))
 	{
-		std::istringstream iss(line);
-		std::string type;
-		iss >> type;
-
-		if (type == "v")
-		{
-			glm::vec3 pos;
-			iss >> pos.x >> pos.y >> pos.z;
-			positions.push_back(pos);
-		}
-		else if (type == "vt")
-		{
-			glm::vec2 uv;
-			iss >> uv.x >> uv.y;
-			texCoords.push_back(uv);
-		}
-		else if (type == "vn")
-		{
-			glm::vec3 norm;
-			iss >> norm.x >> norm.y >> norm.z;
-			normals.push_back(norm);
-		}
-		else if (type == "f")
-		{
-			for (int i = 0; i < 3; i++)
-			{
-				std::string v;
-				iss >> v;
-				std::replace(v.begin(), v.end(), '/', ' ');
-				std::istringstream vss(v);
-				int vi, ti, ni;
-				vss >> vi >> ti >> ni;
-
-				Vertex vert;
-				vert.position = positions[vi - 1];
-				vert.texCoord = texCoords[ti - 1];
-				vert.normal = normals[ni - 1];
-				vertices.push_back(vert);
-			}
-		}
-		else if (type == "mtllib")
-		{
-			iss >> texFile; // assume que mtl e a textura vão ser lidos depois
-		}
+		cerr << "Erro ao abrir OBJ: " << objPath << endl;
+		return 0;
 	}
-	objFile.close();
+	const std::vector<Vertex> &vertices = mesh.vertices;
+	std::string line;
 
 	// carrega .mtl (somente Kd e map_Kd por enquanto)
 	std::ifstream mtlFile(mtlPath);
@@ -423,14 +317,19 @@ GLuint loadGeometry(const std::string &objPath, const std::string &mtlPath, cons
 	outTexID = loadTexture(texFolder + "/" + texName, w, h);
 
 	// Envia para o VBO/VAO
-	GLuint VBO, VAO;
+	GLuint VBO, EBO, VAO;
 	glGenVertexArrays(1, &VAO);
 	glGenBuffers(1, &VBO);
+	glGenBuffers(1, &EBO);
 
 	glBindVertexArray(VAO);
 	glBindBuffer(GL_ARRAY_BUFFER, VBO);
 	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
 
+	// Índices dos triângulos (vértices repetidos foram deduplicados pelo parser)
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.indices.size() * sizeof(uint32_t), mesh.indices.data(), GL_STATIC_DRAW);
+
 	// posição
 	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (GLvoid *)0);
 	glEnableVertexAttribArray(0);
@@ -441,10 +340,11 @@ GLuint loadGeometry(const std::string &objPath, const std::string &mtlPath, cons
 	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (GLvoid *)(offsetof(Vertex, texCoord)));
 	glEnableVertexAttribArray(2);
 
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
 	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
-	outVertexCount = vertices.size();
+	outIndexCount = mesh.indices.size();
 
 	return VAO;
 }
@@ -1,5 +1,11 @@
 #include "Camera.h"
 #include "Camera.cpp"
+#include "ShaderProgram.h"
+#include "ShaderProgram.cpp"
+#include "FrameConstants.h"
+#include "FrameConstants.cpp"
+#include "ObjLoader.h"
+#include "ObjLoader.cpp"
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -19,20 +25,12 @@
 
 using namespace std;
 
-struct Vertex
-{
-	glm::vec3 position;
-	glm::vec3 normal;
-	glm::vec2 texCoord;
-};
-
 Camera *g_camera = nullptr;
 
 void mouse_callback(GLFWwindow *window, double xpos, double ypos);
 void key_callback(GLFWwindow *window, int key, int scancode, int action, int mods);
 
-GLuint setupShader();
-GLuint loadGeometry(const std::string &objPath, const std::string &mtlPath, const std::string &texFolder, GLuint &outTexID, size_t &outVertexCount);
+GLuint loadGeometry(const std::string &objPath, const std::string &mtlPath, const std::string &texFolder, GLuint &outTexID, size_t &outIndexCount);
 GLuint loadTexture(const std::string &filePath, int &width, int &height);
 
 const GLuint WIDTH = 1000, HEIGHT = 1000;
@@ -48,8 +46,6 @@ out vec3 FragPos;
 out vec3 Normal;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
 
 void main()
 {
@@ -69,9 +65,6 @@ in vec2 fragTexCoord;
 
 out vec4 color;
 
-uniform vec3 lightPos;
-uniform vec3 viewPos;
-uniform vec3 lightColor;
 uniform sampler2D texture1;
 
 void main()
@@ -84,9 +77,9 @@ void main()
     vec3 reflectDir = reflect(-lightDir, norm);
     float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32);
 
-    vec3 ambient = 0.3 * texColor;
-    vec3 diffuse = 1.2 * diff * texColor;
-    vec3 specular = 0.8 * spec * lightColor;
+    vec3 ambient = ambientStrength * texColor;
+    vec3 diffuse = diffuseStrength * diff * texColor;
+    vec3 specular = specularStrength * spec * lightColor;
 
     vec3 result = ambient + diffuse + specular;
     color = vec4(result, 1.0);
@@ -124,12 +117,14 @@ int main()
 	glViewport(0, 0, width, height);
 
 	// Setup shader
-	GLuint shaderID = setupShader();
+	ShaderProgram shader;
+	shader.build(vertexShaderSource, fragmentShaderSource, FRAME_CONSTANTS_GLSL);
+	FrameConstants frameConstants;
+	frameConstants.create();
 
 	// Inicializa câmera
 	Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
 	g_camera = &camera;
-	camera.initCamera(shaderID);
 
 	// Callbacks e input
 	glfwSetCursorPosCallback(window, mouse_callback);
@@ -139,27 +134,27 @@ int main()
 	// Carrega modelo OBJ, MTL e textura
 	GLuint VAO;
 	GLuint texID;
-	size_t vertexCount;
-	VAO = loadGeometry("../assets/modelos3D/Suzanne.obj", "../assets/modelos3D/Suzanne.mtl", "../assets/modelos3D", texID, vertexCount);
+	size_t indexCount;
+	VAO = loadGeometry("../assets/modelos3D/Suzanne.obj", "../assets/modelos3D/Suzanne.mtl", "../assets/modelos3D", texID, indexCount);
 
 	glEnable(GL_DEPTH_TEST);
 
 	// Uniform locations
-	GLint modelLoc = glGetUniformLocation(shaderID, "model");
-	GLint viewLoc = glGetUniformLocation(shaderID, "view");
-	GLint projLoc = glGetUniformLocation(shaderID, "projection");
-	GLint lightPosLoc = glGetUniformLocation(shaderID, "lightPos");
-	GLint viewPosLoc = glGetUniformLocation(shaderID, "viewPos");
-	GLint lightColorLoc = glGetUniformLocation(shaderID, "lightColor");
+	GLint modelLoc = shader.location("model");
 
-	// Projeção e view (fixos para simplificar)
-	glm::mat4 projection = glm::perspective(glm::radians(45.0f), float(WIDTH) / float(HEIGHT), 0.1f, 100.0f);
-	glm::mat4 view = glm::lookAt(camera.getPosition(), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	// Constantes do quadro: projeção e luz fixas, câmera atualizada no laço
+	FrameConstantsData frame;
+	frame.projection = glm::perspective(glm::radians(45.0f), float(WIDTH) / float(HEIGHT), 0.1f, 100.0f);
+	frame.lightPos = glm::vec3(1.2f, 1.0f, 2.0f);
+	frame.lightColor = glm::vec3(1.0f, 1.0f, 1.0f);
+	frame.ambientStrength = 0.3f;
+	frame.diffuseStrength = 1.2f;
+	frame.specularStrength = 0.8f;
 
 	// Configura shader e textura
-	glUseProgram(shaderID);
+	shader.use();
 	glBindTexture(GL_TEXTURE_2D, texID);
-	glUniform1i(glGetUniformLocation(shaderID, "texture1"), 0);
+	shader.setInt("texture1", 0);
 
 	// Loop principal
 	while (!glfwWindowShouldClose(window))
@@ -168,15 +163,9 @@ int main()
 		camera.update(window);
 
 		// Atualiza view e posição da câmera
-
-		glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
-		glUniform3fv(viewPosLoc, 1, glm::value_ptr(camera.getPosition()));
-
-		// Luz
-		glm::vec3 lightPos(1.2f, 1.0f, 2.0f);
-		glm::vec3 lightColor(1.0f, 1.0f, 1.0f);
-		glUniform3fv(lightPosLoc, 1, glm::value_ptr(lightPos));
-		glUniform3fv(lightColorLoc, 1, glm::value_ptr(lightColor));
+		frame.view = camera.getViewMatrix();
+		frame.viewPos = camera.getPosition();
+		frameConstants.update(frame);
 
 		// Limpa tela e depth buffer
 		glClearColor(0.9f, 0.9f, 0.9f, 1.0f);
@@ -184,11 +173,11 @@ int main()
 
 		// Matriz model (identidade, pode rotacionar se quiser)
 		glm::mat4 model = glm::mat4(1.0f);
-		glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
+		shader.setMat4(modelLoc, model);
 
 		// Desenha
 		glBindVertexArray(VAO);
-		glDrawArrays(GL_TRIANGLES, 0, (GLsizei)vertexCount);
+		glDrawElements(GL_TRIANGLES, (GLsizei)indexCount, GL_UNSIGNED_INT, 0);
 		glBindVertexArray(0);
 
 		glfwSwapBuffers(window);
@@ -196,7 +185,8 @@ int main()
 
 	// Cleanup
 	glDeleteVertexArrays(1, &VAO);
-	glDeleteProgram(shaderID);
+	frameConstants.destroy();
+	shader.destroy();
 	glfwTerminate();
 
 	return 0;
@@ -216,110 +206,17 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
 		glfwSetWindowShouldClose(window, GL_TRUE);
 }
 
-// Compila e linka shader simples de vértice + fragmento
-GLuint setupShader()
-{
-	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-	glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-	glCompileShader(vertexShader);
-	GLint success;
-	glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		char infoLog[512];
-		glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-		cerr << "Erro vertex shader: " << infoLog << endl;
-	}
-
-	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-	glCompileShader(fragmentShader);
-	glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		char infoLog[512];
-		glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-		cerr << "Erro fragment shader: " << infoLog << endl;
-	}
-
-	GLuint shaderProgram = glCreateProgram();
-	glAttachShader(shaderProgram, vertexShader);
-	glAttachShader(shaderProgram, fragmentShader);
-	glLinkProgram(shaderProgram);
-	glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-	if (!success)
-	{
-		char infoLog[512];
-		glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-		cerr << "Erro link shader: " << infoLog << endl;
-	}
-
-	glDeleteShader(vertexShader);
-	glDeleteShader(fragmentShader);
-
-	return shaderProgram;
-}
-
 // Carrega OBJ + MTL (apenas para map_Kd) e cria VAO
-GLuint loadGeometry(const std::string &objPath, const std::string &mtlPath, const std::string &texFolder, GLuint &outTexID, size_t &outVertexCount)
+GLuint loadGeometry(const std::string &objPath, const std::string &mtlPath, const std::string &texFolder, GLuint &outTexID, size_t &outIndexCount)
 {
-	std::vector<glm::vec3> positions;
-	std::vector<glm::vec3> normals;
-	std::vector<glm::vec2> texCoords;
-	std::vector<Vertex> vertices;
-
-	std::ifstream objFile(objPath);
-	if (!objFile.is_open())
+	ObjMesh mesh;
+	if (!loadOBJ(objPath, mesh))
 	{
 		cerr << "Erro ao abrir OBJ: " << objPath << endl;
 		return 0;
 	}
-
+	const std::vector<Vertex> &vertices = mesh.vertices;
 	std::string line;
-	while (getline(objFile, line))
-	{
-		std::istringstream iss(line);
-		std::string type;
-		iss >> type;
-
-		if (type == "v")
-		{
-			glm::vec3 pos;
-			iss >> pos.x >> pos.y >> pos.z;
-			positions.push_back(pos);
-		}
-		else if (type == "vt")
-		{
-			glm::vec2 uv;
-			iss >> uv.x >> uv.y;
-			texCoords.push_back(uv);
-		}
-		else if (type == "vn")
-		{
-			glm::vec3 norm;
-			iss >> norm.x >> norm.y >> norm.z;
-			normals.push_back(norm);
-		}
-		else if (type == "f")
-		{
-			for (int i = 0; i < 3; i++)
-			{
-				std::string v;
-				iss >> v;
-				std::replace(v.begin(), v.end(), '/', ' ');
-				std::istringstream viss(v);
-				int vi, ti, ni;
-				viss >> vi >> ti >> ni;
-
-				Vertex vert;
-				vert.position = positions[vi - 1];
-				vert.texCoord = texCoords[ti - 1];
-				vert.normal = normals[ni - 1];
-				vertices.push_back(vert);
-			}
-		}
-	}
-	objFile.close();
 
 	// Carrega textura do arquivo MTL (procura map_Kd)
 	std::ifstream mtlFile(mtlPath);
@@ -340,14 +237,19 @@ GLuint loadGeometry(const std::string &objPath, const std::string &mtlPath, cons
 	int w, h;
 	outTexID = loadTexture(texFolder + "/" + texName, w, h);
 
-	GLuint VBO, VAO;
+	GLuint VBO, EBO, VAO;
 	glGenVertexArrays(1, &VAO);
 	glGenBuffers(1, &VBO);
+	glGenBuffers(1, &EBO);
 
 	glBindVertexArray(VAO);
 	glBindBuffer(GL_ARRAY_BUFFER, VBO);
 	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
 
+	// Índices dos triângulos (vértices repetidos foram deduplicados pelo parser)
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.indices.size() * sizeof(uint32_t), mesh.indices.data(), GL_STATIC_DRAW);
+
 	// position (location = 0)
 	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, position));
 	glEnableVertexAttribArray(0);
@@ -360,10 +262,11 @@ GLuint loadGeometry(const std::string &objPath, const std::string &mtlPath, cons
 	glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, normal));
 	glEnableVertexAttribArray(3);
 
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
 	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
-	outVertexCount = vertices.size();
+	outIndexCount = mesh.indices.size();
 
 	return VAO;
 }
@@ -1,11 +1,21 @@
 #include "Camera.h"
 #include "Camera.cpp"
+#include "ShaderProgram.h"
+#include "ShaderProgram.cpp"
+#include "FrameConstants.h"
+#include "FrameConstants.cpp"
+#include "InstanceBuffer.h"
+#include "InstanceBuffer.cpp"
+#include "ObjLoader.h"
+#include "ObjLoader.cpp"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <vector>
 #include <string>
 #include <algorithm>
+#include <numeric>
+#include <tuple>
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -23,7 +33,7 @@ struct AnimatedObject
 {
 	GLuint VAO;
 	GLuint textureID;
-	size_t vertexCount;
+	size_t indexCount;
 	glm::vec3 position;
 	std::vector<glm::vec3> waypoints;
 	int currentWaypoint = 0;
@@ -33,20 +43,12 @@ std::vector<AnimatedObject> objects;
 int selectedObjectIndex = 0;
 bool addWaypointKeyPressed = false;
 
-struct Vertex
-{
-	glm::vec3 position;
-	glm::vec3 normal;
-	glm::vec2 texCoord;
-};
-
 Camera *g_camera = nullptr;
 
 void mouse_callback(GLFWwindow *window, double xpos, double ypos);
 void key_callback(GLFWwindow *window, int key, int scancode, int action, int mods);
 
-GLuint setupShader();
-GLuint loadGeometry(const std::string &objPath, const std::string &mtlPath, const std::string &texFolder, GLuint &outTexID, size_t &outVertexCount);
+GLuint loadGeometry(const std::string &objPath, const std::string &mtlPath, const std::string &texFolder, GLuint &outTexID, size_t &outIndexCount);
 GLuint loadTexture(const std::string &filePath, int &width, int &height);
 
 const GLuint WIDTH = 1000, HEIGHT = 1000;
@@ -70,9 +72,7 @@ out vec2 fragTexCoord;
 out vec3 FragPos;
 out vec3 Normal;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+layout (location = 4) in mat4 model; // por instância (InstanceBuffer)
 
 void main()
 {
@@ -92,9 +92,6 @@ in vec2 fragTexCoord;
 
 out vec4 color;
 
-uniform vec3 lightPos;
-uniform vec3 viewPos;
-uniform vec3 lightColor;
 uniform sampler2D texture1;
 
 void main()
@@ -107,9 +104,9 @@ void main()
     vec3 reflectDir = reflect(-lightDir, norm);
     float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32);
 
-    vec3 ambient = 0.3 * texColor;
-    vec3 diffuse = 1.2 * diff * texColor;
-    vec3 specular = 0.8 * spec * lightColor;
+    vec3 ambient = ambientStrength * texColor;
+    vec3 diffuse = diffuseStrength * diff * texColor;
+    vec3 specular = specularStrength * spec * lightColor;
 
     vec3 result = ambient + diffuse + specular;
     color = vec4(result, 1.0);
@@ -150,12 +147,14 @@ int main()
 	glViewport(0, 0, width, height);
 
 	// Setup shader
-	GLuint shaderID = setupShader();
+	ShaderProgram shader;
+	shader.build(vertexShaderSource, fragmentShaderSource, FRAME_CONSTANTS_GLSL);
+	FrameConstants frameConstants;
+	frameConstants.create();
 
 	// Inicializa câmera
 	Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
 	g_camera = &camera;
-	camera.initCamera(shaderID);
 
 	// Callbacks e input
 	glfwSetCursorPosCallback(window, mouse_callback);
@@ -165,15 +164,15 @@ int main()
 	// Carrega modelo OBJ, MTL e textura
 	GLuint VAO;
 	GLuint texID;
-	size_t vertexCount;
-	VAO = loadGeometry("../assets/modelos3D/Suzanne.obj", "../assets/modelos3D/Suzanne.mtl", "../assets/modelos3D", texID, vertexCount);
+	size_t indexCount;
+	VAO = loadGeometry("../assets/modelos3D/Suzanne.obj", "../assets/modelos3D/Suzanne.mtl", "../assets/modelos3D", texID, indexCount);
 
 	for (int i = 0; i < 3; ++i) // cria 3 objetos para exemplo
 	{
 		AnimatedObject obj;
 		obj.VAO = VAO;
 		obj.textureID = texID;
-		obj.vertexCount = vertexCount;
+		obj.indexCount = indexCount;
 		obj.position = glm::vec3(i * 3.0f, 0.0f, 0.0f); // posições diferentes
 		objects.push_back(obj);
 	}
@@ -181,21 +180,33 @@ int main()
 	glEnable(GL_DEPTH_TEST);
 
 	// Uniform locations
-	GLint modelLoc = glGetUniformLocation(shaderID, "model");
-	GLint viewLoc = glGetUniformLocation(shaderID, "view");
-	GLint projLoc = glGetUniformLocation(shaderID, "projection");
-	GLint lightPosLoc = glGetUniformLocation(shaderID, "lightPos");
-	GLint viewPosLoc = glGetUniformLocation(shaderID, "viewPos");
-	GLint lightColorLoc = glGetUniformLocation(shaderID, "lightColor");
-
-	// Projeção e view (fixos para simplificar)
-	glm::mat4 projection = glm::perspective(glm::radians(45.0f), float(WIDTH) / float(HEIGHT), 0.1f, 100.0f);
-	glm::mat4 view = glm::lookAt(camera.getPosition(), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	// Constantes do quadro: projeção e luz fixas, câmera atualizada no laço
+	FrameConstantsData frame;
+	frame.projection = glm::perspective(glm::radians(45.0f), float(WIDTH) / float(HEIGHT), 0.1f, 100.0f);
+	frame.lightPos = glm::vec3(1.2f, 1.0f, 2.0f);
+	frame.lightColor = glm::vec3(1.0f, 1.0f, 1.0f);
+	frame.ambientStrength = 0.3f;
+	frame.diffuseStrength = 1.2f;
+	frame.specularStrength = 0.8f;
+
+	// Objetos com o mesmo VAO e a mesma textura saem num só draw instanciado;
+	// as matrizes model de cada grupo ficam em sequência no buffer
+	struct Batch
+	{
+		size_t first; // primeira matriz em models
+		GLsizei count;
+		const AnimatedObject *object;
+	};
+	InstanceBuffer instances;
+	instances.create();
+	std::vector<glm::mat4> models;
+	std::vector<Batch> batches;
+	std::vector<size_t> order;
 
 	// Configura shader e textura
-
+	shader.use();
 	glBindTexture(GL_TEXTURE_2D, texID);
-	glUniform1i(glGetUniformLocation(shaderID, "texture1"), 0);
+	shader.setInt("texture1", 0);
 
 	// Loop principal
 	while (!glfwWindowShouldClose(window))
@@ -212,19 +223,12 @@ int main()
 		glClearColor(0.9f, 0.9f, 0.9f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-		glUseProgram(shaderID);
-
-		// Atualiza view e projection
-		glm::mat4 view = camera.getViewMatrix();
-		glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
-		glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
-		glUniform3fv(viewPosLoc, 1, glm::value_ptr(camera.getPosition()));
+		shader.use();
 
-		// Luz
-		glm::vec3 lightPos(1.2f, 1.0f, 2.0f);
-		glm::vec3 lightColor(1.0f, 1.0f, 1.0f);
-		glUniform3fv(lightPosLoc, 1, glm::value_ptr(lightPos));
-		glUniform3fv(lightColorLoc, 1, glm::value_ptr(lightColor));
+		// Atualiza view e posição da câmera
+		frame.view = camera.getViewMatrix();
+		frame.viewPos = camera.getPosition();
+		frameConstants.update(frame);
 
 		// Atualiza posição dos objetos animados
 		for (auto &obj : objects)
@@ -243,17 +247,32 @@ int main()
 			}
 		}
 
-		// Renderiza todos os objetos
-		for (size_t i = 0; i < objects.size(); ++i)
+		// Agrupa os objetos por VAO e textura
+		order.resize(objects.size());
+		std::iota(order.begin(), order.end(), 0);
+		std::stable_sort(order.begin(), order.end(), [](size_t a, size_t b)
+						 { return std::tie(objects[a].VAO, objects[a].textureID) < std::tie(objects[b].VAO, objects[b].textureID); });
+		models.clear();
+		batches.clear();
+		for (size_t i : order)
 		{
 			const auto &obj = objects[i];
 			glm::mat4 model = glm::translate(glm::mat4(1.0f), obj.position);
 			if (i == selectedObjectIndex)
 				model = glm::scale(model, glm::vec3(1.2f));
-			glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-			glBindTexture(GL_TEXTURE_2D, obj.textureID);
-			glBindVertexArray(obj.VAO);
-			glDrawArrays(GL_TRIANGLES, 0, (GLsizei)obj.vertexCount);
+			if (batches.empty() || batches.back().object->VAO != obj.VAO || batches.back().object->textureID != obj.textureID)
+				batches.push_back({models.size(), 0, &obj});
+			models.push_back(model);
+			++batches.back().count;
+		}
+		instances.upload(models.data(), models.size());
+
+		// Renderiza todos os objetos: um draw por grupo
+		for (const Batch &batch : batches)
+		{
+			glBindTexture(GL_TEXTURE_2D, batch.object->textureID);
+			instances.attach(batch.object->VAO, 4, batch.first);
+			glDrawElementsInstanced(GL_TRIANGLES, (GLsizei)batch.object->indexCount, GL_UNSIGNED_INT, 0, batch.count);
 			glBindVertexArray(0);
 		}
 
@@ -262,7 +281,9 @@ int main()
 
 	// Cleanup
 	glDeleteVertexArrays(1, &VAO);
-	glDeleteProgram(shaderID);
+	instances.destroy();
+	frameConstants.destroy();
+	shader.destroy();
 	glfwTerminate();
 
 	return 0;
@@ -317,110 +338,17 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
 	}
 }
 
-// Compila e linka shader simples de vértice + fragmento
-GLuint setupShader()
-{
-	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-	glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-	glCompileShader(vertexShader);
-	GLint success;
-	glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		char infoLog[512];
-		glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-		cerr << "Erro vertex shader: " << infoLog << endl;
-	}
-
-	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-	glCompileShader(fragmentShader);
-	glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		char infoLog[512];
-		glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-		cerr << "Erro fragment shader: " << infoLog << endl;
-	}
-
-	GLuint shaderProgram = glCreateProgram();
-	glAttachShader(shaderProgram, vertexShader);
-	glAttachShader(shaderProgram, fragmentShader);
-	glLinkProgram(shaderProgram);
-	glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-	if (!success)
-	{
-		char infoLog[512];
-		glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-		cerr << "Erro link shader: " << infoLog << endl;
-	}
-
-	glDeleteShader(vertexShader);
-	glDeleteShader(fragmentShader);
-
-	return shaderProgram;
-}
-
 // Carrega OBJ + MTL (apenas para map_Kd) e cria VAO
-GLuint loadGeometry(const std::string &objPath, const std::string &mtlPath, const std::string &texFolder, GLuint &outTexID, size_t &outVertexCount)
+GLuint loadGeometry(const std::string &objPath, const std::string &mtlPath, const std::string &texFolder, GLuint &outTexID, size_t &outIndexCount)
 {
-	std::vector<glm::vec3> positions;
-	std::vector<glm::vec3> normals;
-	std::vector<glm::vec2> texCoords;
-	std::vector<Vertex> vertices;
-
-	std::ifstream objFile(objPath);
-	if (!objFile.is_open())
+	ObjMesh mesh;
+	if (!loadOBJ(objPath, mesh))
 	{
 		cerr << "Erro ao abrir OBJ: " << objPath << endl;
 		return 0;
 	}
-
+	const std::vector<Vertex> &vertices = mesh.vertices;
 	std::string line;
-	while (getline(objFile, line))
-	{
-		std::istringstream iss(line);
-		std::string type;
-		iss >> type;
-
-		if (type == "v")
-		{
-			glm::vec3 pos;
-			iss >> pos.x >> pos.y >> pos.z;
-			positions.push_back(pos);
-		}
-		else if (type == "vt")
-		{
-			glm::vec2 uv;
-			iss >> uv.x >> uv.y;
-			texCoords.push_back(uv);
-		}
-		else if (type == "vn")
-		{
-			glm::vec3 norm;
-			iss >> norm.x >> norm.y >> norm.z;
-			normals.push_back(norm);
-		}
-		else if (type == "f")
-		{
-			for (int i = 0; i < 3; i++)
-			{
-				std::string v;
-				iss >> v;
-				std::replace(v.begin(), v.end(), '/', ' ');
-				std::istringstream viss(v);
-				int vi, ti, ni;
-				viss >> vi >> ti >> ni;
-
-				Vertex vert;
-				vert.position = positions[vi - 1];
-				vert.texCoord = texCoords[ti - 1];
-				vert.normal = normals[ni - 1];
-				vertices.push_back(vert);
-			}
-		}
-	}
-	objFile.close();
 
 	// Carrega textura do arquivo MTL (procura map_Kd)
 	std::ifstream mtlFile(mtlPath);
@@ -441,14 +369,19 @@ GLuint loadGeometry(const std::string &objPath, const std::string &mtlPath, cons
 	int w, h;
 	outTexID = loadTexture(texFolder + "/" + texName, w, h);
 
-	GLuint VBO, VAO;
+	GLuint VBO, EBO, VAO;
 	glGenVertexArrays(1, &VAO);
 	glGenBuffers(1, &VBO);
+	glGenBuffers(1, &EBO);
 
 	glBindVertexArray(VAO);
 	glBindBuffer(GL_ARRAY_BUFFER, VBO);
 	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
 
+	// Índices dos triângulos (vértices repetidos foram deduplicados pelo parser)
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.indices.size() * sizeof(uint32_t), mesh.indices.data(), GL_STATIC_DRAW);
+
 	// position (location = 0)
 	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, position));
 	glEnableVertexAttribArray(0);
@@ -461,10 +394,11 @@ GLuint loadGeometry(const std::string &objPath, const std::string &mtlPath, cons
 	glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, normal));
 	glEnableVertexAttribArray(3);
 
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
 	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
-	outVertexCount = vertices.size();
+	outIndexCount = mesh.indices.size();
 
 	return VAO;
 }
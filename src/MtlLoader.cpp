@@ -0,0 +1,74 @@
+#include "MtlLoader.h"
+#include "ObjLoader.h"
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+bool loadMaterialLibrary(const std::string &mtlPath, std::vector<Material> &outMaterials)
+{
+    outMaterials.clear();
+    MappedFile mtlFile(mtlPath);
+    if (!mtlFile.isOpen())
+    {
+        std::cerr << "Erro ao abrir MTL: " << mtlPath << std::endl;
+        return false;
+    }
+    parseMaterialLibrary(mtlFile.data(), mtlFile.size(), outMaterials);
+    return true;
+}
+
+void parseMaterialLibrary(const char *data, size_t size, std::vector<Material> &outMaterials)
+{
+    outMaterials.clear();
+    const char *cursor = data;
+    const char *end = data + size;
+    while (cursor < end)
+    {
+        const char *newline = (const char *)memchr(cursor, '\n', end - cursor);
+        const char *lineEnd = newline ? newline : end;
+        std::istringstream iss(std::string(cursor, lineEnd));
+        cursor = lineEnd + 1;
+
+        std::string type;
+        iss >> type;
+        if (type.empty() || type[0] == '#')
+            continue;
+
+        if (type == "newmtl")
+        {
+            // o nome vai até o fim da linha, como no usemtl do .obj
+            std::string &name = outMaterials.emplace_back().name;
+            getline(iss >> std::ws, name);
+            while (!name.empty() && (name.back() == ' ' || name.back() == '\t' || name.back() == '\r'))
+                name.pop_back();
+            continue;
+        }
+        // chaves antes do primeiro newmtl vão para um material sem nome
+        if (outMaterials.empty())
+            outMaterials.emplace_back();
+        Material &mat = outMaterials.back();
+
+        if (type == "Ka")
+            iss >> mat.Ka.r >> mat.Ka.g >> mat.Ka.b;
+        else if (type == "Kd")
+            iss >> mat.Kd.r >> mat.Kd.g >> mat.Kd.b;
+        else if (type == "Ks")
+            iss >> mat.Ks.r >> mat.Ks.g >> mat.Ks.b;
+        else if (type == "Ns")
+            iss >> mat.Ns;
+        else if (type == "map_Kd")
+            iss >> mat.map_Kd;
+        else if (type == "map_Bump" || type == "bump")
+            iss >> mat.map_Bump;
+        else if (type == "map_Ks")
+            iss >> mat.map_Ks;
+    }
+}
+
+int findMaterial(const std::vector<Material> &materials, const std::string &name)
+{
+    for (size_t i = 0; i < materials.size(); ++i)
+        if (materials[i].name == name)
+            return (int)i;
+    return -1;
+}
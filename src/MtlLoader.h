@@ -0,0 +1,27 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Material de um .mtl (modelo de Phong usado pelos shaders)
+struct Material
+{
+    std::string name;
+    glm::vec3 Ka = glm::vec3(1.0f);
+    glm::vec3 Kd = glm::vec3(1.0f);
+    glm::vec3 Ks = glm::vec3(1.0f);
+    float Ns = 32.0f;
+    std::string map_Kd; // caminhos relativos ao .mtl
+    std::string map_Bump;
+    std::string map_Ks;
+};
+
+// Lê todos os newmtl da biblioteca, na ordem do arquivo; false se não abrir
+bool loadMaterialLibrary(const std::string &mtlPath, std::vector<Material> &outMaterials);
+
+// O mesmo a partir do conteúdo do arquivo já em memória (entrada de AssetPack)
+void parseMaterialLibrary(const char *data, size_t size, std::vector<Material> &outMaterials);
+
+// Índice do material com esse nome ou -1
+int findMaterial(const std::vector<Material> &materials, const std::string &name);
@@ -0,0 +1,872 @@
+#include "ObjLoader.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <unordered_map>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+{
+    *this = std::move(other);
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+{
+    if (this != &other)
+    {
+        close();
+        m_data = other.m_data;
+        m_size = other.m_size;
+        m_open = other.m_open;
+#ifdef _WIN32
+        m_file = other.m_file;
+        m_mapping = other.m_mapping;
+        other.m_file = nullptr;
+        other.m_mapping = nullptr;
+#endif
+        other.m_data = nullptr;
+        other.m_size = 0;
+        other.m_open = false;
+    }
+    return *this;
+}
+
+bool MappedFile::open(const std::string &path)
+{
+    close();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize))
+    {
+        CloseHandle(file);
+        return false;
+    }
+    m_file = file;
+    m_size = (size_t)fileSize.QuadPart;
+    m_open = true;
+    if (m_size == 0) // arquivo vazio não pode ser mapeado
+        return true;
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping)
+    {
+        close();
+        return false;
+    }
+    m_mapping = mapping;
+    m_data = (const char *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!m_data)
+    {
+        close();
+        return false;
+    }
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    m_size = (size_t)st.st_size;
+    m_open = true;
+    if (m_size > 0)
+    {
+        void *ptr = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (ptr == MAP_FAILED)
+        {
+            ::close(fd);
+            m_size = 0;
+            m_open = false;
+            return false;
+        }
+        madvise(ptr, m_size, MADV_SEQUENTIAL);
+        m_data = (const char *)ptr;
+    }
+    // o mapeamento continua válido depois de fechar o descritor
+    ::close(fd);
+#endif
+    return true;
+}
+
+void MappedFile::close()
+{
+#ifdef _WIN32
+    if (m_data)
+        UnmapViewOfFile(m_data);
+    if (m_mapping)
+        CloseHandle((HANDLE)m_mapping);
+    if (m_file)
+        CloseHandle((HANDLE)m_file);
+    m_mapping = nullptr;
+    m_file = nullptr;
+#else
+    if (m_data)
+        munmap((void *)m_data, m_size);
+#endif
+    m_data = nullptr;
+    m_size = 0;
+    m_open = false;
+}
+
+// ---------------------------------------------------------------------------
+// Tokenização in-place: todas as funções avançam o ponteiro p até no máximo end
+
+static inline bool isBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static inline const char *skipBlanks(const char *p, const char *end)
+{
+    while (p < end && isBlank(*p))
+        ++p;
+    return p;
+}
+
+static inline const char *skipLine(const char *p, const char *end)
+{
+    const char *nl = (const char *)memchr(p, '\n', end - p);
+    return nl ? nl + 1 : end;
+}
+
+static inline const char *parseFloat(const char *p, const char *end, float &out)
+{
+    p = skipBlanks(p, end);
+    if (p < end && *p == '+') // from_chars não aceita '+'
+        ++p;
+#if defined(__cpp_lib_to_chars)
+    std::from_chars_result res = std::from_chars(p, end, out);
+    if (res.ec != std::errc())
+        out = 0.0f;
+    return res.ptr;
+#else
+    // Fallback sem from_chars de ponto flutuante: copia o token para a pilha
+    char buf[64];
+    size_t n = 0;
+    while (p + n < end && n < sizeof(buf) - 1 && !isBlank(p[n]) && p[n] != '\n')
+        ++n;
+    memcpy(buf, p, n);
+    buf[n] = '\0';
+    char *stop = nullptr;
+    out = strtof(buf, &stop);
+    return p + (stop - buf);
+#endif
+}
+
+static inline const char *parseInt(const char *p, const char *end, int &out)
+{
+    if (p < end && *p == '+')
+        ++p;
+    std::from_chars_result res = std::from_chars(p, end, out);
+    if (res.ec != std::errc())
+        out = 0;
+    return res.ptr;
+}
+
+// Lê um canto de face (v, v/vt, v//vn ou v/vt/vn); índices ausentes ficam 0
+static inline const char *parseCorner(const char *p, const char *end, int &vi, int &ti, int &ni)
+{
+    vi = ti = ni = 0;
+    p = parseInt(p, end, vi);
+    if (p < end && *p == '/')
+    {
+        ++p;
+        if (p < end && *p != '/')
+            p = parseInt(p, end, ti);
+        if (p < end && *p == '/')
+        {
+            ++p;
+            p = parseInt(p, end, ni);
+        }
+    }
+    // token inesperado: pula até o próximo separador
+    while (p < end && !isBlank(*p) && *p != '\n')
+        ++p;
+    return p;
+}
+
+// Converte índice do .obj (base 1, negativo = relativo ao fim) para base 0; -1 se ausente/inválido
+static inline int resolveIndex(int idx, size_t count)
+{
+    if (idx > 0)
+        return (size_t)idx <= count ? idx - 1 : -1;
+    if (idx < 0)
+        return (size_t)(-idx) <= count ? (int)count + idx : -1;
+    return -1;
+}
+
+// Chave de deduplicação: índices já resolvidos (base 0, -1 = ausente)
+struct CornerKey
+{
+    int v, t, n;
+    bool operator==(const CornerKey &o) const { return v == o.v && t == o.t && n == o.n; }
+};
+
+struct CornerKeyHash
+{
+    size_t operator()(const CornerKey &k) const
+    {
+        uint64_t h = (uint64_t)(uint32_t)k.v * 0x9E3779B97F4A7C15ull;
+        h ^= (uint64_t)(uint32_t)k.t * 0xC2B2AE3D27D4EB4Full + (h << 6) + (h >> 2);
+        h ^= (uint64_t)(uint32_t)k.n * 0x165667B19E3779F9ull + (h << 6) + (h >> 2);
+        return (size_t)h;
+    }
+};
+
+static inline Vertex makeVertex(const CornerKey &ck, const std::vector<glm::vec3> &positions,
+                                const std::vector<glm::vec3> &normals, const std::vector<glm::vec2> &texCoords)
+{
+    Vertex vert;
+    vert.position = positions[ck.v];
+    vert.texCoord = ck.t >= 0 ? texCoords[ck.t] : glm::vec2(0.0f);
+    vert.normal = ck.n >= 0 ? normals[ck.n] : glm::vec3(0.0f);
+    return vert;
+}
+
+// Resto da linha sem os brancos das pontas (nomes de usemtl/mtllib)
+static inline const char *parseName(const char *p, const char *end, std::string &out)
+{
+    p = skipBlanks(p, end);
+    const char *nameEnd = std::find(p, end, '\n');
+    const char *last = nameEnd;
+    while (last > p && isBlank(last[-1]))
+        --last;
+    out.assign(p, last);
+    return nameEnd;
+}
+
+static uint32_t findOrAddName(std::vector<std::string> &names, const std::string &name)
+{
+    for (size_t i = 0; i < names.size(); ++i)
+        if (names[i] == name)
+            return (uint32_t)i;
+    names.push_back(name);
+    return (uint32_t)names.size() - 1;
+}
+
+// A partir de firstIndex os triângulos usam material (índice na tabela de nomes do parser)
+struct ObjMaterialRun
+{
+    uint32_t material;
+    uint32_t firstIndex;
+};
+
+static const uint32_t OBJ_NO_MATERIAL = 0xFFFFFFFF;      // faces antes do primeiro usemtl
+static const uint32_t OBJ_INHERIT_MATERIAL = 0xFFFFFFFE; // fatia paralela: material da fatia anterior
+
+static inline void addMaterialRun(std::vector<ObjMaterialRun> &runs, uint32_t material, size_t firstIndex)
+{
+    if (runs.empty() || runs.back().material != material)
+        runs.push_back({material, (uint32_t)firstIndex});
+}
+
+// Etapa final comum aos parsers serial e paralelo: agrupa os triângulos por
+// material (ordem estável) e cria um submesh para cada um
+static void finishMesh(ObjMesh &mesh, size_t skippedFaces, const std::vector<ObjMaterialRun> &runs,
+                       const std::vector<std::string> &names)
+{
+    if (skippedFaces > 0)
+        std::cerr << "Aviso: " << skippedFaces << " faces com indices invalidos ignoradas" << std::endl;
+
+    // materiais numerados pela primeira face que os usa; o último slot é "sem usemtl"
+    std::vector<uint32_t> materialOf(names.size() + 1, OBJ_NO_MATERIAL);
+    std::vector<uint32_t> runMaterial(runs.size());
+    std::vector<uint32_t> counts;
+    mesh.materials.clear();
+    for (size_t r = 0; r < runs.size(); ++r)
+    {
+        size_t slot = runs[r].material == OBJ_NO_MATERIAL ? names.size() : runs[r].material;
+        if (materialOf[slot] == OBJ_NO_MATERIAL)
+        {
+            materialOf[slot] = (uint32_t)mesh.materials.size();
+            mesh.materials.push_back(slot < names.size() ? names[slot] : std::string());
+            counts.push_back(0);
+        }
+        runMaterial[r] = materialOf[slot];
+        uint32_t runEnd = r + 1 < runs.size() ? runs[r + 1].firstIndex : (uint32_t)mesh.indices.size();
+        counts[runMaterial[r]] += runEnd - runs[r].firstIndex;
+    }
+    if (mesh.materials.empty())
+    {
+        mesh.materials.push_back(std::string());
+        counts.push_back(0);
+    }
+
+    std::vector<uint32_t> offsets(counts.size(), 0);
+    for (size_t m = 1; m < counts.size(); ++m)
+        offsets[m] = offsets[m - 1] + counts[m - 1];
+
+    // materiais intercalados no arquivo: copia cada faixa para o bloco do seu material
+    if (mesh.materials.size() > 1)
+    {
+        std::vector<uint32_t> sorted(mesh.indices.size());
+        std::vector<uint32_t> fill(offsets);
+        for (size_t r = 0; r < runs.size(); ++r)
+        {
+            uint32_t runEnd = r + 1 < runs.size() ? runs[r + 1].firstIndex : (uint32_t)mesh.indices.size();
+            std::copy(mesh.indices.begin() + runs[r].firstIndex, mesh.indices.begin() + runEnd,
+                      sorted.begin() + fill[runMaterial[r]]);
+            fill[runMaterial[r]] += runEnd - runs[r].firstIndex;
+        }
+        mesh.indices.swap(sorted);
+    }
+
+    mesh.submeshes.clear();
+    for (size_t m = 0; m < counts.size(); ++m)
+    {
+        Submesh sub;
+        sub.firstIndex = offsets[m];
+        sub.indexCount = counts[m];
+        sub.material = (uint32_t)m;
+        mesh.submeshes.push_back(sub);
+    }
+    MeshLod base = {0, 0, (uint32_t)mesh.indices.size(), 0.0f, 0, 0};
+    mesh.lods.assign(1, base);
+    computeBounds(mesh);
+}
+
+bool parseOBJ(const char *data, size_t size, ObjMesh &outMesh)
+{
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> normals;
+    std::vector<glm::vec2> texCoords;
+
+    // Estimativa grosseira (~30 bytes por linha) para evitar realocações
+    positions.reserve(size / 64);
+    normals.reserve(size / 64);
+    texCoords.reserve(size / 64);
+    outMesh.vertices.clear();
+    outMesh.indices.clear();
+    outMesh.vertices.reserve(size / 64);
+    outMesh.indices.reserve(size / 16);
+
+    std::unordered_map<CornerKey, uint32_t, CornerKeyHash> cornerMap;
+    cornerMap.reserve(size / 64);
+
+    std::vector<std::string> materialNames;
+    std::vector<ObjMaterialRun> runs;
+    uint32_t currentMaterial = OBJ_NO_MATERIAL;
+    std::string name;
+    outMesh.materialLibrary.clear();
+
+    size_t skippedFaces = 0;
+    const char *p = data;
+    const char *end = data + size;
+
+    while (p < end)
+    {
+        p = skipBlanks(p, end);
+        if (p >= end)
+            break;
+
+        const char *key = p;
+        while (p < end && !isBlank(*p) && *p != '\n')
+            ++p;
+        size_t keyLen = p - key;
+
+        if (keyLen == 1 && key[0] == 'v')
+        {
+            glm::vec3 pos;
+            p = parseFloat(p, end, pos.x);
+            p = parseFloat(p, end, pos.y);
+            p = parseFloat(p, end, pos.z);
+            positions.push_back(pos);
+        }
+        else if (keyLen == 2 && key[0] == 'v' && key[1] == 't')
+        {
+            glm::vec2 uv;
+            p = parseFloat(p, end, uv.x);
+            p = parseFloat(p, end, uv.y);
+            texCoords.push_back(uv);
+        }
+        else if (keyLen == 2 && key[0] == 'v' && key[1] == 'n')
+        {
+            glm::vec3 norm;
+            p = parseFloat(p, end, norm.x);
+            p = parseFloat(p, end, norm.y);
+            p = parseFloat(p, end, norm.z);
+            normals.push_back(norm);
+        }
+        else if (keyLen == 1 && key[0] == 'f')
+        {
+            // Cada canto é v, v/vt, v//vn ou v/vt/vn; polígono vira leque de triângulos
+            uint32_t first = 0, prev = 0;
+            int corner = 0;
+            bool valid = true;
+            size_t faceStart = outMesh.indices.size();
+
+            while (true)
+            {
+                p = skipBlanks(p, end);
+                if (p >= end || *p == '\n' || *p == '#')
+                    break;
+
+                int vi, ti, ni;
+                p = parseCorner(p, end, vi, ti, ni);
+
+                CornerKey ck;
+                ck.v = resolveIndex(vi, positions.size());
+                ck.t = resolveIndex(ti, texCoords.size());
+                ck.n = resolveIndex(ni, normals.size());
+                if (ck.v < 0)
+                {
+                    valid = false;
+                    continue;
+                }
+
+                auto inserted = cornerMap.try_emplace(ck, (uint32_t)outMesh.vertices.size());
+                if (inserted.second)
+                    outMesh.vertices.push_back(makeVertex(ck, positions, normals, texCoords));
+                uint32_t index = inserted.first->second;
+
+                if (corner == 0)
+                    first = index;
+                else if (corner >= 2)
+                {
+                    outMesh.indices.push_back(first);
+                    outMesh.indices.push_back(prev);
+                    outMesh.indices.push_back(index);
+                }
+                prev = index;
+                ++corner;
+            }
+
+            // vértices já criados por uma face inválida ficam sem uso, mas são inofensivos
+            if (!valid)
+            {
+                outMesh.indices.resize(faceStart);
+                ++skippedFaces;
+            }
+            else if (outMesh.indices.size() > faceStart)
+                addMaterialRun(runs, currentMaterial, faceStart);
+        }
+        else if (keyLen == 6 && memcmp(key, "usemtl", 6) == 0)
+        {
+            p = parseName(p, end, name);
+            currentMaterial = findOrAddName(materialNames, name);
+        }
+        else if (keyLen == 6 && memcmp(key, "mtllib", 6) == 0)
+        {
+            p = parseName(p, end, name);
+            if (outMesh.materialLibrary.empty())
+                outMesh.materialLibrary = name;
+        }
+
+        p = skipLine(p, end);
+    }
+
+    finishMesh(outMesh, skippedFaces, runs, materialNames);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Parser paralelo
+//
+// 1. O arquivo é dividido em fatias que terminam em '\n' e cada thread lê a sua
+//    guardando v/vt/vn e os índices crus das faces (junto com quantos v/vt/vn a
+//    fatia já tinha lido naquela face, para resolver índices como o serial faz).
+// 2. Soma de prefixos das contagens dá o deslocamento global de cada fatia; cada
+//    thread copia seus atributos para o array global, resolve os índices e
+//    deduplica localmente os cantos, na ordem em que aparecem.
+// 3. Uma passada serial junta as listas de cantos únicos fatia por fatia, o que
+//    reproduz exatamente a numeração de primeira ocorrência do parser serial.
+// 4. Cada thread traduz seus índices locais para os globais.
+// 5. As trocas de material (usemtl) de cada fatia são juntadas em série; faces
+//    antes do primeiro usemtl da fatia herdam o material da fatia anterior.
+
+struct ObjFaceRecord
+{
+    uint32_t firstCorner;
+    uint32_t cornerCount;
+    uint32_t material; // índice em ObjChunk::materialNames ou OBJ_INHERIT_MATERIAL
+    uint32_t positionCount; // v/vt/vn lidos pela fatia antes desta face
+    uint32_t texCoordCount;
+    uint32_t normalCount;
+};
+
+struct ObjRawCorner
+{
+    int v, t, n;
+};
+
+struct ObjChunk
+{
+    const char *begin = nullptr;
+    const char *end = nullptr;
+
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> normals;
+    std::vector<glm::vec2> texCoords;
+    std::vector<ObjRawCorner> corners;
+    std::vector<ObjFaceRecord> faces;
+    std::vector<std::string> materialNames;
+    uint32_t currentMaterial = OBJ_INHERIT_MATERIAL; // material em vigor no fim da fatia
+    std::string materialLibrary;
+
+    size_t positionBase = 0, texCoordBase = 0, normalBase = 0, indexBase = 0;
+    std::vector<CornerKey> uniqueCorners;
+    std::vector<uint32_t> localIndices;
+    std::vector<uint32_t> remap;
+    std::vector<ObjMaterialRun> runs; // firstIndex relativo a localIndices
+    size_t skippedFaces = 0;
+};
+
+static void parseChunk(ObjChunk &chunk)
+{
+    const char *p = chunk.begin;
+    const char *end = chunk.end;
+    size_t bytes = end - p;
+    chunk.positions.reserve(bytes / 64);
+    chunk.normals.reserve(bytes / 64);
+    chunk.texCoords.reserve(bytes / 64);
+    chunk.corners.reserve(bytes / 16);
+    chunk.faces.reserve(bytes / 48);
+    std::string name;
+
+    while (p < end)
+    {
+        p = skipBlanks(p, end);
+        if (p >= end)
+            break;
+
+        const char *key = p;
+        while (p < end && !isBlank(*p) && *p != '\n')
+            ++p;
+        size_t keyLen = p - key;
+
+        if (keyLen == 1 && key[0] == 'v')
+        {
+            glm::vec3 pos;
+            p = parseFloat(p, end, pos.x);
+            p = parseFloat(p, end, pos.y);
+            p = parseFloat(p, end, pos.z);
+            chunk.positions.push_back(pos);
+        }
+        else if (keyLen == 2 && key[0] == 'v' && key[1] == 't')
+        {
+            glm::vec2 uv;
+            p = parseFloat(p, end, uv.x);
+            p = parseFloat(p, end, uv.y);
+            chunk.texCoords.push_back(uv);
+        }
+        else if (keyLen == 2 && key[0] == 'v' && key[1] == 'n')
+        {
+            glm::vec3 norm;
+            p = parseFloat(p, end, norm.x);
+            p = parseFloat(p, end, norm.y);
+            p = parseFloat(p, end, norm.z);
+            chunk.normals.push_back(norm);
+        }
+        else if (keyLen == 1 && key[0] == 'f')
+        {
+            ObjFaceRecord face;
+            face.firstCorner = (uint32_t)chunk.corners.size();
+            face.material = chunk.currentMaterial;
+            face.positionCount = (uint32_t)chunk.positions.size();
+            face.texCoordCount = (uint32_t)chunk.texCoords.size();
+            face.normalCount = (uint32_t)chunk.normals.size();
+            while (true)
+            {
+                p = skipBlanks(p, end);
+                if (p >= end || *p == '\n' || *p == '#')
+                    break;
+                ObjRawCorner corner;
+                p = parseCorner(p, end, corner.v, corner.t, corner.n);
+                chunk.corners.push_back(corner);
+            }
+            face.cornerCount = (uint32_t)chunk.corners.size() - face.firstCorner;
+            chunk.faces.push_back(face);
+        }
+        else if (keyLen == 6 && memcmp(key, "usemtl", 6) == 0)
+        {
+            p = parseName(p, end, name);
+            chunk.currentMaterial = findOrAddName(chunk.materialNames, name);
+        }
+        else if (keyLen == 6 && memcmp(key, "mtllib", 6) == 0)
+        {
+            p = parseName(p, end, name);
+            if (chunk.materialLibrary.empty())
+                chunk.materialLibrary = name;
+        }
+
+        p = skipLine(p, end);
+    }
+}
+
+// Resolve e deduplica os cantos da fatia com as mesmas regras do parser serial
+static void resolveChunk(ObjChunk &chunk)
+{
+    std::unordered_map<CornerKey, uint32_t, CornerKeyHash> cornerMap;
+    cornerMap.reserve(chunk.corners.size() / 3);
+    chunk.localIndices.reserve(chunk.corners.size());
+
+    for (const ObjFaceRecord &face : chunk.faces)
+    {
+        size_t positionCount = chunk.positionBase + face.positionCount;
+        size_t texCoordCount = chunk.texCoordBase + face.texCoordCount;
+        size_t normalCount = chunk.normalBase + face.normalCount;
+
+        uint32_t first = 0, prev = 0;
+        int corner = 0;
+        bool valid = true;
+        size_t faceStart = chunk.localIndices.size();
+
+        for (uint32_t c = 0; c < face.cornerCount; ++c)
+        {
+            const ObjRawCorner &raw = chunk.corners[face.firstCorner + c];
+            CornerKey ck;
+            ck.v = resolveIndex(raw.v, positionCount);
+            ck.t = resolveIndex(raw.t, texCoordCount);
+            ck.n = resolveIndex(raw.n, normalCount);
+            if (ck.v < 0)
+            {
+                valid = false;
+                continue;
+            }
+
+            auto inserted = cornerMap.try_emplace(ck, (uint32_t)chunk.uniqueCorners.size());
+            if (inserted.second)
+                chunk.uniqueCorners.push_back(ck);
+            uint32_t index = inserted.first->second;
+
+            if (corner == 0)
+                first = index;
+            else if (corner >= 2)
+            {
+                chunk.localIndices.push_back(first);
+                chunk.localIndices.push_back(prev);
+                chunk.localIndices.push_back(index);
+            }
+            prev = index;
+            ++corner;
+        }
+
+        if (!valid)
+        {
+            chunk.localIndices.resize(faceStart);
+            ++chunk.skippedFaces;
+        }
+        else if (chunk.localIndices.size() > faceStart)
+            addMaterialRun(chunk.runs, face.material, faceStart);
+    }
+}
+
+// Executa fn(i) para i em [0, count), uma thread por item (o item 0 roda na thread atual)
+template <typename Fn>
+static void runParallel(size_t count, Fn fn)
+{
+    std::vector<std::thread> threads;
+    threads.reserve(count);
+    for (size_t i = 1; i < count; ++i)
+        threads.emplace_back(fn, i);
+    fn(0);
+    for (std::thread &t : threads)
+        t.join();
+}
+
+bool parseOBJParallel(const char *data, size_t size, ObjMesh &outMesh, unsigned threadCount)
+{
+    if (threadCount <= 1 || size == 0)
+        return parseOBJ(data, size, outMesh);
+
+    // Fatias de tamanho parecido, sempre começando no início de uma linha
+    std::vector<ObjChunk> chunks(threadCount);
+    const char *end = data + size;
+    const char *cursor = data;
+    for (unsigned i = 0; i < threadCount; ++i)
+    {
+        const char *target = i + 1 == threadCount ? end : data + size * (i + 1) / threadCount;
+        if (target < cursor)
+            target = cursor;
+        if (target < end)
+            target = skipLine(target, end);
+        chunks[i].begin = cursor;
+        chunks[i].end = target;
+        cursor = target;
+    }
+
+    runParallel(chunks.size(), [&](size_t i)
+                { parseChunk(chunks[i]); });
+
+    // Soma de prefixos: deslocamento global dos atributos de cada fatia
+    size_t positionTotal = 0, texCoordTotal = 0, normalTotal = 0;
+    for (ObjChunk &chunk : chunks)
+    {
+        chunk.positionBase = positionTotal;
+        chunk.texCoordBase = texCoordTotal;
+        chunk.normalBase = normalTotal;
+        positionTotal += chunk.positions.size();
+        texCoordTotal += chunk.texCoords.size();
+        normalTotal += chunk.normals.size();
+    }
+
+    std::vector<glm::vec3> positions(positionTotal);
+    std::vector<glm::vec2> texCoords(texCoordTotal);
+    std::vector<glm::vec3> normals(normalTotal);
+    runParallel(chunks.size(), [&](size_t i)
+                {
+                    ObjChunk &chunk = chunks[i];
+                    std::copy(chunk.positions.begin(), chunk.positions.end(), positions.begin() + chunk.positionBase);
+                    std::copy(chunk.texCoords.begin(), chunk.texCoords.end(), texCoords.begin() + chunk.texCoordBase);
+                    std::copy(chunk.normals.begin(), chunk.normals.end(), normals.begin() + chunk.normalBase);
+                    resolveChunk(chunk); });
+
+    // Junção serial: numera os cantos únicos na ordem da primeira ocorrência
+    outMesh.vertices.clear();
+    outMesh.indices.clear();
+    std::unordered_map<CornerKey, uint32_t, CornerKeyHash> cornerMap;
+    size_t uniqueTotal = 0, indexTotal = 0, skippedFaces = 0;
+    for (ObjChunk &chunk : chunks)
+    {
+        uniqueTotal += chunk.uniqueCorners.size();
+        chunk.indexBase = indexTotal;
+        indexTotal += chunk.localIndices.size();
+        skippedFaces += chunk.skippedFaces;
+    }
+    cornerMap.reserve(uniqueTotal);
+    outMesh.vertices.reserve(uniqueTotal);
+    for (ObjChunk &chunk : chunks)
+    {
+        chunk.remap.resize(chunk.uniqueCorners.size());
+        for (size_t u = 0; u < chunk.uniqueCorners.size(); ++u)
+        {
+            const CornerKey &ck = chunk.uniqueCorners[u];
+            auto inserted = cornerMap.try_emplace(ck, (uint32_t)outMesh.vertices.size());
+            if (inserted.second)
+                outMesh.vertices.push_back(makeVertex(ck, positions, normals, texCoords));
+            chunk.remap[u] = inserted.first->second;
+        }
+    }
+
+    outMesh.indices.resize(indexTotal);
+    runParallel(chunks.size(), [&](size_t i)
+                {
+                    const ObjChunk &chunk = chunks[i];
+                    uint32_t *out = outMesh.indices.data() + chunk.indexBase;
+                    for (size_t k = 0; k < chunk.localIndices.size(); ++k)
+                        out[k] = chunk.remap[chunk.localIndices[k]]; });
+
+    // Trocas de material: faces de uma fatia antes do seu primeiro usemtl
+    // continuam com o material em vigor no fim da fatia anterior
+    std::vector<std::string> materialNames;
+    std::vector<ObjMaterialRun> runs;
+    uint32_t currentMaterial = OBJ_NO_MATERIAL;
+    outMesh.materialLibrary.clear();
+    for (const ObjChunk &chunk : chunks)
+    {
+        if (outMesh.materialLibrary.empty())
+            outMesh.materialLibrary = chunk.materialLibrary;
+        std::vector<uint32_t> global(chunk.materialNames.size());
+        for (size_t m = 0; m < global.size(); ++m)
+            global[m] = findOrAddName(materialNames, chunk.materialNames[m]);
+        for (const ObjMaterialRun &run : chunk.runs)
+        {
+            uint32_t material = run.material == OBJ_INHERIT_MATERIAL ? currentMaterial : global[run.material];
+            addMaterialRun(runs, material, chunk.indexBase + run.firstIndex);
+        }
+        if (chunk.currentMaterial != OBJ_INHERIT_MATERIAL)
+            currentMaterial = global[chunk.currentMaterial];
+    }
+
+    finishMesh(outMesh, skippedFaces, runs, materialNames);
+    return true;
+}
+
+unsigned objParseThreadCount(size_t size)
+{
+    unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    if (size < OBJ_PARALLEL_MIN_BYTES)
+        return 1;
+    size_t bySize = size / OBJ_PARALLEL_CHUNK_BYTES;
+    return (unsigned)std::max<size_t>(1, std::min<size_t>(hardware, bySize));
+}
+
+bool loadOBJ(const std::string &objPath, ObjMesh &outMesh)
+{
+    MappedFile file;
+    if (!file.open(objPath))
+        return false;
+    return parseOBJParallel(file.data(), file.size(), outMesh, objParseThreadCount(file.size()));
+}
+
+void computeBounds(ObjMesh &mesh)
+{
+    mesh.boundsMin = glm::vec3(0.0f);
+    mesh.boundsMax = glm::vec3(0.0f);
+    bool first = true;
+    for (Submesh &sub : mesh.submeshes)
+    {
+        sub.boundsMin = glm::vec3(0.0f);
+        sub.boundsMax = glm::vec3(0.0f);
+        for (uint32_t i = 0; i < sub.indexCount; ++i)
+        {
+            const glm::vec3 &p = mesh.vertices[mesh.indices[sub.firstIndex + i]].position;
+            sub.boundsMin = i == 0 ? p : glm::min(sub.boundsMin, p);
+            sub.boundsMax = i == 0 ? p : glm::max(sub.boundsMax, p);
+        }
+        if (sub.indexCount == 0)
+            continue;
+        mesh.boundsMin = first ? sub.boundsMin : glm::min(mesh.boundsMin, sub.boundsMin);
+        mesh.boundsMax = first ? sub.boundsMax : glm::max(mesh.boundsMax, sub.boundsMax);
+        first = false;
+    }
+}
+
+// Rodada no estilo do xxHash64: consome 8 bytes por vez
+static inline uint64_t hashRound(uint64_t acc, uint64_t word)
+{
+    acc += word * 0xC2B2AE3D27D4EB4Full;
+    acc = (acc << 31) | (acc >> 33);
+    return acc * 0x9E3779B185EBCA87ull;
+}
+
+uint64_t hashBytes(const void *data, size_t size)
+{
+    const unsigned char *p = (const unsigned char *)data;
+    uint64_t h = 0x27D4EB2F165667C5ull ^ (uint64_t)size;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+        uint64_t w;
+        memcpy(&w, p + i, 8);
+        h = hashRound(h, w);
+    }
+    uint64_t tail = 0;
+    for (size_t j = 0; i + j < size; ++j)
+        tail |= (uint64_t)p[i + j] << (8 * j);
+    h = hashRound(h, tail);
+
+    // avalanche final
+    h ^= h >> 33;
+    h *= 0xC2B2AE3D27D4EB4Full;
+    h ^= h >> 29;
+    h *= 0x165667B19E3779F9ull;
+    h ^= h >> 32;
+    return h;
+}
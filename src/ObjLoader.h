@@ -0,0 +1,146 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Layout de vértice usado por todos os módulos que carregam .obj
+struct Vertex
+{
+    glm::vec3 position;
+    glm::vec3 normal;
+    glm::vec2 texCoord;
+};
+
+// Hash/igualdade exata de posição, para agrupar vértices que só diferem nos
+// atributos (costuras de UV/normal)
+struct PositionHash
+{
+    size_t operator()(const glm::vec3 &p) const
+    {
+        uint32_t bits[3];
+        memcpy(bits, &p, sizeof(bits));
+        return (size_t)(bits[0] * 73856093u ^ bits[1] * 19349663u ^ bits[2] * 83492791u);
+    }
+};
+
+struct PositionEqual
+{
+    bool operator()(const glm::vec3 &a, const glm::vec3 &b) const { return a.x == b.x && a.y == b.y && a.z == b.z; }
+};
+
+// Arquivo somente leitura mapeado em memória (mmap / MapViewOfFile).
+// O conteúdo é acessado direto da page cache, sem cópia para um buffer próprio.
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string &path) { open(path); }
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+
+    bool open(const std::string &path);
+    void close();
+
+    bool isOpen() const { return m_open; }
+    const char *data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    const char *m_data = nullptr;
+    size_t m_size = 0;
+    bool m_open = false;
+#ifdef _WIN32
+    void *m_file = nullptr;
+    void *m_mapping = nullptr;
+#endif
+};
+
+// Faixa contígua do buffer de índices com um só material e sua caixa envolvente
+struct Submesh
+{
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    uint32_t material; // índice em ObjMesh::materials
+    glm::vec3 boundsMin;
+    glm::vec3 boundsMax;
+};
+
+// Grupo pequeno de triângulos contíguos no buffer de índices, com esfera
+// envolvente e cone de normais para descartar o grupo inteiro antes do draw
+struct Meshlet
+{
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    glm::vec3 center;
+    float radius;
+    glm::vec3 coneAxis;
+    float coneCutoff; // seno da abertura do cone; 1 = cone inútil, nunca descarta
+};
+
+// Nível de detalhe: os submeshes [firstSubmesh, firstSubmesh + submeshes por nível)
+// ocupam a faixa contígua [firstIndex, firstIndex + indexCount) do buffer de índices,
+// coberta pelos meshlets [firstMeshlet, firstMeshlet + meshletCount).
+// Todos os níveis compartilham o mesmo buffer de vértices.
+struct MeshLod
+{
+    uint32_t firstSubmesh;
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    float error; // erro geométrico relativo à maior dimensão da caixa envolvente
+    uint32_t firstMeshlet;
+    uint32_t meshletCount;
+};
+
+// Geometria indexada lida de um .obj: cada combinação v/vt/vn distinta vira
+// um único Vertex e os triângulos referenciam esses vértices por índice.
+// Os triângulos são agrupados por usemtl: um submesh por material, na ordem em
+// que cada material aparece pela primeira vez numa face.
+struct ObjMesh
+{
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices; // 3 por triângulo
+    std::vector<Submesh> submeshes;
+    std::vector<std::string> materials; // nomes de usemtl ("" = faces sem usemtl)
+    std::string materialLibrary;        // primeiro mtllib do arquivo, relativo ao .obj
+    std::vector<MeshLod> lods; // lods[0] é a malha original
+    std::vector<Meshlet> meshlets;
+    glm::vec3 boundsMin = glm::vec3(0.0f);
+    glm::vec3 boundsMax = glm::vec3(0.0f);
+};
+
+// Índices cabem em 16 bits? (GL_UNSIGNED_SHORT em vez de GL_UNSIGNED_INT)
+inline bool fitsIndex16(const ObjMesh &mesh)
+{
+    return mesh.vertices.size() <= 0xFFFF;
+}
+
+// Faz o parsing de um .obj já em memória. Tokeniza in-place e converte números
+// com std::from_chars; faces com mais de 3 vértices são trianguladas em leque e
+// cantos repetidos são deduplicados por tabela hash.
+bool parseOBJ(const char *data, size_t size, ObjMesh &outMesh);
+
+// Mesmo resultado de parseOBJ, dividindo o arquivo em threadCount fatias
+// (quebradas em fim de linha) lidas em paralelo
+bool parseOBJParallel(const char *data, size_t size, ObjMesh &outMesh, unsigned threadCount);
+
+// Abaixo de OBJ_PARALLEL_MIN_BYTES o custo de criar threads não compensa;
+// cada thread recebe pelo menos OBJ_PARALLEL_CHUNK_BYTES do arquivo
+const size_t OBJ_PARALLEL_MIN_BYTES = 256 * 1024;
+const size_t OBJ_PARALLEL_CHUNK_BYTES = 128 * 1024;
+unsigned objParseThreadCount(size_t size);
+
+// Mapeia o arquivo e faz o parsing (em paralelo se o arquivo for grande)
+bool loadOBJ(const std::string &objPath, ObjMesh &outMesh);
+
+// Recalcula a caixa envolvente da malha e de cada submesh
+void computeBounds(ObjMesh &mesh);
+
+// Hash de 64 bits não criptográfico do conteúdo (chave de caches)
+uint64_t hashBytes(const void *data, size_t size);
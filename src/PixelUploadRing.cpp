@@ -0,0 +1,138 @@
+#include "PixelUploadRing.h"
+#include <algorithm>
+
+// Deslocamentos alinhados para qualquer formato de pixel
+static const size_t PIXEL_RING_ALIGNMENT = 256;
+
+bool PixelUploadRing::create(size_t capacity)
+{
+    destroy();
+    if (!GLEXT_buffer_storage || capacity == 0)
+        return false;
+
+    GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glGenBuffers(1, &m_buffer);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_buffer);
+    glBufferStorage(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)capacity, nullptr, flags);
+    m_mapped = (unsigned char *)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr)capacity, flags);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    if (!m_mapped)
+    {
+        glDeleteBuffers(1, &m_buffer);
+        m_buffer = 0;
+        return false;
+    }
+    m_capacity = capacity;
+    m_head = 0;
+    return true;
+}
+
+void PixelUploadRing::destroy()
+{
+    if (!m_buffer)
+        return;
+    for (Slot &slot : m_slots)
+    {
+        if (slot.fence)
+            glDeleteSync(slot.fence);
+    }
+    m_slots.clear();
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_buffer);
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glDeleteBuffers(1, &m_buffer);
+    m_buffer = 0;
+    m_mapped = nullptr;
+    m_capacity = 0;
+}
+
+bool PixelUploadRing::allocate(size_t bytes, Region &out)
+{
+    size_t size = (bytes + PIXEL_RING_ALIGNMENT - 1) & ~(PIXEL_RING_ALIGNMENT - 1);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_mapped || size == 0 || size > m_capacity)
+        return false;
+
+    // livre: [head, capacity) + [0, tail) ou [head, tail) depois de dar a volta;
+    // head nunca alcança tail, senão anel cheio e vazio ficariam iguais
+    size_t offset;
+    if (m_slots.empty())
+        offset = 0;
+    else
+    {
+        size_t tail = m_slots.front().offset;
+        if (m_head >= tail)
+        {
+            if (m_head + size <= m_capacity)
+                offset = m_head;
+            else if (size < tail)
+                offset = 0; // o fim do anel fica sem uso até a volta seguinte
+            else
+                return false;
+        }
+        else if (m_head + size < tail)
+            offset = m_head;
+        else
+            return false;
+    }
+
+    m_head = offset + size;
+    Slot slot = {m_nextId++, offset, size, 0, false, Clock::now()};
+    m_slots.push_back(slot);
+
+    out.id = slot.id;
+    out.offset = offset;
+    out.size = size;
+    out.data = m_mapped + offset;
+    return true;
+}
+
+void PixelUploadRing::release(uint64_t id, GLsync fence)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_slots.empty() || id < m_slots.front().id)
+        return;
+    Slot &slot = m_slots[id - m_slots.front().id];
+    slot.fence = fence;
+    slot.released = true;
+    slot.submitted = Clock::now();
+}
+
+void PixelUploadRing::collect()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    while (!m_slots.empty() && m_slots.front().released)
+    {
+        Slot &slot = m_slots.front();
+        if (slot.fence)
+        {
+            GLint status = GL_UNSIGNALED;
+            glGetSynciv(slot.fence, GL_SYNC_STATUS, 1, nullptr, &status);
+            if (status != GL_SIGNALED)
+                break;
+            glDeleteSync(slot.fence);
+
+            // uploads em sequência: conta só o tempo desde o fim do anterior
+            Clock::time_point now = Clock::now();
+            Clock::time_point start = std::max(slot.submitted, m_lastRetire);
+            m_uploadSeconds += std::chrono::duration<double>(now - start).count();
+            m_uploadedBytes += slot.size;
+            m_lastRetire = now;
+        }
+        m_slots.pop_front();
+    }
+    if (m_slots.empty())
+        m_head = 0;
+}
+
+uint64_t PixelUploadRing::uploadedBytes() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_uploadedBytes;
+}
+
+double PixelUploadRing::uploadSeconds() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_uploadSeconds;
+}
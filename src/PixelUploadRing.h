@@ -0,0 +1,82 @@
+#pragma once
+#include "GLExt.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+// Anel de pixel unpack buffer mapeado de forma persistente e coerente
+// (glBufferStorage): as threads de trabalho escrevem a cadeia de mipmaps já
+// gerada (MipChain) direto na memória mapeada, e os passos de upload fazem
+// glTexSubImage3D de faixas de linhas de cada nível para a camada da textura no
+// array da página (TextureArrays.h, alocado com glTexStorage3D ou, sem ele,
+// glTexImage3D), usando o deslocamento no buffer como ponteiro. Assim não há a
+// cópia síncrona que o driver faz de ponteiros da CPU.
+// Cada região só volta a ser usada depois que a fence do seu upload sinaliza.
+//
+// Regiões saem do anel na ordem em que foram reservadas; allocate() nunca
+// espera: sem espaço, devolve false e quem chamou faz o upload pelo caminho
+// antigo.
+class PixelUploadRing
+{
+public:
+    struct Region
+    {
+        uint64_t id = 0;
+        size_t offset = 0;
+        size_t size = 0;
+        unsigned char *data = nullptr; // memória mapeada da região
+    };
+
+    PixelUploadRing() = default;
+    ~PixelUploadRing() { destroy(); }
+
+    PixelUploadRing(const PixelUploadRing &) = delete;
+    PixelUploadRing &operator=(const PixelUploadRing &) = delete;
+
+    // Thread GL; false sem glBufferStorage (GL < 4.4) ou se o mapeamento falhar
+    bool create(size_t capacity);
+    void destroy();
+    bool ready() const { return m_mapped != nullptr; }
+    GLuint buffer() const { return m_buffer; }
+
+    // Qualquer thread: reserva bytes contíguos
+    bool allocate(size_t bytes, Region &out);
+
+    // Qualquer thread GL: o upload da região foi enviado com essa fence (0 = a
+    // região não foi usada e pode ser liberada já)
+    void release(uint64_t id, GLsync fence);
+
+    // Thread principal, a cada quadro: libera as regiões cujas fences sinalizaram
+    void collect();
+
+    // Bytes que já chegaram à GPU e tempo em que havia uploads em andamento
+    uint64_t uploadedBytes() const;
+    double uploadSeconds() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Slot
+    {
+        uint64_t id;
+        size_t offset;
+        size_t size;
+        GLsync fence;
+        bool released;
+        Clock::time_point submitted;
+    };
+
+    GLuint m_buffer = 0;
+    unsigned char *m_mapped = nullptr;
+    size_t m_capacity = 0;
+    size_t m_head = 0; // próximo byte livre
+    uint64_t m_nextId = 1;
+    std::deque<Slot> m_slots; // reservadas, da mais antiga para a mais nova
+    mutable std::mutex m_mutex;
+
+    uint64_t m_uploadedBytes = 0;
+    double m_uploadSeconds = 0.0;
+    Clock::time_point m_lastRetire;
+};
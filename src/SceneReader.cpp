@@ -0,0 +1,177 @@
+#include "SceneReader.h"
+#include "../Common/json.hpp"
+#include <iostream>
+
+// Recebe os eventos do parser e mantém uma pilha com o que cada objeto/array
+// aberto representa; valores fora dos lugares conhecidos caem em Skip
+class SceneSax : public nlohmann::json_sax<nlohmann::json>
+{
+public:
+    SceneSax(SceneSettings &settings, const std::function<void(SceneObjectRecord &)> &onObject)
+        : m_settings(settings), m_onObject(onObject)
+    {
+    }
+
+    bool null() override { return true; }
+    bool boolean(bool) override { return true; }
+    bool number_integer(number_integer_t value) override { return number((float)value); }
+    bool number_unsigned(number_unsigned_t value) override { return number((float)value); }
+    bool number_float(number_float_t value, const string_t &) override { return number((float)value); }
+    bool binary(binary_t &) override { return true; }
+
+    bool string(string_t &value) override
+    {
+        if (top() != Object)
+            return true;
+        if (m_key == "file")
+            m_record.file = value;
+        else if (m_key == "material")
+            m_record.material = value;
+        else if (m_key == "vertexFormat")
+            m_record.vertexFormat = value;
+        return true;
+    }
+
+    bool key(string_t &value) override
+    {
+        m_key = value;
+        return true;
+    }
+
+    bool start_object(std::size_t) override
+    {
+        Context context = Skip;
+        if (m_stack.empty())
+            context = Root;
+        else if (top() == Objects)
+        {
+            m_record = SceneObjectRecord();
+            context = Object;
+        }
+        else if (top() == Root && m_key == "light")
+            context = Light;
+        else if (top() == Root && m_key == "camera")
+            context = CameraSettings;
+        m_stack.push_back(context);
+        return true;
+    }
+
+    bool end_object() override
+    {
+        if (top() == Object)
+        {
+            if (m_record.file.empty())
+                std::cerr << "Aviso: objeto " << m_objectIndex << " da cena sem \"file\", ignorado" << std::endl;
+            else
+                m_onObject(m_record);
+            ++m_objectIndex;
+        }
+        // só valem se o objeto inteiro foi lido
+        else if (top() == Light)
+            m_settings.hasLight = true;
+        else if (top() == CameraSettings)
+            m_settings.hasCamera = true;
+        m_stack.pop_back();
+        return true;
+    }
+
+    bool start_array(std::size_t) override
+    {
+        Context context = Skip;
+        glm::vec3 *target = nullptr;
+        switch (top())
+        {
+        case Root:
+            if (m_key == "objects")
+                context = Objects;
+            break;
+        case Object:
+            if (m_key == "position")
+                target = &m_record.position;
+            else if (m_key == "rotation")
+                target = &m_record.rotation;
+            else if (m_key == "waypoints")
+                context = Waypoints;
+            break;
+        case Waypoints:
+            m_record.waypoints.push_back(glm::vec3(0.0f));
+            target = &m_record.waypoints.back();
+            break;
+        case Light:
+            if (m_key == "position")
+                target = &m_settings.lightPosition;
+            else if (m_key == "color")
+                target = &m_settings.lightColor;
+            break;
+        case CameraSettings:
+            if (m_key == "position")
+                target = &m_settings.cameraPosition;
+            break;
+        default:
+            break;
+        }
+        if (target)
+        {
+            context = Vector;
+            m_vector = target;
+            m_component = 0;
+        }
+        m_stack.push_back(context);
+        return true;
+    }
+
+    bool end_array() override
+    {
+        m_stack.pop_back();
+        return true;
+    }
+
+    bool parse_error(std::size_t position, const std::string &, const nlohmann::detail::exception &error) override
+    {
+        std::cerr << "Erro no arquivo de cena (byte " << position << "): " << error.what() << std::endl;
+        return false;
+    }
+
+private:
+    enum Context
+    {
+        Root,
+        Objects,
+        Object,
+        Waypoints,
+        Light,
+        CameraSettings,
+        Vector,
+        Skip
+    };
+
+    Context top() const { return m_stack.empty() ? Skip : m_stack.back(); }
+
+    bool number(float value)
+    {
+        if (top() == Vector)
+        {
+            if (m_component < 3)
+                (*m_vector)[m_component++] = value;
+        }
+        else if (top() == Object && m_key == "scale")
+            m_record.scale = value;
+        return true;
+    }
+
+    SceneSettings &m_settings;
+    const std::function<void(SceneObjectRecord &)> &m_onObject;
+    std::vector<Context> m_stack;
+    std::string m_key;
+    SceneObjectRecord m_record;
+    glm::vec3 *m_vector = nullptr;
+    int m_component = 0;
+    size_t m_objectIndex = 0;
+};
+
+bool readScene(const char *data, size_t size, SceneSettings &settings,
+               const std::function<void(SceneObjectRecord &)> &onObject)
+{
+    SceneSax sax(settings, onObject);
+    return nlohmann::json::sax_parse(data, data + size, &sax);
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Leitura do scene.json em fluxo (SAX do json.hpp), sem montar o DOM: cada
+// objeto de "objects" vira um SceneObjectRecord entregue ao callback assim que
+// o '}' que o fecha é lido, para o carregamento do .obj começar enquanto o
+// resto do arquivo ainda está sendo lido. Chaves desconhecidas são ignoradas.
+
+struct SceneObjectRecord
+{
+    std::string file;                      // relativo à pasta dos modelos
+    std::string material;                  // vazio: usa o mtllib do .obj
+    std::string vertexFormat = "float";    // "float" ou "packed"
+    glm::vec3 position = glm::vec3(0.0f);
+    glm::vec3 rotation = glm::vec3(0.0f);
+    float scale = 1.0f;
+    std::vector<glm::vec3> waypoints;
+};
+
+// "light" e "camera"; has* fica false quando a chave não aparece no arquivo
+struct SceneSettings
+{
+    bool hasLight = false;
+    glm::vec3 lightPosition = glm::vec3(0.0f);
+    glm::vec3 lightColor = glm::vec3(1.0f);
+    bool hasCamera = false;
+    glm::vec3 cameraPosition = glm::vec3(0.0f);
+};
+
+// Lê a cena de data (conteúdo do arquivo), chamando onObject para cada objeto
+// na ordem do arquivo; objetos sem "file" são descartados com aviso. false em
+// erro de sintaxe: os objetos anteriores ao erro já foram entregues.
+bool readScene(const char *data, size_t size, SceneSettings &settings,
+               const std::function<void(SceneObjectRecord &)> &onObject);
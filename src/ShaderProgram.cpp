@@ -0,0 +1,222 @@
+#include "ShaderProgram.h"
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+// Programa em uso na thread GL (use() pula glUseProgram repetido)
+static GLuint s_currentProgram = 0;
+
+static GLuint compileShader(GLenum stage, const char *source, const char *header, const char *label)
+{
+    GLuint shader = glCreateShader(stage);
+    const char *version = header ? strstr(source, "#version") : nullptr;
+    const char *lineEnd = version ? strchr(version, '\n') : nullptr;
+    if (lineEnd)
+    {
+        // o #version precisa vir antes de qualquer declaração
+        const char *parts[3] = {source, header, lineEnd + 1};
+        GLint lengths[3] = {GLint(lineEnd + 1 - source), -1, -1};
+        glShaderSource(shader, 3, parts, lengths);
+    }
+    else
+        glShaderSource(shader, 1, &source, NULL);
+    glCompileShader(shader);
+    GLint success;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if (!success)
+    {
+        char infoLog[512];
+        glGetShaderInfoLog(shader, 512, NULL, infoLog);
+        std::cerr << "Erro " << label << " shader: " << infoLog << std::endl;
+    }
+    return shader;
+}
+
+// Bytes de um elemento do uniform; escalares, bools e samplers (a unidade) são
+// um int
+static size_t uniformBytes(GLenum type)
+{
+    switch (type)
+    {
+    case GL_FLOAT_VEC2:
+    case GL_INT_VEC2:
+        return 8;
+    case GL_FLOAT_VEC3:
+    case GL_INT_VEC3:
+        return 12;
+    case GL_FLOAT_VEC4:
+    case GL_INT_VEC4:
+    case GL_FLOAT_MAT2:
+        return 16;
+    case GL_FLOAT_MAT3:
+        return 36;
+    case GL_FLOAT_MAT4:
+        return 64;
+    default:
+        return 4;
+    }
+}
+
+bool ShaderProgram::build(const char *vertexSource, const char *fragmentSource, const char *header)
+{
+    destroy();
+    GLuint vertexShader = compileShader(GL_VERTEX_SHADER, vertexSource, header, "vertex");
+    GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, fragmentSource, header, "fragment");
+
+    m_program = glCreateProgram();
+    glAttachShader(m_program, vertexShader);
+    glAttachShader(m_program, fragmentShader);
+    glLinkProgram(m_program);
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+    GLint success;
+    glGetProgramiv(m_program, GL_LINK_STATUS, &success);
+    if (!success)
+    {
+        char infoLog[512];
+        glGetProgramInfoLog(m_program, 512, NULL, infoLog);
+        std::cerr << "Erro link shader: " << infoLog << std::endl;
+        return false;
+    }
+
+    // Reflexão: cada uniform ativo (e cada elemento de array) ganha uma entrada
+    // na tabela e um espaço para o último valor
+    GLint count = 0, maxName = 0;
+    glGetProgramiv(m_program, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(m_program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxName);
+    std::vector<char> nameBuffer(std::max(maxName, 1));
+    auto addSlot = [this](GLint location, size_t bytes)
+    {
+        if (location >= (GLint)m_slots.size())
+            m_slots.resize(location + 1);
+        m_slots[location] = {m_values.size(), bytes, 0};
+        m_values.resize(m_values.size() + bytes);
+    };
+    for (GLint i = 0; i < count; ++i)
+    {
+        GLint size = 0;
+        GLenum type = 0;
+        GLsizei length = 0;
+        glGetActiveUniform(m_program, (GLuint)i, (GLsizei)nameBuffer.size(), &length, &size, &type, nameBuffer.data());
+        std::string name(nameBuffer.data(), length);
+        GLint location = glGetUniformLocation(m_program, name.c_str());
+        if (location < 0)
+            continue; // membro de bloco uniform ou variável embutida
+
+        size_t bytes = uniformBytes(type);
+        m_locations[name] = location;
+        if (size == 1)
+        {
+            addSlot(location, bytes);
+            continue;
+        }
+
+        // "textures[0]": a base guarda o array inteiro (setIntArray), os demais
+        // elementos só o próprio valor
+        std::string base = name.substr(0, name.find('['));
+        m_locations[base] = location;
+        addSlot(location, bytes * size);
+        for (GLint e = 1; e < size; ++e)
+        {
+            std::string element = base + "[" + std::to_string(e) + "]";
+            GLint elementLocation = glGetUniformLocation(m_program, element.c_str());
+            if (elementLocation < 0)
+                continue;
+            m_locations[element] = elementLocation;
+            addSlot(elementLocation, bytes);
+        }
+    }
+    return true;
+}
+
+void ShaderProgram::destroy()
+{
+    if (!m_program)
+        return;
+    if (s_currentProgram == m_program)
+        s_currentProgram = 0;
+    glDeleteProgram(m_program);
+    m_program = 0;
+    m_locations.clear();
+    m_slots.clear();
+    m_values.clear();
+}
+
+void ShaderProgram::use() const
+{
+    if (s_currentProgram == m_program)
+        return;
+    glUseProgram(m_program);
+    s_currentProgram = m_program;
+}
+
+GLint ShaderProgram::location(const std::string &name) const
+{
+    auto it = m_locations.find(name);
+    return it != m_locations.end() ? it->second : -1;
+}
+
+bool ShaderProgram::changed(GLint location, const void *value, size_t bytes)
+{
+    if (location < 0)
+        return false;
+    if (location >= (GLint)m_slots.size() || bytes > m_slots[location].bytes)
+    {
+        ++m_uploads; // fora da tabela: envia sem guardar
+        return true;
+    }
+    Slot &slot = m_slots[location];
+    unsigned char *cached = m_values.data() + slot.offset;
+    if (bytes <= slot.known && memcmp(cached, value, bytes) == 0)
+    {
+        ++m_skipped;
+        return false;
+    }
+    memcpy(cached, value, bytes);
+    slot.known = std::max(slot.known, bytes); // o resto de um array não muda
+    ++m_uploads;
+    return true;
+}
+
+void ShaderProgram::setInt(GLint location, int value)
+{
+    if (changed(location, &value, sizeof(value)))
+        glUniform1i(location, value);
+}
+
+void ShaderProgram::setFloat(GLint location, float value)
+{
+    if (changed(location, &value, sizeof(value)))
+        glUniform1f(location, value);
+}
+
+void ShaderProgram::setVec3(GLint location, const glm::vec3 &value)
+{
+    if (changed(location, glm::value_ptr(value), sizeof(value)))
+        glUniform3fv(location, 1, glm::value_ptr(value));
+}
+
+void ShaderProgram::setVec4(GLint location, const glm::vec4 &value)
+{
+    if (changed(location, glm::value_ptr(value), sizeof(value)))
+        glUniform4fv(location, 1, glm::value_ptr(value));
+}
+
+void ShaderProgram::setMat3(GLint location, const glm::mat3 &value)
+{
+    if (changed(location, glm::value_ptr(value), sizeof(value)))
+        glUniformMatrix3fv(location, 1, GL_FALSE, glm::value_ptr(value));
+}
+
+void ShaderProgram::setMat4(GLint location, const glm::mat4 &value)
+{
+    if (changed(location, glm::value_ptr(value), sizeof(value)))
+        glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value));
+}
+
+void ShaderProgram::setIntArray(GLint location, const int *values, int count)
+{
+    if (changed(location, values, count * sizeof(int)))
+        glUniform1iv(location, count, values);
+}
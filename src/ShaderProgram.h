@@ -0,0 +1,78 @@
+#pragma once
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Programa de shader (vértice + fragmento) com os uniforms ativos refletidos uma
+// vez no link: location() consulta a tabela em vez de chamar
+// glGetUniformLocation, e cada set* guarda o último valor enviado e pula a
+// chamada GL quando ele não mudou.
+//
+// Como glUniform*, os set* valem para o programa em uso: chame use() antes. O
+// cache só é confiável se os uniforms do programa forem escritos apenas por ele,
+// e um array deve ser escrito sempre pela base (setIntArray) ou sempre por
+// elemento.
+class ShaderProgram
+{
+public:
+    ShaderProgram() = default;
+    ~ShaderProgram() { destroy(); }
+
+    ShaderProgram(const ShaderProgram &) = delete;
+    ShaderProgram &operator=(const ShaderProgram &) = delete;
+
+    // Compila e linka; erros de compilação e link vão para cerr. false se o
+    // link falhar. header (ex.: FRAME_CONSTANTS_GLSL) entra nos dois estágios
+    // logo depois da linha do #version
+    bool build(const char *vertexSource, const char *fragmentSource, const char *header = nullptr);
+    void destroy();
+    GLuint id() const { return m_program; }
+
+    // glUseProgram, pulado se o programa já estiver em uso
+    void use() const;
+
+    // Location do uniform (arrays também por "nome[i]"); -1 se não estiver ativo
+    GLint location(const std::string &name) const;
+
+    void setInt(GLint location, int value);
+    void setFloat(GLint location, float value);
+    void setVec3(GLint location, const glm::vec3 &value);
+    void setVec4(GLint location, const glm::vec4 &value);
+    void setMat3(GLint location, const glm::mat3 &value);
+    void setMat4(GLint location, const glm::mat4 &value);
+    void setIntArray(GLint location, const int *values, int count);
+
+    // Pelo nome (uma busca na tabela); no laço de desenho prefira a location
+    void setInt(const std::string &name, int value) { setInt(location(name), value); }
+    void setFloat(const std::string &name, float value) { setFloat(location(name), value); }
+    void setVec3(const std::string &name, const glm::vec3 &value) { setVec3(location(name), value); }
+    void setVec4(const std::string &name, const glm::vec4 &value) { setVec4(location(name), value); }
+    void setMat3(const std::string &name, const glm::mat3 &value) { setMat3(location(name), value); }
+    void setMat4(const std::string &name, const glm::mat4 &value) { setMat4(location(name), value); }
+
+    // Chamadas glUniform* feitas e evitadas pelo cache
+    size_t uploads() const { return m_uploads; }
+    size_t skipped() const { return m_skipped; }
+
+private:
+    // Último valor enviado para uma location
+    struct Slot
+    {
+        size_t offset = 0; // em m_values
+        size_t bytes = 0;  // 0: location sem uniform
+        size_t known = 0;  // bytes do início já enviados
+    };
+
+    // true se value difere do último enviado para location (e o guarda)
+    bool changed(GLint location, const void *value, size_t bytes);
+
+    GLuint m_program = 0;
+    std::unordered_map<std::string, GLint> m_locations;
+    std::vector<Slot> m_slots; // indexado pela location
+    std::vector<unsigned char> m_values;
+    size_t m_uploads = 0;
+    size_t m_skipped = 0;
+};
@@ -24,6 +24,9 @@ using namespace std;
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include "ShaderProgram.h"
+#include "ShaderProgram.cpp"
+
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
@@ -35,11 +38,10 @@ using namespace glm;
 void key_callback(GLFWwindow *window, int key, int scancode, int action, int mode);
 
 // Protótipos das funções
-int setupShader();
 int setupGeometry();
 GLuint loadTexture(string filePath, int &width, int &height);
 
-void drawGeometry(GLuint shaderID, GLuint VAO, vec3 position, vec3 dimensions, float angle, int nVertices, vec3 color= vec3(1.0,0.0,0.0), vec3 axis = (vec3(0.0, 0.0, 1.0)));
+void drawGeometry(ShaderProgram &shader, GLuint VAO, vec3 position, vec3 dimensions, float angle, int nVertices, vec3 color= vec3(1.0,0.0,0.0), vec3 axis = (vec3(0.0, 0.0, 1.0)));
 GLuint generateSphere(float radius, int latSegments, int lonSegments, int &nVertices);
  
 // Dimensões da janela (pode ser alterado em tempo de execução)
@@ -156,7 +158,8 @@ int main()
 	glViewport(0, 0, width, height);
 
 	// Compilando e buildando o programa de shader
-	GLuint shaderID = setupShader();
+	ShaderProgram shader;
+	shader.build(vertexShaderSource, fragmentShaderSource);
 
 	// Gerando um buffer simples, com a geometria de um triângulo
 	int nVertices;
@@ -171,17 +174,17 @@ int main()
 	vec3 camPos = vec3(0.0,0.0,-3.0);
 
 
-	glUseProgram(shaderID);
+	shader.use();
 
 	// Enviar a informação de qual variável armazenará o buffer da textura
-	glUniform1i(glGetUniformLocation(shaderID, "texBuff"), 0);
+	shader.setInt("texBuff", 0);
 
-	glUniform1f(glGetUniformLocation(shaderID, "ka"), ka);
-	glUniform1f(glGetUniformLocation(shaderID, "kd"), kd);
-	glUniform1f(glGetUniformLocation(shaderID, "ks"), ks);
-	glUniform1f(glGetUniformLocation(shaderID, "q"), q);
-	glUniform3f(glGetUniformLocation(shaderID, "lightPos"), lightPos.x,lightPos.y,lightPos.z);
-	glUniform3f(glGetUniformLocation(shaderID, "camPos"), camPos.x,camPos.y,camPos.z);
+	shader.setFloat("ka", ka);
+	shader.setFloat("kd", kd);
+	shader.setFloat("ks", ks);
+	shader.setFloat("q", q);
+	shader.setVec3("lightPos", lightPos);
+	shader.setVec3("camPos", camPos);
 
 	//Ativando o primeiro buffer de textura da OpenGL
 	glActiveTexture(GL_TEXTURE0);
@@ -190,11 +193,11 @@ int main()
 	// Matriz de projeção paralela ortográfica
 	// mat4 projection = ortho(-10.0, 10.0, -10.0, 10.0, -1.0, 1.0);
 	mat4 projection = ortho(-1.0, 1.0, -1.0, 1.0, -3.0, 3.0);
-	glUniformMatrix4fv(glGetUniformLocation(shaderID, "projection"), 1, GL_FALSE, value_ptr(projection));
+	shader.setMat4("projection", projection);
 
 	// Matriz de modelo: transformações na geometria (objeto)
 	mat4 model = mat4(1); // matriz identidade
-	glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
+	shader.setMat4("model", model);
 
 	// Loop da aplicação - "game loop"
 	while (!glfwWindowShouldClose(window))
@@ -210,7 +213,7 @@ int main()
 		glBindTexture(GL_TEXTURE_2D, texID); //conectando com o buffer de textura que será usado no draw
 
 		// Primeiro Triângulo
-		drawGeometry(shaderID, VAO, vec3(0, 0, 0), vec3(1, 1, 1), 0.0, nVertices);
+		drawGeometry(shader, VAO, vec3(0, 0, 0), vec3(1, 1, 1), 0.0, nVertices);
 
 	
 		glBindVertexArray(0); // Desconectando o buffer de geometria
@@ -220,6 +223,7 @@ int main()
 	}
 	// Pede pra OpenGL desalocar os buffers
 	glDeleteVertexArrays(1, &VAO);
+	shader.destroy();
 	// Finaliza a execução da GLFW, limpando os recursos alocados por ela
 	glfwTerminate();
 	return 0;
@@ -234,58 +238,6 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
 		glfwSetWindowShouldClose(window, GL_TRUE);
 }
 
-// Esta função está basntante hardcoded - objetivo é compilar e "buildar" um programa de
-//  shader simples e único neste exemplo de código
-//  O código fonte do vertex e fragment shader está nos arrays vertexShaderSource e
-//  fragmentShader source no iniçio deste arquivo
-//  A função retorna o identificador do programa de shader
-int setupShader()
-{
-	// Vertex shader
-	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-	glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-	glCompileShader(vertexShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	GLint success;
-	GLchar infoLog[512];
-	glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n"
-				  << infoLog << std::endl;
-	}
-	// Fragment shader
-	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-	glCompileShader(fragmentShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n"
-				  << infoLog << std::endl;
-	}
-	// Linkando os shaders e criando o identificador do programa de shader
-	GLuint shaderProgram = glCreateProgram();
-	glAttachShader(shaderProgram, vertexShader);
-	glAttachShader(shaderProgram, fragmentShader);
-	glLinkProgram(shaderProgram);
-	// Checando por erros de linkagem
-	glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-	if (!success)
-	{
-		glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n"
-				  << infoLog << std::endl;
-	}
-	glDeleteShader(vertexShader);
-	glDeleteShader(fragmentShader);
-
-	return shaderProgram;
-}
-
 // Esta função está bastante harcoded - objetivo é criar os buffers que armazenam a
 // geometria de um triângulo
 // Apenas atributo coordenada nos vértices
@@ -392,7 +344,7 @@ GLuint loadTexture(string filePath, int &width, int &height)
 	return texID;
 }
 
-void drawGeometry(GLuint shaderID, GLuint VAO, vec3 position, vec3 dimensions, float angle, int nVertices, vec3 color, vec3 axis)
+void drawGeometry(ShaderProgram &shader, GLuint VAO, vec3 position, vec3 dimensions, float angle, int nVertices, vec3 color, vec3 axis)
 {
 	// Matriz de modelo: transformações na geometria (objeto)
 	mat4 model = mat4(1); // matriz identidade
@@ -402,9 +354,9 @@ void drawGeometry(GLuint shaderID, GLuint VAO, vec3 position, vec3 dimensions, f
 	model = rotate(model, radians(angle), axis);
 	// Escala
 	model = scale(model, dimensions);
-	glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
+	shader.setMat4("model", model);
 
-	//glUniform4f(glGetUniformLocation(shaderID, "inputColor"), color.r, color.g, color.b, 1.0f); // enviando cor para variável uniform inputColor
+	//shader.setVec4("inputColor", vec4(color, 1.0f)); // enviando cor para variável uniform inputColor
 																								//  Chamada de desenho - drawcall
 																								//  Poligono Preenchido - GL_TRIANGLES
 	glDrawArrays(GL_TRIANGLES, 0, nVertices);
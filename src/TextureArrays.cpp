@@ -0,0 +1,217 @@
+#include "TextureArrays.h"
+#include "TextureCompressor.h"
+#include <algorithm>
+#include <cstdlib>
+
+// Memória alvo de uma página; texturas maiores que isso ficam sozinhas
+static const size_t TEXTURE_PAGE_BYTES = 64 * 1024 * 1024;
+static const int TEXTURE_PAGE_MAX_LAYERS = 64;
+
+size_t textureLevelBytes(const TextureLayout &layout, int level)
+{
+    int w = std::max(1, layout.width >> level), h = std::max(1, layout.height >> level);
+    if (layout.compressed())
+        return compressedLevelSize(layout.internalFormat == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT ? TEXTURE_BC3 : TEXTURE_BC1, w, h);
+    size_t channels = layout.format == GL_RGBA ? 4 : 3;
+    return (((size_t)w * channels + 3) & ~(size_t)3) * h;
+}
+
+TextureArrayPool::Task TextureArrayPool::storageTask(const Page &page, int previousCapacity,
+                                                    std::shared_ptr<GLuint> texture)
+{
+    std::shared_ptr<GLuint> id = page.id;
+    TextureLayout layout = page.layout;
+    int capacity = page.capacity;
+    return [id, layout, capacity, previousCapacity, texture]()
+    {
+        GLuint name;
+        glGenTextures(1, &name);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, name);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, layout.levels - 1);
+        if (GLEXT_texture_storage)
+            glTexStorage3D(GL_TEXTURE_2D_ARRAY, layout.levels, layout.internalFormat, layout.width, layout.height, capacity);
+        else
+        {
+            for (int l = 0; l < layout.levels; ++l)
+            {
+                int w = std::max(1, layout.width >> l), h = std::max(1, layout.height >> l);
+                if (layout.compressed())
+                    glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, l, layout.internalFormat, w, h, capacity, 0,
+                                           (GLsizei)(textureLevelBytes(layout, l) * capacity), nullptr);
+                else
+                    glTexImage3D(GL_TEXTURE_2D_ARRAY, l, layout.internalFormat, w, h, capacity, 0, layout.format,
+                                 GL_UNSIGNED_BYTE, nullptr);
+            }
+        }
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+        // crescimento: as camadas já escritas vêm do array anterior, que a thread
+        // principal apaga quando passar a ligar este
+        for (int l = 0; previousCapacity > 0 && l < layout.levels; ++l)
+        {
+            int w = std::max(1, layout.width >> l), h = std::max(1, layout.height >> l);
+            glCopyImageSubData(*id, GL_TEXTURE_2D_ARRAY, l, 0, 0, 0, name, GL_TEXTURE_2D_ARRAY, l, 0, 0, 0, w, h,
+                               previousCapacity);
+        }
+        *texture = name;
+        *id = name;
+    };
+}
+
+bool TextureArrayPool::allocate(const TextureLayout &layout, TextureSlot &out, Task &create)
+{
+    create = Task();
+    for (size_t p = 0; p < m_pages.size(); ++p)
+    {
+        Page &page = m_pages[p];
+        if (page.layout == layout && !page.freeLayers.empty())
+        {
+            out.page = (int)p;
+            out.layer = page.freeLayers.back();
+            out.generation = page.generation;
+            page.freeLayers.pop_back();
+            return true;
+        }
+    }
+
+    // página cheia abaixo do teto: dobra
+    for (size_t p = 0; p < m_pages.size(); ++p)
+    {
+        Page &page = m_pages[p];
+        if (!(page.layout == layout) || page.capacity >= page.maxCapacity)
+            continue;
+        int previous = page.capacity;
+        page.capacity = std::min(page.maxCapacity, previous * 2);
+        for (int layer = page.capacity - 1; layer > previous; --layer)
+            page.freeLayers.push_back(layer);
+        ++page.generation;
+        auto texture = std::make_shared<GLuint>(0);
+        page.storages.push_back({page.generation, texture});
+        create = storageTask(page, previous, texture);
+        out.page = (int)p;
+        out.layer = previous;
+        out.generation = page.generation;
+        return true;
+    }
+    if (m_pages.size() >= (size_t)MAX_TEXTURE_PAGES)
+        return false;
+
+    Page page;
+    page.layout = layout;
+    page.layerBytes = 0;
+    for (int l = 0; l < layout.levels; ++l)
+        page.layerBytes += textureLevelBytes(layout, l);
+    page.maxCapacity = (int)std::max<size_t>(1, std::min<size_t>(TEXTURE_PAGE_MAX_LAYERS, TEXTURE_PAGE_BYTES / page.layerBytes));
+    page.capacity = GLEXT_copy_image ? 1 : page.maxCapacity;
+    for (int layer = page.capacity - 1; layer > 0; --layer)
+        page.freeLayers.push_back(layer);
+    page.id = std::make_shared<GLuint>(0);
+    page.generation = 0;
+    page.visible = 0;
+    auto texture = std::make_shared<GLuint>(0);
+    page.storages.push_back({0, texture});
+    m_pages.push_back(page);
+
+    out.page = (int)m_pages.size() - 1;
+    out.layer = 0;
+    out.generation = 0;
+    create = storageTask(m_pages.back(), 0, texture);
+    return true;
+}
+
+bool TextureArrayPool::fallbackLayout(const TextureLayout &layout, TextureLayout &out) const
+{
+    const Page *best = nullptr;
+    long long bestScore = 0;
+    for (const Page &page : m_pages)
+    {
+        if (page.layout.compressed() || (page.freeLayers.empty() && page.capacity >= page.maxCapacity))
+            continue;
+        long long area = (long long)layout.width * layout.height;
+        long long score = std::llabs((long long)page.layout.width * page.layout.height - area);
+        if (page.layout.internalFormat != layout.internalFormat)
+            score += 1LL << 40;
+        if (!best || score < bestScore)
+        {
+            best = &page;
+            bestScore = score;
+        }
+    }
+    if (!best)
+        return false;
+    out = best->layout;
+    return true;
+}
+
+void TextureArrayPool::release(TextureSlot slot)
+{
+    if (slot.page < 0 || slot.page >= (int)m_pages.size())
+        return;
+    m_pages[slot.page].freeLayers.push_back(slot.layer);
+}
+
+std::shared_ptr<GLuint> TextureArrayPool::pageTexture(int page) const
+{
+    return m_pages[page].id;
+}
+
+void TextureArrayPool::markReady(TextureSlot slot)
+{
+    if (slot.page < 0 || slot.page >= (int)m_pages.size())
+        return;
+    Page &page = m_pages[slot.page];
+    // os arrays criados até a reserva da camada já foram escritos pelo fluxo de
+    // uploads (o publish só roda depois da fence); o último deles passa a ser ligado
+    while (!page.storages.empty() && page.storages.front().generation <= slot.generation)
+    {
+        if (page.visible)
+            glDeleteTextures(1, &page.visible);
+        page.visible = *page.storages.front().texture;
+        page.storages.erase(page.storages.begin());
+    }
+}
+
+void TextureArrayPool::bind() const
+{
+    for (size_t p = 0; p < m_pages.size(); ++p)
+    {
+        if (!m_pages[p].visible)
+            continue;
+        glActiveTexture(GL_TEXTURE0 + (GLenum)p);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, m_pages[p].visible);
+    }
+    glActiveTexture(GL_TEXTURE0);
+}
+
+size_t TextureArrayPool::layerCount() const
+{
+    size_t count = 0;
+    for (const Page &page : m_pages)
+        count += page.capacity - page.freeLayers.size();
+    return count;
+}
+
+size_t TextureArrayPool::reservedBytes() const
+{
+    size_t bytes = 0;
+    for (const Page &page : m_pages)
+        bytes += page.capacity * page.layerBytes;
+    return bytes;
+}
+
+void TextureArrayPool::destroy()
+{
+    for (Page &page : m_pages)
+    {
+        if (page.visible)
+            glDeleteTextures(1, &page.visible);
+        for (Storage &storage : page.storages)
+            if (*storage.texture)
+                glDeleteTextures(1, storage.texture.get());
+    }
+    m_pages.clear();
+}
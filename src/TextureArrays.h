@@ -0,0 +1,122 @@
+#pragma once
+#include "GLExt.h"
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Texturas da cena agrupadas em GL_TEXTURE_2D_ARRAY ("páginas"): cada textura
+// ocupa uma camada de uma página com o mesmo formato, tamanho e número de
+// níveis. Todas as páginas ficam ligadas de uma vez, uma por unidade de
+// textura, e o material só escolhe página e camada por uniform.
+//
+// Uma página nasce com uma camada e dobra quando enche (até o teto de memória
+// da página): o passo de crescimento cria o array maior e copia as camadas com
+// glCopyImageSubData no mesmo fluxo dos uploads, e a thread principal só troca
+// o array ligado quando o publish de uma camada posterior ao crescimento roda.
+// Sem cópia entre texturas (GL < 4.3) a página já nasce no tamanho do teto.
+
+// Páginas = unidades ligadas ao mesmo tempo (o GL garante 16 no fragment shader);
+// o sampler2DArray textures[] do shader tem esse tamanho
+const int MAX_TEXTURE_PAGES = 16;
+
+// Formato de uma camada; só texturas com o mesmo layout dividem uma página
+struct TextureLayout
+{
+    GLenum internalFormat; // GL_RGB8, GL_RGBA8 ou S3TC
+    GLenum format;         // GL_RGB/GL_RGBA; 0 nos formatos comprimidos
+    int width;
+    int height;
+    int levels;
+
+    bool compressed() const { return format == 0; }
+    bool operator==(const TextureLayout &other) const
+    {
+        return internalFormat == other.internalFormat && width == other.width && height == other.height &&
+               levels == other.levels;
+    }
+};
+
+// Bytes de um nível (linhas alinhadas a 4 bytes nos formatos sem compressão)
+size_t textureLevelBytes(const TextureLayout &layout, int level);
+
+// Página da textura provisória: não ocupa camada, o shader usa um cinza fixo
+const int PLACEHOLDER_TEXTURE_PAGE = -2;
+
+struct TextureSlot
+{
+    int page = -1; // -1: sem camada
+    int layer = -1;
+    int generation = 0; // crescimentos da página até a reserva da camada
+};
+
+class TextureArrayPool
+{
+public:
+    using Task = std::function<void()>;
+
+    TextureArrayPool() = default;
+    TextureArrayPool(const TextureArrayPool &) = delete;
+    TextureArrayPool &operator=(const TextureArrayPool &) = delete;
+
+    // Thread principal: reserva uma camada. Se ela abrir uma página nova ou
+    // fizer uma página crescer, create recebe o passo que cria o array (roda
+    // antes dos uploads da camada, no mesmo fluxo ordenado dos outros uploads,
+    // em qualquer contexto GL); senão fica vazio. false se as páginas acabaram.
+    bool allocate(const TextureLayout &layout, TextureSlot &out, Task &create);
+
+    // Thread principal: com as páginas esgotadas, layout de uma página sem
+    // compressão que ainda tem camada livre ou pode crescer, para a imagem ser
+    // reamostrada nele (prefere o mesmo formato e o tamanho mais próximo).
+    // false se não há
+    bool fallbackLayout(const TextureLayout &layout, TextureLayout &out) const;
+
+    // Thread principal: devolve a camada para a página
+    void release(TextureSlot slot);
+
+    // Id GL da página para os passos de upload: preenchido e trocado pelos passos
+    // create, lido só por quem roda no fluxo de uploads
+    std::shared_ptr<GLuint> pageTexture(int page) const;
+
+    // Thread principal: o upload da camada foi publicado (ou descartado). A
+    // página passa a ligar o array em que a camada foi escrita; os anteriores
+    // são apagados
+    void markReady(TextureSlot slot);
+
+    // Liga as páginas prontas nas unidades 0..MAX_TEXTURE_PAGES-1
+    void bind() const;
+
+    size_t pageCount() const { return m_pages.size(); }
+    size_t layerCount() const;
+    size_t reservedBytes() const; // memória dos arrays no tamanho atual
+
+    // Thread principal, com o contexto ainda vivo
+    void destroy();
+
+private:
+    // Array criado por um passo create; texture é preenchido no fluxo de uploads
+    struct Storage
+    {
+        int generation;
+        std::shared_ptr<GLuint> texture;
+    };
+
+    struct Page
+    {
+        TextureLayout layout;
+        int capacity;    // camadas do array mais recente
+        int maxCapacity; // teto de memória da página
+        size_t layerBytes;
+        std::vector<int> freeLayers;
+        std::shared_ptr<GLuint> id; // array atual no fluxo de uploads
+        int generation;             // crescimentos agendados
+        GLuint visible;             // array ligado pela thread principal; 0 até o primeiro publish
+        std::vector<Storage> storages; // arrays criados e ainda não ligados
+    };
+
+    // Passo que cria o array de page com capacity camadas, copiando as
+    // previousCapacity primeiras do array atual
+    static Task storageTask(const Page &page, int previousCapacity, std::shared_ptr<GLuint> texture);
+
+    std::vector<Page> m_pages;
+};
@@ -0,0 +1,157 @@
+#include "TextureCache.h"
+#include "MeshCache.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <stb_image.h>
+
+std::string textureCachePath(const std::string &imagePath)
+{
+    return imagePath + ".texcache";
+}
+
+// Confere o cabeçalho e se todos os níveis cabem em size
+static bool parseTextureCache(const char *data, size_t size, TextureCacheHeader &header, TextureView &view)
+{
+    if (size < sizeof(TextureCacheHeader))
+        return false;
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != TEXTURE_CACHE_MAGIC || header.version != TEXTURE_CACHE_VERSION ||
+        (header.format != TEXTURE_BC1 && header.format != TEXTURE_BC3) || header.width == 0 || header.height == 0 ||
+        header.levelCount == 0 || header.levelCount > TEXTURE_CACHE_MAX_LEVELS)
+        return false;
+
+    view.format = (TextureBlockFormat)header.format;
+    view.width = (int)header.width;
+    view.height = (int)header.height;
+    view.data = (const unsigned char *)data;
+    view.sourceHash = header.sourceHash;
+    view.levels.clear();
+    int w = view.width, h = view.height;
+    for (uint32_t l = 0; l < header.levelCount; ++l)
+    {
+        size_t levelSize = compressedLevelSize(view.format, w, h);
+        if (header.levelOffset[l] + levelSize > size)
+            return false;
+        view.levels.push_back({w, h, (size_t)header.levelOffset[l], levelSize});
+        w = std::max(1, w / 2);
+        h = std::max(1, h / 2);
+    }
+    return true;
+}
+
+static bool mapValidTextureCache(const std::string &imagePath, TextureCacheFile &outCache)
+{
+    MappedFile &file = outCache.file;
+    TextureCacheHeader header;
+    if (!file.open(textureCachePath(imagePath)) || !parseTextureCache(file.data(), file.size(), header, outCache.view))
+        return false;
+
+    uint64_t size, hash;
+    int64_t mtime;
+    if (!cacheSourceKey(imagePath, size, mtime, hash))
+        return false;
+    return header.sourceSize == size && header.sourceMtime == mtime && header.sourceHash == hash;
+}
+
+bool openTextureCache(const std::string &imagePath, TextureCacheFile &outCache)
+{
+    if (mapValidTextureCache(imagePath, outCache))
+        return true;
+    outCache.file.close();
+    outCache.view = TextureView();
+    return false;
+}
+
+bool readTextureCache(const char *data, size_t size, TextureView &outView)
+{
+    TextureCacheHeader header;
+    if (parseTextureCache(data, size, header, outView))
+        return true;
+    outView = TextureView();
+    return false;
+}
+
+bool writeTextureCache(const std::string &imagePath, const CompressedTexture &texture, uint64_t *sourceHash)
+{
+    if (texture.levels.empty() || texture.levels.size() > TEXTURE_CACHE_MAX_LEVELS)
+        return false;
+
+    TextureCacheHeader header = {};
+    header.magic = TEXTURE_CACHE_MAGIC;
+    header.version = TEXTURE_CACHE_VERSION;
+    if (!cacheSourceKey(imagePath, header.sourceSize, header.sourceMtime, header.sourceHash))
+        return false;
+    if (sourceHash)
+        *sourceHash = header.sourceHash;
+    header.format = texture.format;
+    header.width = (uint32_t)texture.width;
+    header.height = (uint32_t)texture.height;
+    header.levelCount = (uint32_t)texture.levels.size();
+    for (size_t l = 0; l < texture.levels.size(); ++l)
+        header.levelOffset[l] = sizeof(header) + texture.levels[l].offset;
+
+    std::string path = textureCachePath(imagePath);
+    // temporário por thread, como em writeMeshCache
+    std::ostringstream tmpName;
+    tmpName << path << ".tmp" << std::this_thread::get_id();
+    std::string tmpPath = tmpName.str();
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out)
+            return false;
+        out.write((const char *)&header, sizeof(header));
+        out.write((const char *)texture.data.data(), (std::streamsize)texture.data.size());
+        if (!out)
+            return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec)
+    {
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+    return true;
+}
+
+TextureView makeTextureView(const CompressedTexture &texture)
+{
+    TextureView view;
+    view.format = texture.format;
+    view.width = texture.width;
+    view.height = texture.height;
+    view.levels = texture.levels;
+    view.data = texture.data.data();
+    return view;
+}
+
+bool loadTextureCached(const std::string &imagePath, TextureCacheFile &cache)
+{
+    if (openTextureCache(imagePath, cache))
+        return true;
+    int width = 0, height = 0, channels = 0;
+    std::shared_ptr<unsigned char> pixels(stbi_load(imagePath.c_str(), &width, &height, &channels, 4), stbi_image_free);
+    if (!pixels)
+        return false;
+    int potWidth = nearestPowerOfTwo(width), potHeight = nearestPowerOfTwo(height);
+    if (potWidth != width || potHeight != height)
+    {
+        std::vector<unsigned char> resized;
+        resampleRGBA(pixels.get(), width, height, potWidth, potHeight, resized);
+        compressTexture(resized.data(), potWidth, potHeight, cache.generated);
+    }
+    else
+        compressTexture(pixels.get(), width, height, cache.generated);
+    uint64_t sourceHash = 0;
+    if (!writeTextureCache(imagePath, cache.generated, &sourceHash))
+        std::cerr << "Aviso: cache de textura nao gravado: " << imagePath << std::endl;
+    cache.view = makeTextureView(cache.generated);
+    cache.view.sourceHash = sourceHash;
+    return true;
+}
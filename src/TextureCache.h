@@ -0,0 +1,73 @@
+#pragma once
+#include "ObjLoader.h"
+#include "TextureCompressor.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Cache de texturas comprimidas: "<imagem>.texcache" ao lado do .png/.jpg.
+// Guarda todos os mipmaps já em BC1/BC3, um nível atrás do outro, para que o
+// arquivo mapeado vá direto para o GL sem decodificar a imagem. Os lados são
+// reamostrados para potências de 2, para que texturas de tamanhos quebrados
+// caiam nas mesmas páginas de TextureArrays.h. Validado como o cache de
+// malhas (tamanho, data e hash da fonte).
+
+// Incrementar sempre que o layout ou a compressão mudarem
+const uint32_t TEXTURE_CACHE_VERSION = 3; // 2: lados em potências de 2, 3: mipmaps em espaço linear
+const uint32_t TEXTURE_CACHE_MAGIC = 0x48435854; // "TXCH"
+const uint32_t TEXTURE_CACHE_MAX_LEVELS = 16;
+
+struct TextureCacheHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t sourceSize;
+    int64_t sourceMtime;
+    uint64_t sourceHash;
+
+    uint32_t format; // TextureBlockFormat
+    uint32_t width;
+    uint32_t height;
+    uint32_t levelCount;
+    uint64_t levelOffset[TEXTURE_CACHE_MAX_LEVELS]; // a partir do início do arquivo
+};
+
+// Níveis prontos para upload, apontando para o cache mapeado ou para um
+// CompressedTexture recém-gerado
+struct TextureView
+{
+    TextureBlockFormat format = TEXTURE_BC1;
+    int width = 0;
+    int height = 0;
+    std::vector<CompressedLevel> levels; // offset relativo a data
+    const unsigned char *data = nullptr;
+    uint64_t sourceHash = 0; // hash da imagem de origem (0 se desconhecido)
+};
+
+struct TextureCacheFile
+{
+    MappedFile file;
+    CompressedTexture generated; // usado quando o cache não existia
+    std::vector<char> unpacked;  // entrada comprimida de um AssetPack
+    TextureView view;
+};
+
+std::string textureCachePath(const std::string &imagePath);
+
+// Abre o cache da imagem se existir e ainda corresponder ao arquivo fonte
+bool openTextureCache(const std::string &imagePath, TextureCacheFile &outCache);
+
+// Monta a view sobre um cache já em memória (entrada de AssetPack), sem
+// conferir a imagem fonte; data precisa viver enquanto a view for usada
+bool readTextureCache(const char *data, size_t size, TextureView &outView);
+
+// Grava o cache (arquivo temporário + rename); sourceHash, se dado, recebe o
+// hash da imagem calculado para o cabeçalho
+bool writeTextureCache(const std::string &imagePath, const CompressedTexture &texture, uint64_t *sourceHash = nullptr);
+
+TextureView makeTextureView(const CompressedTexture &texture);
+
+// Caminho completo usado por loadTexture: tenta o cache, senão decodifica a
+// imagem, reamostra para potências de 2, gera os mipmaps, comprime em BC1/BC3
+// e grava o cache para a próxima execução; false se a imagem não abrir
+bool loadTextureCached(const std::string &imagePath, TextureCacheFile &cache);
@@ -0,0 +1,286 @@
+#include "TextureCompressor.h"
+#include "MipGenerator.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+size_t blockBytes(TextureBlockFormat format)
+{
+    return format == TEXTURE_BC3 ? 16 : 8;
+}
+
+size_t compressedLevelSize(TextureBlockFormat format, int width, int height)
+{
+    return (size_t)((width + 3) / 4) * ((height + 3) / 4) * blockBytes(format);
+}
+
+void downsampleRGBA(const unsigned char *src, int width, int height, std::vector<unsigned char> &dst)
+{
+    int w = std::max(1, width / 2), h = std::max(1, height / 2);
+    dst.resize((size_t)w * h * 4);
+    for (int y = 0; y < h; ++y)
+    {
+        // lados ímpares ou de tamanho 1: o segundo pixel repete o primeiro
+        int y0 = std::min(y * 2, height - 1), y1 = std::min(y * 2 + 1, height - 1);
+        for (int x = 0; x < w; ++x)
+        {
+            int x0 = std::min(x * 2, width - 1), x1 = std::min(x * 2 + 1, width - 1);
+            const unsigned char *a = src + ((size_t)y0 * width + x0) * 4;
+            const unsigned char *b = src + ((size_t)y0 * width + x1) * 4;
+            const unsigned char *c = src + ((size_t)y1 * width + x0) * 4;
+            const unsigned char *d = src + ((size_t)y1 * width + x1) * 4;
+            unsigned char *out = &dst[((size_t)y * w + x) * 4];
+            for (int k = 0; k < 4; ++k)
+                out[k] = (unsigned char)((a[k] + b[k] + c[k] + d[k] + 2) / 4);
+        }
+    }
+}
+
+void resampleRGBA(const unsigned char *src, int width, int height, int newWidth, int newHeight,
+                  std::vector<unsigned char> &dst)
+{
+    dst.resize((size_t)newWidth * newHeight * 4);
+    float scaleX = (float)width / newWidth, scaleY = (float)height / newHeight;
+    for (int y = 0; y < newHeight; ++y)
+    {
+        // centro do pixel de destino na imagem de origem
+        float sy = std::min(std::max((y + 0.5f) * scaleY - 0.5f, 0.0f), (float)(height - 1));
+        int y0 = (int)sy, y1 = std::min(y0 + 1, height - 1);
+        float fy = sy - y0;
+        for (int x = 0; x < newWidth; ++x)
+        {
+            float sx = std::min(std::max((x + 0.5f) * scaleX - 0.5f, 0.0f), (float)(width - 1));
+            int x0 = (int)sx, x1 = std::min(x0 + 1, width - 1);
+            float fx = sx - x0;
+            const unsigned char *a = src + ((size_t)y0 * width + x0) * 4;
+            const unsigned char *b = src + ((size_t)y0 * width + x1) * 4;
+            const unsigned char *c = src + ((size_t)y1 * width + x0) * 4;
+            const unsigned char *d = src + ((size_t)y1 * width + x1) * 4;
+            unsigned char *out = &dst[((size_t)y * newWidth + x) * 4];
+            for (int k = 0; k < 4; ++k)
+            {
+                float top = a[k] + (b[k] - a[k]) * fx, bottom = c[k] + (d[k] - c[k]) * fx;
+                out[k] = (unsigned char)(top + (bottom - top) * fy + 0.5f);
+            }
+        }
+    }
+}
+
+int nearestPowerOfTwo(int size)
+{
+    int power = 1;
+    while (power * 2 <= size)
+        power *= 2;
+    // entre power e 2*power: escolhe o mais perto
+    return (size - power > power * 2 - size) ? power * 2 : power;
+}
+
+static uint16_t packRGB565(const float c[3])
+{
+    int r = (int)std::lround(std::min(std::max(c[0], 0.0f), 255.0f) * 31.0f / 255.0f);
+    int g = (int)std::lround(std::min(std::max(c[1], 0.0f), 255.0f) * 63.0f / 255.0f);
+    int b = (int)std::lround(std::min(std::max(c[2], 0.0f), 255.0f) * 31.0f / 255.0f);
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+static void unpackRGB565(uint16_t c, int out[3])
+{
+    int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+    out[0] = (r << 3) | (r >> 2);
+    out[1] = (g << 2) | (g >> 4);
+    out[2] = (b << 3) | (b >> 2);
+}
+
+// Bloco de cor de 8 bytes: extremos na direção principal das cores do bloco
+// (covariância + iteração de potência) e cada pixel no mais próximo dos 4 tons
+static void compressColorBlock(const unsigned char block[16][4], unsigned char *out)
+{
+    float mean[3] = {0, 0, 0};
+    for (int i = 0; i < 16; ++i)
+        for (int k = 0; k < 3; ++k)
+            mean[k] += block[i][k] / 16.0f;
+
+    float cov[6] = {0, 0, 0, 0, 0, 0}; // rr rg rb gg gb bb
+    for (int i = 0; i < 16; ++i)
+    {
+        float r = block[i][0] - mean[0], g = block[i][1] - mean[1], b = block[i][2] - mean[2];
+        cov[0] += r * r;
+        cov[1] += r * g;
+        cov[2] += r * b;
+        cov[3] += g * g;
+        cov[4] += g * b;
+        cov[5] += b * b;
+    }
+    float axis[3] = {1.0f, 1.0f, 1.0f};
+    for (int iteration = 0; iteration < 8; ++iteration)
+    {
+        float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+        float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+        float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+        float length = std::max(std::fabs(x), std::max(std::fabs(y), std::fabs(z)));
+        if (length <= 0.0f)
+            break;
+        axis[0] = x / length;
+        axis[1] = y / length;
+        axis[2] = z / length;
+    }
+
+    float minT = 1e30f, maxT = -1e30f;
+    for (int i = 0; i < 16; ++i)
+    {
+        float t = (block[i][0] - mean[0]) * axis[0] + (block[i][1] - mean[1]) * axis[1] + (block[i][2] - mean[2]) * axis[2];
+        minT = std::min(minT, t);
+        maxT = std::max(maxT, t);
+    }
+    float axisLength2 = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+    float high[3], low[3];
+    for (int k = 0; k < 3; ++k)
+    {
+        high[k] = mean[k] + axis[k] * maxT / axisLength2;
+        low[k] = mean[k] + axis[k] * minT / axisLength2;
+    }
+
+    uint16_t c0 = packRGB565(high), c1 = packRGB565(low);
+    // c0 > c1 seleciona o modo de 4 cores no BC1
+    if (c0 < c1)
+        std::swap(c0, c1);
+
+    uint32_t indices = 0;
+    if (c0 != c1)
+    {
+        int p[4][3];
+        unpackRGB565(c0, p[0]);
+        unpackRGB565(c1, p[1]);
+        for (int k = 0; k < 3; ++k)
+        {
+            p[2][k] = (2 * p[0][k] + p[1][k]) / 3;
+            p[3][k] = (p[0][k] + 2 * p[1][k]) / 3;
+        }
+        for (int i = 0; i < 16; ++i)
+        {
+            int best = 0, bestDistance = 1 << 30;
+            for (int j = 0; j < 4; ++j)
+            {
+                int dr = block[i][0] - p[j][0], dg = block[i][1] - p[j][1], db = block[i][2] - p[j][2];
+                int distance = dr * dr + dg * dg + db * db;
+                if (distance < bestDistance)
+                {
+                    bestDistance = distance;
+                    best = j;
+                }
+            }
+            indices |= (uint32_t)best << (i * 2);
+        }
+    }
+    out[0] = (unsigned char)(c0 & 0xFF);
+    out[1] = (unsigned char)(c0 >> 8);
+    out[2] = (unsigned char)(c1 & 0xFF);
+    out[3] = (unsigned char)(c1 >> 8);
+    for (int k = 0; k < 4; ++k)
+        out[4 + k] = (unsigned char)(indices >> (k * 8));
+}
+
+// Bloco de alfa de 8 bytes do BC3: extremos mínimo e máximo, 8 níveis entre eles
+static void compressAlphaBlock(const unsigned char block[16][4], unsigned char *out)
+{
+    int a0 = 0, a1 = 255;
+    for (int i = 0; i < 16; ++i)
+    {
+        a0 = std::max(a0, (int)block[i][3]);
+        a1 = std::min(a1, (int)block[i][3]);
+    }
+    out[0] = (unsigned char)a0;
+    out[1] = (unsigned char)a1;
+
+    uint64_t indices = 0;
+    if (a0 != a1)
+    {
+        int levels[8] = {a0, a1};
+        for (int j = 1; j < 7; ++j)
+            levels[j + 1] = ((7 - j) * a0 + j * a1) / 7;
+        for (int i = 0; i < 16; ++i)
+        {
+            int best = 0, bestDistance = 256;
+            for (int j = 0; j < 8; ++j)
+            {
+                int distance = std::abs(block[i][3] - levels[j]);
+                if (distance < bestDistance)
+                {
+                    bestDistance = distance;
+                    best = j;
+                }
+            }
+            indices |= (uint64_t)best << (i * 3);
+        }
+    }
+    for (int k = 0; k < 6; ++k)
+        out[2 + k] = (unsigned char)(indices >> (k * 8));
+}
+
+void compressLevel(const unsigned char *rgba, int width, int height, TextureBlockFormat format, unsigned char *out)
+{
+    size_t bytes = blockBytes(format);
+    unsigned char block[16][4];
+    for (int by = 0; by < height; by += 4)
+    {
+        for (int bx = 0; bx < width; bx += 4)
+        {
+            for (int i = 0; i < 16; ++i)
+            {
+                int x = std::min(bx + i % 4, width - 1), y = std::min(by + i / 4, height - 1);
+                memcpy(block[i], rgba + ((size_t)y * width + x) * 4, 4);
+            }
+            if (format == TEXTURE_BC3)
+            {
+                compressAlphaBlock(block, out);
+                compressColorBlock(block, out + 8);
+            }
+            else
+                compressColorBlock(block, out);
+            out += bytes;
+        }
+    }
+}
+
+void compressTexture(const unsigned char *rgba, int width, int height, CompressedTexture &out)
+{
+    out.format = TEXTURE_BC1;
+    for (size_t i = 0; i < (size_t)width * height; ++i)
+    {
+        if (rgba[i * 4 + 3] != 255)
+        {
+            out.format = TEXTURE_BC3;
+            break;
+        }
+    }
+    out.width = width;
+    out.height = height;
+    out.levels.clear();
+
+    size_t total = 0;
+    for (int w = width, h = height;; w = std::max(1, w / 2), h = std::max(1, h / 2))
+    {
+        size_t size = compressedLevelSize(out.format, w, h);
+        out.levels.push_back({w, h, total, size});
+        total += size;
+        if (w == 1 && h == 1)
+            break;
+    }
+    out.data.resize(total);
+
+    std::vector<unsigned char> current, next;
+    const unsigned char *level = rgba;
+    for (size_t l = 0; l < out.levels.size(); ++l)
+    {
+        const CompressedLevel &info = out.levels[l];
+        compressLevel(level, info.width, info.height, out.format, out.data.data() + info.offset);
+        if (l + 1 < out.levels.size())
+        {
+            const CompressedLevel &below = out.levels[l + 1];
+            next.resize((size_t)below.width * below.height * 4);
+            downsampleLinear(level, (size_t)info.width * 4, info.width, info.height, 4, next.data(), (size_t)below.width * 4);
+            current.swap(next);
+            level = current.data();
+        }
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Compressão de texturas em blocos (S3TC) feita na CPU, uma vez por imagem,
+// para o cache de TextureCache.h. Cada bloco de 4x4 pixels vira 8 bytes (BC1,
+// RGB) ou 16 bytes (BC3, RGBA com alfa de 8 níveis).
+
+enum TextureBlockFormat : uint32_t
+{
+    TEXTURE_BC1 = 1, // GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+    TEXTURE_BC3 = 3, // GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+};
+
+// Bytes por bloco de 4x4 e tamanho de um nível width x height
+size_t blockBytes(TextureBlockFormat format);
+size_t compressedLevelSize(TextureBlockFormat format, int width, int height);
+
+// Um nível da cadeia de mipmaps já comprimido
+struct CompressedLevel
+{
+    int width;
+    int height;
+    size_t offset; // em CompressedTexture::data
+    size_t size;
+};
+
+struct CompressedTexture
+{
+    TextureBlockFormat format = TEXTURE_BC1;
+    int width = 0;
+    int height = 0;
+    std::vector<CompressedLevel> levels; // do maior para o 1x1
+    std::vector<unsigned char> data;
+};
+
+// Próximo nível (metade de cada lado, mínimo 1) com filtro de caixa 2x2 direto
+// nos valores sRGB, como glGenerateMipmap faz em RGB8; pixels RGBA8. Só serve
+// de referência para o LoadBenchmark: a cadeia usa downsampleLinear
+// (MipGenerator.h).
+void downsampleRGBA(const unsigned char *src, int width, int height, std::vector<unsigned char> &dst);
+
+// Reamostra com filtro bilinear para newWidth x newHeight; pixels RGBA8
+void resampleRGBA(const unsigned char *src, int width, int height, int newWidth, int newHeight,
+                  std::vector<unsigned char> &dst);
+
+// Potência de 2 mais próxima de size (mínimo 1)
+int nearestPowerOfTwo(int size);
+
+// Comprime um nível RGBA8 inteiro; as bordas de blocos incompletos repetem o
+// último pixel
+void compressLevel(const unsigned char *rgba, int width, int height, TextureBlockFormat format, unsigned char *out);
+
+// Gera todos os mipmaps em espaço linear e comprime cada um. BC3 só se algum pixel tiver alfa
+// diferente de 255, senão BC1.
+void compressTexture(const unsigned char *rgba, int width, int height, CompressedTexture &out);
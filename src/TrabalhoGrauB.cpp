@@ -1,14 +1,69 @@
 #include "Camera.h"
 #include "Camera.cpp"
+#include "ShaderProgram.h"
+#include "ShaderProgram.cpp"
+#include "FrameConstants.h"
+#include "FrameConstants.cpp"
+#include "MaterialBuffer.h"
+#include "MaterialBuffer.cpp"
+#include "GeometryPool.h"
+#include "GeometryPool.cpp"
+#include "IndirectDrawBuffer.h"
+#include "IndirectDrawBuffer.cpp"
+#include "ObjLoader.h"
+#include "ObjLoader.cpp"
+#include "AssetPack.h"
+#include "AssetPack.cpp"
+#include "MeshOptimizer.h"
+#include "MeshOptimizer.cpp"
+#include "MeshSimplifier.h"
+#include "MeshSimplifier.cpp"
+#include "Meshlets.h"
+#include "Meshlets.cpp"
+#include "MeshCache.h"
+#include "MeshCache.cpp"
+#include "VertexFormat.h"
+#include "VertexFormat.cpp"
+#include "MtlLoader.h"
+#include "MtlLoader.cpp"
+#include "AssetRegistry.h"
+#include "AssetRegistry.cpp"
+#include "AsyncLoader.h"
+#include "AsyncLoader.cpp"
+#include "GLUploader.h"
+#include "GLUploader.cpp"
+#include "GLExt.h"
+#include "GLExt.cpp"
+#include "PixelUploadRing.h"
+#include "PixelUploadRing.cpp"
+#include "UploadTimer.h"
+#include "UploadTimer.cpp"
+#include "UploadScheduler.h"
+#include "UploadScheduler.cpp"
+#include "MipGenerator.h"
+#include "MipGenerator.cpp"
+#include "TextureCompressor.h"
+#include "TextureCompressor.cpp"
+#include "TextureCache.h"
+#include "TextureCache.cpp"
+#include "TextureArrays.h"
+#include "TextureArrays.cpp"
+#include "SceneReader.h"
+#include "SceneReader.cpp"
+#include "FileWatcher.h"
+#include "FileWatcher.cpp"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <vector>
 #include <string>
 #include <algorithm>
-
-#include "../Common/json.hpp"
-using json = nlohmann::json;
+#include <memory>
+#include <filesystem>
+#include <cstring>
+#include <chrono>
+#include <thread>
+#include <tuple>
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -22,21 +77,100 @@ using json = nlohmann::json;
 
 using namespace std;
 
-struct Material
+// O que o laço de renderização precisa saber da malha enviada por loadGeometry.
+// Compartilhada por todos os objetos que usam o mesmo .obj (ver AssetRegistry.h);
+// os buffers são liberados quando o último objeto solta o handle.
+struct MeshGeometry
+{
+    bool ready = false;  // upload feito; antes disso o objeto usa o cubo provisório
+    bool failed = false; // .obj não abriu: o objeto não é desenhado
+    GLuint VAO = 0, VBO = 0, EBO = 0;   // no pool: VAO do pool, sem VBO/EBO próprios
+    GeometryPool *pool = nullptr;       // nullptr: buffers próprios
+    GeometryRange poolRange;            // faixa da malha no pool
+    GLenum indexType = GL_UNSIGNED_INT; // GL_UNSIGNED_SHORT ou GL_UNSIGNED_INT
+    size_t indexSize = 4;
+    glm::mat4 dequantize = glm::mat4(1.0f); // identidade no formato float
+    glm::vec3 boundsMin = glm::vec3(0.0f);
+    glm::vec3 boundsMax = glm::vec3(0.0f);
+    std::vector<Submesh> submeshes;     // um por material em cada nível
+    std::vector<std::string> materials; // nomes de usemtl; Submesh::material indexa esta lista
+    std::string materialLibrary;        // mtllib do .obj, já com o caminho da pasta
+    std::vector<MeshLod> lods;          // faixas do EBO, da malha original à mais simples
+    std::vector<Meshlet> meshlets;
+
+    MeshGeometry() = default;
+    MeshGeometry(const MeshGeometry &) = delete;
+    MeshGeometry &operator=(const MeshGeometry &) = delete;
+    ~MeshGeometry()
+    {
+        if (pool)
+        {
+            pool->release(poolRange);
+            return;
+        }
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteBuffers(1, &VBO);
+        glDeleteBuffers(1, &EBO);
+    }
+};
+
+// Páginas GL_TEXTURE_2D_ARRAY onde ficam todas as texturas da cena
+TextureArrayPool texturePool;
+
+// Textura compartilhada, liberada junto com o último handle
+struct Texture
+{
+    TextureSlot slot; // page == -1 enquanto carrega
+    bool failed = false;
+    int width = 0;
+    int height = 0;
+
+    Texture() = default;
+    Texture(const Texture &) = delete;
+    Texture &operator=(const Texture &) = delete;
+    ~Texture() { texturePool.release(slot); }
+};
+
+// Todos os materiais carregados, indexados por draw (binding 0 do SSBO)
+MaterialBuffer materialBuffer;
+
+// Biblioteca .mtl com a textura difusa de cada material (nullptr sem map_Kd)
+// e o índice de cada material no materialBuffer
+struct MaterialLibrary
+{
+    std::vector<Material> materials;
+    std::vector<std::shared_ptr<Texture>> diffuse;
+    std::vector<int> gpuIndex;
+
+    MaterialLibrary() = default;
+    MaterialLibrary(const MaterialLibrary &) = delete;
+    MaterialLibrary &operator=(const MaterialLibrary &) = delete;
+    ~MaterialLibrary()
+    {
+        for (int index : gpuIndex)
+            materialBuffer.release(index);
+    }
+};
+
+// Malhas, materiais e texturas carregados, indexados por caminho e conteúdo:
+// mil objetos com o mesmo .obj e o mesmo map_Kd custam uma malha e uma textura
+struct AssetRegistry
 {
-    glm::vec3 Ka;
-    glm::vec3 Kd;
-    glm::vec3 Ks;
-    float Ns;
-    std::string map_Kd;
-    std::string map_Bump;
-    std::string map_Ks;
+    AssetCache<MeshGeometry> meshes;
+    AssetCache<MaterialLibrary> materials;
+    AssetCache<Texture> textures;
 };
+
 struct AnimatedObject
 {
-    GLuint VAO;
-    GLuint textureID;
-    size_t vertexCount;
+    std::string objFile;      // como veio da cena, para comparar na recarga
+    std::string mtlFile;      // vazio: mtllib do .obj
+    std::string vertexFormat;
+    std::shared_ptr<MeshGeometry> mesh;
+    std::shared_ptr<MaterialLibrary> materials;
+    std::vector<int> materialSlots; // por material da malha: índice em materials (-1 = padrão)
+    bool materialsResolved = false; // materialSlots preenchido (precisa da malha pronta)
+    unsigned currentLod = 0;        // por objeto: a malha é compartilhada
     glm::vec3 position;
     glm::vec3 rotation = glm::vec3(0.0f); // em graus
     float scale = 1.0f;
@@ -48,29 +182,57 @@ struct AnimatedObject
 std::vector<AnimatedObject> objects;
 int selectedObjectIndex = 0;
 bool addWaypointKeyPressed = false;
+bool meshletCulling = true; // tecla C liga/desliga o descarte por objeto e por meshlet
+AssetRegistry assets;
+const Material defaultMaterial; // submesh sem material correspondente no .mtl
 
-struct Vertex
+Camera *g_camera = nullptr;
+AsyncLoader *g_loader = nullptr;
+GLUploader *g_uploader = nullptr;
+bool uploadThreadEnabled = true; // false: buffers e texturas enviados pela thread principal
+UploadScheduler *g_scheduler = nullptr;
+double uploadBudgetMs = 2.0;                   // tempo de upload por quadro
+size_t uploadBudgetBytes = 16 * 1024 * 1024;   // teto de bytes por quadro, qualquer que seja a taxa medida
+std::shared_ptr<MeshGeometry> placeholderMesh; // cubo e textura cinza desenhados enquanto os recursos carregam
+std::shared_ptr<Texture> placeholderTexture;
+int defaultMaterialIndex = -1; // defaultMaterial com a textura provisória
+std::vector<std::weak_ptr<MaterialLibrary>> materialsAwaitingTextures; // página/camada ainda por atualizar no buffer
+PixelUploadRing *g_pixelRing = nullptr; // nullptr sem GL 4.4: texturas enviadas direto da memória da CPU
+size_t ringTextureUploads = 0, directTextureUploads = 0, compressedTextureUploads = 0;
+AssetPack *g_assetPack = nullptr;     // ../assets/assets.pack (AssetPacker), quando existir
+bool hotReloadEnabled = true;           // observa a cena e os assets e recarrega o que mudar
+FileWatcher *g_watcher = nullptr;
+SceneSettings sceneSettings; // luz e câmera da última leitura da cena
+
+// Recurso recarregado esperando o upload: até lá os objetos continuam com o antigo
+template <typename T>
+struct PendingReload
 {
-    glm::vec3 position;
-    glm::vec3 normal;
-    glm::vec2 texCoord;
+    std::shared_ptr<T> previous;
+    std::shared_ptr<T> next;
 };
-
-Camera *g_camera = nullptr;
+std::vector<PendingReload<MeshGeometry>> meshReloads;
+
+// Malhas sub-alocadas de buffers compartilhados e desenhadas por
+// glMultiDrawElementsIndirect: um pool por formato de vértice e tipo de índice,
+// [formato][índices de 16 bits], criados antes da thread de upload
+GeometryPool geometryPools[2][2];
+bool geometryPoolEnabled = true;           // false: cada malha com os próprios buffers
+size_t geometryPoolVertices = 1 << 20;     // capacidade de cada pool
+size_t geometryPoolIndices = 4 << 20;
+bool geometryPoolFullReported = false;
+std::vector<PendingReload<Texture>> textureReloads;
 
 void mouse_callback(GLFWwindow *window, double xpos, double ypos);
 void key_callback(GLFWwindow *window, int key, int scancode, int action, int mods);
 
-GLuint setupShader();
-GLuint loadGeometry(
-    const std::string &objPath,
-    const Material &mat,
-    const std::string &texFolder,
-    GLuint &outTexDiffuseID,
-    GLuint &outTexNormalID,
-    GLuint &outTexSpecularID,
-    size_t &outVertexCount);
-GLuint loadTexture(const std::string &filePath, int &width, int &height);
+std::shared_ptr<MeshGeometry> loadGeometry(const std::string &objPath, VertexFormat format);
+std::shared_ptr<MeshGeometry> createPlaceholderMesh();
+std::shared_ptr<MaterialLibrary> loadMaterials(const std::string &mtlPath);
+std::shared_ptr<Texture> loadTexture(const std::string &filePath);
+std::shared_ptr<Texture> createPlaceholderTexture();
+void createGeometryPools();
+void benchmarkMipGeneration(const std::string &filePath);
 
 const GLuint WIDTH = 1000, HEIGHT = 1000;
 
@@ -94,19 +256,33 @@ layout (location = 0) in vec3 position;
 layout (location = 2) in vec2 texCoord;
 layout (location = 3) in vec3 normal;
 
+layout (location = 4) in uint drawIndex; // registro da instância (IndirectDrawBuffer)
+
 out vec2 fragTexCoord;
 out vec3 FragPos;
 out vec3 Normal;
+flat out int materialIndex;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+// Registros do quadro (DrawRecord em IndirectDrawBuffer.h)
+struct DrawData
+{
+    mat4 model;
+    mat4 dequantize; // da malha; identidade no formato float
+    ivec4 material;  // x = índice no buffer de materiais
+};
+layout (std430, binding = 1) readonly buffer Draws
+{
+    DrawData draws[];
+};
 
 void main()
 {
-    vec4 worldPos = model * vec4(position, 1.0);
+    DrawData draw = draws[drawIndex];
+    vec4 worldPos = draw.model * draw.dequantize * vec4(position, 1.0);
     FragPos = worldPos.xyz;
-    Normal = mat3(transpose(inverse(model))) * normal;
+    // escala sempre uniforme: mat3(model) tem a direção da inversa transposta
+    Normal = mat3(draw.model) * normal;
+    materialIndex = draw.material.x;
     fragTexCoord = vec2(texCoord.x, 1 - texCoord.y);
     gl_Position = projection * view * worldPos;
 }
@@ -118,30 +294,41 @@ const char *fragmentShaderSource = R"glsl(
     in vec3 FragPos;
     in vec3 Normal;
     in vec2 fragTexCoord;
+    flat in int materialIndex;
     
     out vec4 color;
     
-    // Luz e câmera
-    uniform vec3 lightPos;
-    uniform vec3 viewPos;
-    uniform vec3 lightColor;
-    uniform float ambientStrength;
-uniform float diffuseStrength;
-uniform float specularStrength;
-
-    
-    // Textura difusa
-    uniform sampler2D texture1;
+    // Luz e câmera vêm do bloco FrameConstants (FRAME_CONSTANTS_GLSL)
     
-    //Uniforms do material (vindos do .mtl)
-    uniform vec3 Ka;       // Ambiente
-    uniform vec3 Kd;       // Difusa
-    uniform vec3 Ks;       // Especular
-    uniform float Ns;      // Brilho
+    // Páginas de textura (MAX_TEXTURE_PAGES)
+    uniform sampler2DArray textures[16];
+
+    // Materiais carregados (GpuMaterial em MaterialBuffer.h); o registro do draw só traz o índice
+    struct MaterialData
+    {
+        vec4 Ka;       // Ambiente
+        vec4 Kd;       // Difusa
+        vec4 Ks;       // Especular; w = brilho (Ns)
+        ivec4 textureSlot; // x = página (-1: sem textura, -2: provisória), y = camada
+    };
+    layout (std430, binding = 0) readonly buffer Materials
+    {
+        MaterialData materials[];
+    };
     
     void main()
     {
-        vec3 texColor = texture(texture1, fragTexCoord).rgb;
+        MaterialData material = materials[materialIndex];
+        vec3 Ka = material.Ka.rgb;
+        vec3 Kd = material.Kd.rgb;
+        vec3 Ks = material.Ks.rgb;
+        float Ns = material.Ks.w;
+
+        vec3 texColor = vec3(0.0);
+        if (material.textureSlot.x >= 0)
+            texColor = texture(textures[material.textureSlot.x], vec3(fragTexCoord, float(material.textureSlot.y))).rgb;
+        else if (material.textureSlot.x == -2)
+            texColor = vec3(160.0 / 255.0); // PLACEHOLDER_TEXTURE_PAGE
     
         // Vetores de iluminação
         vec3 norm = normalize(Normal);
@@ -164,120 +351,308 @@ vec3 specular = Ks * spec * lightColor * specularStrength;
     }
     )glsl";
 
-Material loadMaterial(const std::string &mtlPath)
+// Lê a cena e a compara, objeto a objeto na ordem do arquivo, com a que já está
+// carregada (na recarga): um objeto com o mesmo .obj, .mtl e formato de vértice
+// mantém os recursos, e também a animação se os waypoints não mudaram, e só
+// recebe a nova transformação; os outros são carregados
+void loadSceneFromFile(const std::string &filename, const std::string &assetPath)
 {
-    // Inicializa o Material com valores padrão
-    Material mat;
-    mat.Ka = glm::vec3(1.0f);
-    mat.Kd = glm::vec3(1.0f);
-    mat.Ks = glm::vec3(1.0f);
-    mat.Ns = 32.0f;
-    mat.map_Kd = "";
-    // Abre o arquivo .mtl
-    std::ifstream mtlFile(mtlPath);
-    if (!mtlFile.is_open())
+    auto start = std::chrono::steady_clock::now();
+    AssetBytes packed;
+    MappedFile file;
+    const char *data = nullptr;
+    size_t size = 0;
+    if (g_watcher)
+        g_watcher->watch(filename);
+    if (g_assetPack && g_assetPack->read(filename, ASSET_PACK_RAW, packed))
     {
-        std::cerr << "Erro ao abrir MTL: " << mtlPath << std::endl;
-        return mat;
+        data = packed.data;
+        size = packed.size;
     }
-
-    std::string line;
-    while (getline(mtlFile, line))
+    else if (file.open(filename))
+    {
+        data = file.data();
+        size = file.size();
+    }
+    else
     {
-        std::istringstream iss(line);
-        std::string type;
-        iss >> type;
+        std::cerr << "Erro ao abrir arquivo de cena: " << filename << std::endl;
+        return;
+    }
+
+    // os recursos da cena anterior só são liberados se a nova não os usar
+    std::vector<AnimatedObject> previous;
+    previous.swap(objects);
+    bool reloading = !previous.empty();
+    size_t kept = 0;
+
+    // cada objeto é carregado assim que o leitor o entrega, enquanto o resto
+    // do arquivo ainda está sendo lido
+    SceneSettings settings;
+    bool ok = readScene(data, size, settings, [&](SceneObjectRecord &record)
+                        {
+        std::string objFile = assetPath + "/" + record.file;
+        std::string mtlFile = record.material.empty() ? std::string() : assetPath + "/" + record.material;
+
+        size_t index = objects.size();
+        if (index < previous.size() && previous[index].objFile == objFile && previous[index].mtlFile == mtlFile &&
+            previous[index].vertexFormat == record.vertexFormat)
+        {
+            AnimatedObject &object = previous[index];
+            object.position = record.position;
+            object.rotation = record.rotation;
+            object.scale = record.scale;
+            if (object.waypoints != record.waypoints)
+            {
+                object.waypoints = std::move(record.waypoints);
+                object.currentWaypoint = 0;
+                object.t = 0.0f;
+            }
+            objects.push_back(std::move(object));
+            ++kept;
+            return;
+        }
+
+        // "vertexFormat": "packed" usa vértices de 16 bytes em vez de 32
+        VertexFormat format = parseVertexFormat(record.vertexFormat);
+
+        AnimatedObject object;
+        object.objFile = objFile;
+        object.mtlFile = mtlFile;
+        object.vertexFormat = record.vertexFormat;
+        object.mesh = assets.meshes.acquire(objFile, record.vertexFormat, [format](const std::string &path)
+                                            { return loadGeometry(path, format); });
+
+        // "material" da cena tem prioridade sobre o mtllib do .obj (que só é
+        // conhecido depois do parsing, em resolveMaterials)
+        if (!mtlFile.empty())
+            object.materials = assets.materials.acquire(mtlFile, "", loadMaterials);
+
+        object.position = record.position;
+        object.rotation = record.rotation;
+        object.scale = record.scale;
+        object.waypoints = std::move(record.waypoints);
+
+        objects.push_back(std::move(object)); });
+    file.close();
+
+    // arquivo salvo pela metade ou com erro: os objetos depois do erro ficam como estavam
+    if (!ok && reloading)
+        for (size_t i = objects.size(); i < previous.size(); ++i)
+            objects.push_back(std::move(previous[i]));
+    previous.clear();
+    if (!objects.empty())
+        selectedObjectIndex = std::min(selectedObjectIndex, (int)objects.size() - 1);
+
+    if (reloading)
+        std::cout << "Cena recarregada em "
+                  << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count()
+                  << " ms: " << kept << " de " << objects.size() << " objetos mantidos" << std::endl;
+    std::cout << "Recursos: " << assets.meshes.liveCount() << " malhas (" << assets.meshes.hits() << " reaproveitadas), "
+              << assets.materials.liveCount() << " bibliotecas .mtl (" << assets.materials.hits() << " reaproveitadas), "
+              << assets.textures.liveCount() << " texturas (" << assets.textures.hits() << " reaproveitadas)" << std::endl;
+
+    // Atualiza posição da câmera; na recarga só se ela mudou no arquivo, para
+    // não desfazer o movimento do usuário
+    if (g_camera && settings.hasCamera &&
+        (!reloading || !sceneSettings.hasCamera || settings.cameraPosition != sceneSettings.cameraPosition))
+        g_camera->setPosition(settings.cameraPosition);
+    sceneSettings = settings;
+}
 
-        if (type == "Ka")
-            iss >> mat.Ka.r >> mat.Ka.g >> mat.Ka.b;
-        else if (type == "Kd")
-            iss >> mat.Kd.r >> mat.Kd.g >> mat.Kd.b;
-        else if (type == "Ks")
-            iss >> mat.Ks.r >> mat.Ks.g >> mat.Ks.b;
-        else if (type == "Ns")
-            iss >> mat.Ns;
-        else if (type == "map_Kd")
-            iss >> mat.map_Kd;
+// Com a malha pronta, cada material dela procura o seu newmtl; sem
+// correspondência (faces sem usemtl, por exemplo) usa o primeiro da biblioteca
+void resolveMaterials(AnimatedObject &object)
+{
+    const MeshGeometry &mesh = *object.mesh;
+    if (!object.materials && !mesh.materialLibrary.empty())
+        object.materials = assets.materials.acquire(mesh.materialLibrary, "", loadMaterials);
 
-        else if (type == "map_Bump" || type == "bump")
-            iss >> mat.map_Bump;
-        else if (type == "map_Ks")
-            iss >> mat.map_Ks;
-        std::cout << "Textura difusa carregada do .mtl: " << mat.map_Kd << std::endl;
+    object.materialSlots.clear();
+    for (const std::string &name : mesh.materials)
+    {
+        int slot = -1;
+        if (object.materials && !object.materials->materials.empty())
+            slot = std::max(0, findMaterial(object.materials->materials, name));
+        object.materialSlots.push_back(slot);
+        if (slot < 0 || !object.materials->diffuse[slot])
+            std::cerr << "Aviso: textura difusa não carregada corretamente para o material '" << name << "'" << std::endl;
     }
+    object.materialsResolved = true;
+}
 
-    mtlFile.close();
-    return mat;
+// Registro do material no buffer; texturas ainda carregando usam a provisória
+GpuMaterial gpuMaterial(const Material &mat, const Texture *texture)
+{
+    if (texture && texture->slot.page < 0 && !texture->failed)
+        texture = placeholderTexture.get();
+    GpuMaterial gpu;
+    gpu.Ka = glm::vec4(mat.Ka, 1.0f);
+    gpu.Kd = glm::vec4(mat.Kd, 1.0f);
+    gpu.Ks = glm::vec4(mat.Ks, mat.Ns);
+    gpu.texturePage = texture ? texture->slot.page : -1;
+    gpu.textureLayer = texture ? texture->slot.layer : 0;
+    return gpu;
 }
 
-void loadSceneFromFile(const std::string &filename, const std::string &assetPath, std::vector<Material> &materials, GLuint shaderID)
+// Uma vez por quadro: atualiza no buffer a página e a camada das texturas que
+// terminaram de carregar; a biblioteca sai da lista quando todas terminaram
+void refreshMaterialTextures()
 {
-    std::ifstream file(filename);
-    if (!file.is_open())
+    for (size_t i = 0; i < materialsAwaitingTextures.size();)
     {
-        std::cerr << "Erro ao abrir arquivo de cena: " << filename << std::endl;
-        return;
+        std::shared_ptr<MaterialLibrary> library = materialsAwaitingTextures[i].lock();
+        bool done = true;
+        for (size_t m = 0; library && m < library->materials.size(); ++m)
+        {
+            const Texture *texture = library->diffuse[m].get();
+            materialBuffer.set(library->gpuIndex[m], gpuMaterial(library->materials[m], texture));
+            done = done && (!texture || texture->slot.page >= 0 || texture->failed);
+        }
+        if (done)
+        {
+            materialsAwaitingTextures[i] = materialsAwaitingTextures.back();
+            materialsAwaitingTextures.pop_back();
+        }
+        else
+            ++i;
     }
-    // operador >> da biblioteca automaticamente faz o parsing do JSON para o objeto scene
-    json scene;
-    file >> scene;
+}
 
-    objects.clear();
-    materials.clear();
+// Enfileira a troca de previous por next; se previous ainda é o resultado de
+// uma recarga pendente (o arquivo foi salvo de novo), ela passa a esperar next
+template <typename T>
+static void queueReload(std::vector<PendingReload<T>> &pending, std::shared_ptr<T> previous, std::shared_ptr<T> next)
+{
+    for (PendingReload<T> &reload : pending)
+    {
+        if (reload.next == previous)
+        {
+            reload.next = next;
+            return;
+        }
+    }
+    pending.push_back({previous, next});
+}
 
-    for (const auto &obj : scene["objects"])
+// Completion de um carregamento, com o hash do arquivo calculado no job: se
+// outro recurso do registro tem o mesmo conteúdo (cópia por outro caminho), quem
+// usa resource passa para ele em applyReloads e o upload deste é dispensado;
+// true nesse caso
+template <typename T>
+static bool shareDuplicate(AssetCache<T> &cache, std::vector<PendingReload<T>> &pending,
+                           const std::shared_ptr<T> &resource, uint64_t contentHash, const std::string &variant)
+{
+    if (contentHash == 0)
+        return false;
+    std::shared_ptr<T> existing = cache.dedupe(resource, contentHash, variant);
+    if (existing == resource)
+        return false;
+    queueReload(pending, resource, existing);
+    return true;
+}
+
+// Um arquivo observado mudou. A cena é relida e comparada com a carregada
+// (loadSceneFromFile); uma malha, biblioteca .mtl ou textura é carregada de novo
+// pelo caminho de sempre, em segundo plano, e os objetos seguem com a antiga até
+// applyReloads trocar
+void reloadChangedFile(const std::string &path, const std::string &scenePath, const std::string &assetPath)
+{
+    std::cout << "Arquivo alterado: " << path << std::endl;
+    if (g_assetPack)
+        g_assetPack->markStale(path); // daqui em diante vale o arquivo solto
+    if (canonicalAssetPath(path) == canonicalAssetPath(scenePath))
     {
-        std::string objFile = assetPath + "/" + obj["file"].get<std::string>();
-        std::string mtlFile = assetPath + "/" + obj["material"].get<std::string>();
+        loadSceneFromFile(scenePath, assetPath);
+        return;
+    }
 
-        Material mat = loadMaterial(mtlFile);
-        materials.push_back(mat);
+    // uma malha por formato de vértice em uso
+    std::vector<std::string> variants;
+    for (const AnimatedObject &obj : objects)
+        if (std::find(variants.begin(), variants.end(), obj.vertexFormat) == variants.end())
+            variants.push_back(obj.vertexFormat);
+    for (const std::string &variant : variants)
+    {
+        std::shared_ptr<MeshGeometry> previous = assets.meshes.find(path, variant);
+        if (!previous)
+            continue;
+        VertexFormat format = parseVertexFormat(variant);
+        std::shared_ptr<MeshGeometry> next = assets.meshes.reload(path, variant, [format](const std::string &objPath)
+                                                                  { return loadGeometry(objPath, format); });
+        queueReload(meshReloads, previous, next);
+    }
 
-        GLuint texDiffuse = 0, texNormal = 0, texSpecular = 0;
-        size_t vertexCount = 0;
+    // o .mtl é lido na hora e as texturas dele saem do registro, então a troca é imediata
+    if (std::shared_ptr<MaterialLibrary> previous = assets.materials.find(path, ""))
+    {
+        std::shared_ptr<MaterialLibrary> next = assets.materials.reload(path, "", loadMaterials);
+        for (AnimatedObject &obj : objects)
+        {
+            if (next && obj.materials == previous)
+            {
+                obj.materials = next;
+                obj.materialsResolved = false;
+            }
+        }
+    }
 
-        // Captura o VAO retornado
-        GLuint VAO = loadGeometry(objFile, mat, assetPath, texDiffuse, texNormal, texSpecular, vertexCount);
+    if (std::shared_ptr<Texture> previous = assets.textures.find(path, ""))
+        queueReload(textureReloads, previous, assets.textures.reload(path, "", loadTexture));
+}
 
-        if (texDiffuse == 0)
-            std::cerr << "Aviso: textura difusa não carregada corretamente para " << objFile << std::endl;
+// Troca nos objetos as malhas e texturas recarregadas cujo upload terminou; se
+// a recarga falhou os objetos ficam com o recurso anterior
+void applyReloads()
+{
+    for (size_t i = 0; i < meshReloads.size();)
+    {
+        PendingReload<MeshGeometry> &reload = meshReloads[i];
+        if (!reload.next->ready && !reload.next->failed)
+        {
+            ++i;
+            continue;
+        }
+        for (AnimatedObject &obj : objects)
+        {
+            if (reload.next->failed || obj.mesh != reload.previous)
+                continue;
+            obj.mesh = reload.next;
+            if (obj.mtlFile.empty() && !reload.next->materialLibrary.empty())
+                obj.materials = assets.materials.acquire(reload.next->materialLibrary, "", loadMaterials);
+            obj.materialsResolved = false;
+        }
+        meshReloads.erase(meshReloads.begin() + i);
+    }
 
-        AnimatedObject object;
-        object.VAO = VAO;
-        object.textureID = texDiffuse;
-        object.vertexCount = vertexCount;
-        object.position = glm::vec3(obj["position"][0], obj["position"][1], obj["position"][2]);
-        object.rotation = glm::vec3(obj["rotation"][0], obj["rotation"][1], obj["rotation"][2]);
-        object.scale = obj["scale"].get<float>();
-
-        for (const auto &wp : obj["waypoints"])
-            object.waypoints.push_back(glm::vec3(wp[0], wp[1], wp[2]));
-
-        objects.push_back(object);
-    }
-
-    // Atualiza luz no shader
-    glm::vec3 lightPos(
-        scene["light"]["position"][0],
-        scene["light"]["position"][1],
-        scene["light"]["position"][2]);
-    glm::vec3 lightColor(
-        scene["light"]["color"][0],
-        scene["light"]["color"][1],
-        scene["light"]["color"][2]);
-    glUseProgram(shaderID);
-    glUniform3fv(glGetUniformLocation(shaderID, "lightPos"), 1, glm::value_ptr(lightPos));
-    glUniform3fv(glGetUniformLocation(shaderID, "lightColor"), 1, glm::value_ptr(lightColor));
-
-    // Atualiza posição da câmera
-    if (g_camera)
+    for (size_t i = 0; i < textureReloads.size();)
     {
-        g_camera->setPosition(glm::vec3(
-            scene["camera"]["position"][0],
-            scene["camera"]["position"][1],
-            scene["camera"]["position"][2]));
+        PendingReload<Texture> &reload = textureReloads[i];
+        if (reload.next->slot.page < 0 && !reload.next->failed)
+        {
+            ++i;
+            continue;
+        }
+        // bibliotecas são compartilhadas entre objetos: a troca acontece no
+        // primeiro que a usa, e só ela entra na lista, uma vez
+        for (AnimatedObject &obj : objects)
+        {
+            if (reload.next->failed || !obj.materials)
+                continue;
+            bool replaced = false;
+            for (std::shared_ptr<Texture> &texture : obj.materials->diffuse)
+                if (texture == reload.previous)
+                {
+                    texture = reload.next;
+                    replaced = true;
+                }
+            if (replaced)
+                materialsAwaitingTextures.push_back(obj.materials);
+        }
+        textureReloads.erase(textureReloads.begin() + i);
     }
 }
+
 glm::vec3 catmullRom(glm::vec3 p0, glm::vec3 p1, glm::vec3 p2, glm::vec3 p3, float t)
 {
     return 0.5f * ((2.0f * p1) +
@@ -285,7 +660,7 @@ glm::vec3 catmullRom(glm::vec3 p0, glm::vec3 p1, glm::vec3 p2, glm::vec3 p3, flo
                    (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t * t +
                    (-p0 + 3.0f * p1 - 3.0f * p2 + p3) * t * t * t);
 }
-int main()
+int main(int argc, char **argv)
 {
 
     // Atualiza posição do objeto com base nos waypoints
@@ -312,6 +687,21 @@ int main()
         cerr << "Failed to initialize GLAD\n";
         return -1;
     }
+    loadGLExtensions();
+
+    // ./TrabalhoGrauB --mip-benchmark imagem: só compara os mipmaps da CPU com
+    // glGenerateMipmap e sai
+    if (argc > 2 && strcmp(argv[1], "--mip-benchmark") == 0)
+    {
+        AsyncLoader pool;
+        setMipParallelFor([&pool](unsigned count, const std::function<void(unsigned)> &task)
+                          { pool.parallelFor(count, task); });
+        benchmarkMipGeneration(argv[2]);
+        pool.stop();
+        setMipParallelFor(nullptr);
+        glfwTerminate();
+        return 0;
+    }
 
     // Configura viewport
     int width, height;
@@ -319,39 +709,106 @@ int main()
     glViewport(0, 0, width, height);
 
     // Setup shader
-    GLuint shaderID = setupShader();
+    ShaderProgram shader;
+    shader.build(vertexShaderSource, fragmentShaderSource, FRAME_CONSTANTS_GLSL);
+    FrameConstants frameConstants;
+    frameConstants.create();
 
     // Inicializa câmera
     Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
     g_camera = &camera;
-    camera.initCamera(shaderID);
 
     // Callbacks e input
     glfwSetCursorPosCallback(window, mouse_callback);
     glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
     glfwSetKeyCallback(window, key_callback);
 
-    // Carrega modelo OBJ, MTL e textura
-    std::vector<Material> materials;
+    // Carrega modelo OBJ, MTL e textura: o parsing e a decodificação rodam em
+    // segundo plano e os objetos aparecem como cubos até o upload
     GLuint texID_Suzanne, texID_Cube;
     size_t vertexCount_Suzanne, vertexCount_Cube;
 
+    // Com o pacote de assets a cena, as malhas, os .mtl e as texturas saem de
+    // um só arquivo mapeado; o que faltar nele é lido dos arquivos soltos
+    AssetPack assetPack;
+    if (assetPack.open("../assets/assets.pack"))
+    {
+        g_assetPack = &assetPack;
+        setAssetPack(&assetPack);
+        std::cout << "Pacote de assets: " << assetPack.entryCount() << " entradas" << std::endl;
+    }
+
+    AsyncLoader loader;
+    g_loader = &loader;
+    // faixas dos mipmaps gerados na CPU também rodam nas threads de trabalho
+    setMipParallelFor([&loader](unsigned count, const std::function<void(unsigned)> &task)
+                      { loader.parallelFor(count, task); });
+    createGeometryPools();
+    GLUploader uploader;
+    if (uploadThreadEnabled && uploader.start(window))
+        g_uploader = &uploader;
+    UploadScheduler scheduler(&uploader);
+    scheduler.setBudget(uploadBudgetMs, uploadBudgetBytes);
+    g_scheduler = &scheduler;
+    PixelUploadRing pixelRing;
+    if (pixelRing.create(64 * 1024 * 1024))
+        g_pixelRing = &pixelRing;
+    placeholderMesh = createPlaceholderMesh();
+    placeholderTexture = createPlaceholderTexture();
+    materialBuffer.create(0);
+    defaultMaterialIndex = materialBuffer.allocate(gpuMaterial(defaultMaterial, placeholderTexture.get()));
+
+    // Observa a cena e cada .obj, .mtl e textura carregados; o que mudar é
+    // recarregado sem reiniciar
+    FileWatcher watcher;
+    if (hotReloadEnabled)
+    {
+        watcher.start();
+        g_watcher = &watcher;
+    }
+    std::vector<std::string> changedFiles;
+
+    double loadStart = glfwGetTime();
+    bool firstFrame = true, loading = true;
     std::string assetPath = "../assets/modelos3D";
-    loadSceneFromFile("../assets/scene.json", assetPath, materials, shaderID);
+    std::string scenePath = "../assets/scene.json";
+    loadSceneFromFile(scenePath, assetPath);
 
     glEnable(GL_DEPTH_TEST);
 
-    // Uniform locations
-    GLint modelLoc = glGetUniformLocation(shaderID, "model");
-    GLint viewLoc = glGetUniformLocation(shaderID, "view");
-    GLint projLoc = glGetUniformLocation(shaderID, "projection");
-    GLint lightPosLoc = glGetUniformLocation(shaderID, "lightPos");
-    GLint viewPosLoc = glGetUniformLocation(shaderID, "viewPos");
-    GLint lightColorLoc = glGetUniformLocation(shaderID, "lightColor");
-
-    // Projeção e view (fixos para simplificar)
-    glm::mat4 projection = glm::perspective(glm::radians(45.0f), float(WIDTH) / float(HEIGHT), 0.1f, 100.0f);
-    glm::mat4 view = glm::lookAt(camera.getPosition(), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    // Página i do pool de texturas na unidade i
+    GLint textureUnits[MAX_TEXTURE_PAGES];
+    for (int i = 0; i < MAX_TEXTURE_PAGES; ++i)
+        textureUnits[i] = i;
+    shader.use();
+    shader.setIntArray(shader.location("textures"), textureUnits, MAX_TEXTURE_PAGES);
+
+    // Projeção fixa; câmera, luz da cena e intensidades vão para as constantes
+    // do quadro uma vez por quadro (sem luz na cena fica apagada)
+    float fovY = glm::radians(45.0f);
+    FrameConstantsData frame;
+    frame.projection = glm::perspective(fovY, float(WIDTH) / float(HEIGHT), 0.1f, 100.0f);
+    frame.lightColor = glm::vec3(0.0f);
+
+    // Objetos visíveis do quadro; os que têm a mesma malha, a mesma biblioteca
+    // .mtl e o mesmo nível de detalhe ficam em sequência e viram um comando
+    // instanciado por submesh. Malhas nos pools saem todas num
+    // glMultiDrawElementsIndirect por pool
+    struct Instance
+    {
+        const MeshGeometry *geometry;
+        const MaterialLibrary *materials;
+        unsigned lod;
+        size_t object;
+        glm::mat4 model;
+    };
+    std::vector<Instance> instances;
+    IndirectDrawBuffer drawBuffer;
+    drawBuffer.create(1, 4, 1024);
+    size_t drawCalls = 0;
+
+    // Faixas do EBO com os meshlets visíveis: (primeiro índice, quantidade)
+    std::vector<std::pair<uint32_t, uint32_t>> ranges;
 
     // Loop principal
     while (!glfwWindowShouldClose(window))
@@ -364,17 +821,60 @@ int main()
         glfwPollEvents();
         camera.update(window);
 
+        // Uploads dos recursos que as threads de trabalho terminaram
+        loader.runCompletions();
+        scheduler.runFrame();
+        uploader.publishReady();
+        pixelRing.collect();
+
+        // Recarrega o que mudou no disco e troca o que já terminou de enviar
+        changedFiles.clear();
+        watcher.poll(changedFiles);
+        for (const std::string &path : changedFiles)
+            reloadChangedFile(path, scenePath, assetPath);
+        applyReloads();
+
+        if (loading && loader.pending() == 0 && scheduler.pending() == 0 && uploader.pending() == 0)
+        {
+            loading = false;
+            std::cout << "Recursos da cena prontos em " << (glfwGetTime() - loadStart) * 1000.0 << " ms" << std::endl;
+            std::cout << "Texturas: " << compressedTextureUploads << " comprimidas, " << ringTextureUploads
+                      << " pelo anel de PBO, " << directTextureUploads << " diretas, " << texturePool.layerCount()
+                      << " camadas em " << texturePool.pageCount() << " arrays ("
+                      << texturePool.reservedBytes() / (1024 * 1024) << " MB)";
+            if (pixelRing.uploadSeconds() > 0.0)
+                std::cout << " (" << pixelRing.uploadedBytes() / (1024.0 * 1024.0) / pixelRing.uploadSeconds()
+                          << " MB/s pelo anel)";
+            std::cout << std::endl;
+            std::cout << "Uploads: ate " << scheduler.largestFrameBytes() / 1024 << " KB num quadro, taxa medida "
+                      << scheduler.bytesPerMillisecond() * 1000.0 / (1024.0 * 1024.0) << " MB/s" << std::endl;
+            std::cout << "Draws: " << drawCalls << " no ultimo quadro para " << objects.size() << " objetos" << std::endl;
+        }
+
         // Limpa tela e depth buffer
         glClearColor(0.9f, 0.9f, 0.9f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        glUseProgram(shaderID);
+        shader.use();
 
-        // Atualiza view e projection
-        glm::mat4 view = camera.getViewMatrix();
-        glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
-        glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
-        glUniform3fv(viewPosLoc, 1, glm::value_ptr(camera.getPosition()));
+        // Atualiza câmera, luz e intensidades de iluminação (teclas 1-6)
+        frame.view = camera.getViewMatrix();
+        frame.viewPos = camera.getPosition();
+        if (sceneSettings.hasLight)
+        {
+            frame.lightPos = sceneSettings.lightPosition;
+            frame.lightColor = sceneSettings.lightColor;
+        }
+        frame.ambientStrength = ambientStrength;
+        frame.diffuseStrength = diffuseStrength;
+        frame.specularStrength = specularStrength;
+        frameConstants.update(frame);
+
+        // Todas as texturas ligadas de uma vez; cada material só escolhe página e
+        // camada, e os materiais alterados desde o último quadro vão para o buffer
+        texturePool.bind();
+        refreshMaterialTextures();
+        materialBuffer.flush();
 
         // Atualiza posição dos objetos animados
         for (auto &obj : objects)
@@ -401,15 +901,17 @@ int main()
                 }
             }
         }
-        // enviam valores de intensidade de iluminação para o seu fragment shader
-        glUniform1f(glGetUniformLocation(shaderID, "ambientStrength"), ambientStrength);
-        glUniform1f(glGetUniformLocation(shaderID, "diffuseStrength"), diffuseStrength);
-        glUniform1f(glGetUniformLocation(shaderID, "specularStrength"), specularStrength);
-
-        // Renderiza todos os objetos
+        // Monta as instâncias: nível de detalhe e descarte pelo frustum por objeto
+        glm::mat4 viewProjection = frame.projection * frame.view;
+        instances.clear();
         for (size_t i = 0; i < objects.size(); ++i)
         {
-            const auto &obj = objects[i];
+            auto &obj = objects[i];
+            if (!obj.mesh || obj.mesh->failed)
+                continue; // falha ao carregar o .obj
+            bool ready = obj.mesh->ready;
+            if (ready && !obj.materialsResolved)
+                resolveMaterials(obj);
             glm::mat4 model = glm::translate(glm::mat4(1.0f), obj.position);
 
             // Aplica rotações em ZYX (em graus → radianos)
@@ -420,41 +922,150 @@ int main()
             // Aplica escala uniforme
             model = glm::scale(model, glm::vec3(obj.scale));
 
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-
-            // Passa o material do objeto para o shader
-            const Material &mat = materials[i];
-
-            GLint KaLoc = glGetUniformLocation(shaderID, "Ka");
-            GLint KdLoc = glGetUniformLocation(shaderID, "Kd");
-            GLint KsLoc = glGetUniformLocation(shaderID, "Ks");
-            GLint NsLoc = glGetUniformLocation(shaderID, "Ns");
-
-            glUniform3fv(KaLoc, 1, glm::value_ptr(mat.Ka));
-            glUniform3fv(KdLoc, 1, glm::value_ptr(mat.Kd));
-            glUniform3fv(KsLoc, 1, glm::value_ptr(mat.Ks));
-            glUniform1f(NsLoc, mat.Ns);
+            // Nível de detalhe: erro da malha simplificada projetado em pixels na distância da câmera
+            const MeshGeometry &geometry = ready ? *obj.mesh : *placeholderMesh;
+            glm::vec3 extent = geometry.boundsMax - geometry.boundsMin;
+            glm::vec3 localCenter = (geometry.boundsMin + geometry.boundsMax) * 0.5f;
+            glm::vec3 center = glm::vec3(model * glm::vec4(localCenter, 1.0f));
+            float distance = std::max(glm::length(center - camera.getPosition()), 0.001f);
+            float meshSize = std::max(extent.x, std::max(extent.y, extent.z)) * obj.scale;
+            float pixelsPerUnit = meshSize * (0.5f * height) / (distance * tanf(0.5f * fovY));
+            obj.currentLod = selectLod(geometry.lods.data(), (unsigned)geometry.lods.size(), obj.currentLod, pixelsPerUnit);
+
+            // Objeto inteiro fora do frustum não entra em nenhum lote
+            if (meshletCulling &&
+                !sphereVisible(localCenter, glm::length(extent) * 0.5f, makeMeshletCuller(viewProjection, model, camera.getPosition())))
+                continue;
+            instances.push_back({&geometry, ready ? obj.materials.get() : nullptr, obj.currentLod, i, model});
+        }
+        std::stable_sort(instances.begin(), instances.end(), [](const Instance &a, const Instance &b)
+                         { return std::tie(a.geometry, a.materials, a.lod) < std::tie(b.geometry, b.materials, b.lod); });
 
-            // fay com que cada objeto use sua texture
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, obj.textureID);
-            glUniform1i(glGetUniformLocation(shaderID, "texture1"), 0);
-            glBindVertexArray(obj.VAO);
-            glDrawArrays(GL_TRIANGLES, 0, (GLsizei)obj.vertexCount);
-            glBindVertexArray(0);
+        // Monta os comandos: um por submesh (material) do nível em cada lote,
+        // com um registro por instância
+        drawBuffer.begin();
+        for (size_t first = 0, last; first < instances.size(); first = last)
+        {
+            const Instance &batch = instances[first];
+            for (last = first + 1; last < instances.size(); ++last)
+                if (instances[last].geometry != batch.geometry || instances[last].materials != batch.materials ||
+                    instances[last].lod != batch.lod)
+                    break;
+            GLuint instanceCount = (GLuint)(last - first);
+            const AnimatedObject &obj = objects[batch.object]; // materialSlots valem para todo o lote
+            const MeshGeometry &geometry = *batch.geometry;
+            bool ready = batch.geometry == obj.mesh.get();
+            const MeshLod &lod = geometry.lods[batch.lod];
+
+            // Objeto sozinho no lote: o frustum e o cone de costas ainda descartam
+            // meshlets, testados no espaço do objeto
+            bool culling = instanceCount == 1 && meshletCulling && lod.meshletCount > 0;
+            MeshletCuller culler;
+            if (culling)
+                culler = makeMeshletCuller(viewProjection, batch.model, camera.getPosition());
+
+            // No pool, índices e vértices da malha começam na faixa dela
+            bool indirect = geometry.pool != nullptr;
+            GLuint firstIndex = indirect ? (GLuint)geometry.poolRange.firstIndex : 0;
+            GLint baseVertex = indirect ? (GLint)geometry.poolRange.firstVertex : 0;
+
+            // Os meshlets de cada submesh vêm em sequência, e meshlets visíveis
+            // vizinhos no EBO viram uma faixa só
+            uint32_t meshletIndex = lod.firstMeshlet;
+            uint32_t meshletEnd = lod.firstMeshlet + lod.meshletCount;
+            size_t submeshesPerLod = geometry.submeshes.size() / geometry.lods.size();
+            for (size_t s = 0; s < submeshesPerLod; ++s)
+            {
+                const Submesh &sub = geometry.submeshes[lod.firstSubmesh + s];
+                uint32_t subEnd = sub.firstIndex + sub.indexCount;
+                uint32_t firstMeshlet = meshletIndex;
+                while (meshletIndex < meshletEnd && geometry.meshlets[meshletIndex].firstIndex < subEnd)
+                    ++meshletIndex;
+                if (sub.indexCount == 0)
+                    continue;
+
+                ranges.clear();
+                if (culling)
+                {
+                    glm::vec3 subCenter = (sub.boundsMin + sub.boundsMax) * 0.5f;
+                    float subRadius = glm::length(sub.boundsMax - sub.boundsMin) * 0.5f;
+                    if (!sphereVisible(subCenter, subRadius, culler))
+                        continue;
+                    for (uint32_t m = firstMeshlet; m < meshletIndex; ++m)
+                    {
+                        const Meshlet &meshlet = geometry.meshlets[m];
+                        if (!meshletVisible(meshlet, culler))
+                            continue;
+                        if (!ranges.empty() && ranges.back().first + ranges.back().second == meshlet.firstIndex)
+                            ranges.back().second += meshlet.indexCount;
+                        else
+                            ranges.push_back({meshlet.firstIndex, meshlet.indexCount});
+                    }
+                    if (ranges.empty())
+                        continue;
+                }
+                else
+                    ranges.push_back({sub.firstIndex, sub.indexCount});
+
+                // Material do submesh: só o índice no materialBuffer, em cada registro
+                int slot = ready && sub.material < obj.materialSlots.size() ? obj.materialSlots[sub.material] : -1;
+                DrawRecord record;
+                record.dequantize = geometry.dequantize;
+                record.materialIndex = slot >= 0 ? obj.materials->gpuIndex[slot] : defaultMaterialIndex;
+                GLuint baseInstance = 0;
+                for (size_t k = first; k < last; ++k)
+                {
+                    record.model = instances[k].model;
+                    GLuint index = drawBuffer.addRecord(record);
+                    if (k == first)
+                        baseInstance = index;
+                }
+                for (const auto &range : ranges)
+                    drawBuffer.addCommand(geometry.VAO, geometry.indexType, indirect,
+                                          {range.second, instanceCount, firstIndex + range.first, baseVertex, baseInstance});
+            }
         }
 
-        glfwSwapBuffers(window);
-    }
+        // Envia registros e comandos e desenha tudo
+        drawCalls = drawBuffer.submit();
 
-    // Cleanup
-    for (const auto &obj : objects)
-    {
-        glDeleteVertexArrays(1, &obj.VAO);
-        glDeleteTextures(1, &obj.textureID);
+        glfwSwapBuffers(window);
+        if (firstFrame)
+        {
+            firstFrame = false;
+            std::cout << "Primeiro quadro em " << (glfwGetTime() - loadStart) * 1000.0 << " ms" << std::endl;
+        }
     }
 
-    glDeleteProgram(shaderID);
+    // Cleanup: soltar os últimos handles libera VAOs, buffers e texturas
+    // enquanto o contexto ainda existe
+    objects.clear();
+    meshReloads.clear();
+    textureReloads.clear();
+    watcher.stop();
+    g_watcher = nullptr;
+    loader.stop();
+    setMipParallelFor(nullptr);
+    uploader.stop();
+    g_uploader = nullptr;
+    scheduler.clear();
+    g_scheduler = nullptr;
+    g_pixelRing = nullptr;
+    pixelRing.destroy();
+    placeholderMesh.reset();
+    placeholderTexture.reset();
+    materialsAwaitingTextures.clear();
+    drawBuffer.destroy();
+    for (auto &pools : geometryPools)
+        for (GeometryPool &pool : pools)
+            pool.destroy();
+    materialBuffer.destroy();
+    texturePool.destroy();
+    setAssetPack(nullptr);
+    g_assetPack = nullptr;
+
+    frameConstants.destroy();
+    shader.destroy();
     glfwTerminate();
     return 0;
 }
@@ -487,6 +1098,12 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
         addWaypointKeyPressed = false;
     }
 
+    if (key == GLFW_KEY_C && action == GLFW_PRESS)
+    {
+        meshletCulling = !meshletCulling;
+        std::cout << "Descarte por meshlet: " << (meshletCulling ? "ligado" : "desligado") << std::endl;
+    }
+
     if (key == GLFW_KEY_TAB && action == GLFW_PRESS)
     {
         selectedObjectIndex = (selectedObjectIndex + 1) % objects.size();
@@ -541,189 +1158,703 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
     }
 }
 
-// Compila e linka shader simples de vértice + fragmento
-GLuint setupShader()
+// Dados de uma malha prontos na CPU, esperando o upload na thread GL
+struct MeshStaging
+{
+    MeshCacheFile cache;
+    ObjMesh mesh;
+    std::vector<uint16_t> indices16;
+    MeshView view;
+    std::vector<PackedVertex> packed; // só no formato compacto
+};
+
+// Cache da malha guardado no pacote de assets; entradas comprimidas ficam em
+// cache.unpacked (mover o vector não muda o endereço dos bytes)
+static bool readPackedMesh(const std::string &objPath, MeshCacheFile &cache)
+{
+    AssetBytes bytes;
+    if (!g_assetPack || !g_assetPack->read(objPath, ASSET_PACK_MESH, bytes))
+        return false;
+    cache.unpacked = std::move(bytes.storage);
+    cache.fromPack = readMeshCache(bytes.data, bytes.size, cache.view);
+    return cache.fromPack;
+}
+
+// Thread de trabalho: usa o pacote de assets ou o cache binário ao lado do .obj
+// quando válido; senão faz o parsing e grava o cache. Também compacta os
+// vértices se for o caso.
+bool prepareGeometry(const std::string &objPath, VertexFormat format, MeshStaging &staging)
+{
+    if (readPackedMesh(objPath, staging.cache))
+        staging.view = staging.cache.view;
+    else if (!loadMeshCached(objPath, staging.cache, staging.mesh, staging.indices16, staging.view))
+        return false;
+    const MeshView &view = staging.view;
+    if (format == VERTEX_FORMAT_PACKED)
+        packVertices(view.vertices, view.vertexCount, view.boundsMin, view.boundsMax, staging.packed);
+    return true;
+}
+
+// Envia data para buffer (já alocado) a partir do byte base, em fatias de até
+// chunkBytes, um passo por fatia; keepAlive segura a memória de data até o
+// último passo rodar
+static void appendBufferSteps(std::vector<UploadScheduler::Step> &steps, std::shared_ptr<const void> keepAlive,
+                              const GLuint *buffer, size_t base, const void *data, size_t size, size_t chunkBytes)
+{
+    for (size_t offset = 0; offset < size; offset += chunkBytes)
+    {
+        size_t bytes = std::min(chunkBytes, size - offset);
+        const char *slice = (const char *)data + offset;
+        steps.push_back({bytes, [keepAlive, buffer, slice, offset = base + offset, bytes]()
+                         {
+                             glBindBuffer(GL_COPY_WRITE_BUFFER, *buffer);
+                             glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)offset, (GLsizeiptr)bytes, slice);
+                             glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+                         }});
+    }
+}
+
+// Passos de upload do VBO e do EBO (buffers = VBO, EBO): aloca os dois e envia
+// os dados em fatias; rodam na thread de upload quando ela existe. Com pool, os
+// dados vão para a faixa range dos buffers dele, que já existem
+std::vector<UploadScheduler::Step> geometryUploadSteps(std::shared_ptr<MeshStaging> staging, VertexFormat format,
+                                                       std::shared_ptr<std::pair<GLuint, GLuint>> buffers, size_t chunkBytes,
+                                                       const GeometryPool *pool = nullptr, const GeometryRange &range = {})
 {
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-    glCompileShader(vertexShader);
-    GLint success;
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-    if (!success)
+    const MeshView &view = staging->view;
+    const void *vertexData = view.vertices;
+    size_t vertexBytes = view.vertexCount * sizeof(Vertex);
+    if (format == VERTEX_FORMAT_PACKED)
     {
-        char infoLog[512];
-        glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-        cerr << "Erro vertex shader: " << infoLog << endl;
+        vertexData = staging->packed.data();
+        vertexBytes = staging->packed.size() * sizeof(PackedVertex);
     }
+    // Índices de 16 bits quando possível (metade da memória e da banda)
+    size_t indexBytes = view.indexCount * view.indexSize;
 
-    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-    glCompileShader(fragmentShader);
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-    if (!success)
+    std::vector<UploadScheduler::Step> steps;
+    if (pool)
     {
-        char infoLog[512];
-        glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-        cerr << "Erro fragment shader: " << infoLog << endl;
+        buffers->first = pool->vertexBuffer();
+        buffers->second = pool->indexBuffer();
+        appendBufferSteps(steps, staging, &buffers->first, range.firstVertex * pool->vertexSize(), vertexData, vertexBytes, chunkBytes);
+        appendBufferSteps(steps, staging, &buffers->second, range.firstIndex * pool->indexSize(), view.indices, indexBytes, chunkBytes);
+        return steps;
     }
+    steps.push_back({0, [buffers, vertexBytes, indexBytes]()
+                     {
+                         glGenBuffers(1, &buffers->first);
+                         glGenBuffers(1, &buffers->second);
+                         glBindBuffer(GL_COPY_WRITE_BUFFER, buffers->first);
+                         glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)vertexBytes, nullptr, GL_STATIC_DRAW);
+                         glBindBuffer(GL_COPY_WRITE_BUFFER, buffers->second);
+                         glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)indexBytes, nullptr, GL_STATIC_DRAW);
+                         glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+                     }});
+    appendBufferSteps(steps, staging, &buffers->first, 0, vertexData, vertexBytes, chunkBytes);
+    appendBufferSteps(steps, staging, &buffers->second, 0, view.indices, indexBytes, chunkBytes);
+    return steps;
+}
 
-    GLuint shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-    if (!success)
+// Atributos de vértice do formato, sobre o VAO e o VBO vinculados (a partir
+// do byte 0 do VBO)
+void setupVertexAttributes(VertexFormat format)
+{
+    if (format == VERTEX_FORMAT_PACKED)
     {
-        char infoLog[512];
-        glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-        cerr << "Erro link shader: " << infoLog << endl;
+        // position (location = 0): uint16 normalizado -> [0,1]
+        glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(PackedVertex), (void *)offsetof(PackedVertex, position));
+        // texCoord (location = 2): half float
+        glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(PackedVertex), (void *)offsetof(PackedVertex, texCoord));
+        // normal (location = 3): 10/10/10/2 com sinal normalizado -> [-1,1]
+        glVertexAttribPointer(3, 4, GL_INT_2_10_10_10_REV, GL_TRUE, sizeof(PackedVertex), (void *)offsetof(PackedVertex, normal));
     }
+    else
+    {
+        // position (location = 0)
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, position));
+        // texCoord (location = 2)
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, texCoord));
+        // normal (location = 3)
+        glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, normal));
+    }
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(2);
+    glEnableVertexAttribArray(3);
+}
 
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+// Cria os quatro pools na thread principal. Roda antes de a thread de upload
+// começar e termina com glFlush: os buffers são escritos pelo outro contexto,
+// que só enxerga o armazenamento depois que os comandos que o criam chegaram
+// ao servidor
+void createGeometryPools()
+{
+    if (!geometryPoolEnabled || !GLEXT_multi_draw_indirect)
+        return;
+    for (int packed = 0; packed < 2; ++packed)
+        for (int shortIndices = 0; shortIndices < 2; ++shortIndices)
+        {
+            VertexFormat format = packed ? VERTEX_FORMAT_PACKED : VERTEX_FORMAT_FLOAT;
+            geometryPools[packed][shortIndices].create(packed ? sizeof(PackedVertex) : sizeof(Vertex),
+                                                       shortIndices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT,
+                                                       geometryPoolVertices, geometryPoolIndices, [format]()
+                                                       { setupVertexAttributes(format); });
+        }
+    glFlush();
+}
 
-    return shaderProgram;
+// Pool das malhas desse formato e tamanho de índice; nullptr sem
+// glMultiDrawElementsIndirect ou com o pool desligado
+GeometryPool *geometryPoolFor(VertexFormat format, size_t indexSize)
+{
+    GeometryPool &pool = geometryPools[format == VERTEX_FORMAT_PACKED][indexSize == 2];
+    return pool.isCreated() ? &pool : nullptr;
 }
 
-// Carrega OBJ + MTL (apenas para map_Kd) e cria VAO
-GLuint loadGeometry(
-    const std::string &objPath,
-    const Material &mat,
-    const std::string &texFolder,
-    GLuint &outTexDiffuseID,
-    GLuint &outTexNormalID,
-    GLuint &outTexSpecularID,
-    size_t &outVertexCount)
+// Reserva a faixa da malha no pool; nullptr se não houver pool ou ele estiver
+// cheio (a malha fica com buffers próprios)
+GeometryPool *allocateInPool(const MeshStaging &staging, VertexFormat format, GeometryRange &range)
 {
-    std::vector<glm::vec3> positions;
-    std::vector<glm::vec3> normals;
-    std::vector<glm::vec2> texCoords;
-    std::vector<Vertex> vertices;
+    const MeshView &view = staging.view;
+    GeometryPool *pool = geometryPoolFor(format, view.indexSize);
+    if (!pool || pool->allocate(view.vertexCount, view.indexCount, range))
+        return pool;
+    if (!geometryPoolFullReported)
+        std::cerr << "Pool de geometria cheio: malhas seguintes com buffers proprios" << std::endl;
+    geometryPoolFullReported = true;
+    return nullptr;
+}
 
-    std::ifstream objFile(objPath);
-    if (!objFile.is_open())
+// Thread GL: monta o VAO sobre os buffers já enviados (ou usa o do pool, se a
+// malha estiver nele) e preenche a malha
+void finishGeometry(const MeshStaging &staging, VertexFormat format, GLuint VBO, GLuint EBO, MeshGeometry &geometry,
+                    GeometryPool *pool = nullptr, const GeometryRange &range = {})
+{
+    const MeshView &view = staging.view;
+    if (pool)
     {
-        std::cerr << "Erro ao abrir OBJ: " << objPath << std::endl;
-        return 0;
+        geometry.pool = pool;
+        geometry.poolRange = range;
+        geometry.VAO = pool->vao();
     }
-
-    std::string line;
-    while (getline(objFile, line))
+    else
     {
-        std::istringstream iss(line);
-        std::string type;
-        iss >> type;
+        geometry.VBO = VBO;
+        geometry.EBO = EBO;
+        glGenVertexArrays(1, &geometry.VAO);
+        glBindVertexArray(geometry.VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+        setupVertexAttributes(format);
+
+        // o EBO fica associado ao VAO; só desvincula depois do VAO
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    }
+    geometry.dequantize = format == VERTEX_FORMAT_PACKED ? dequantizeMatrix(view.boundsMin, view.boundsMax) : glm::mat4(1.0f);
+
+    geometry.indexType = view.indexSize == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    geometry.indexSize = view.indexSize;
+    geometry.boundsMin = view.boundsMin;
+    geometry.boundsMax = view.boundsMax;
+    geometry.submeshes.assign(view.submeshes, view.submeshes + view.submeshCount);
+    geometry.materials = view.materials;
+    geometry.lods.assign(view.lods, view.lods + view.lodCount);
+    geometry.meshlets.assign(view.meshlets, view.meshlets + view.meshletCount);
+    geometry.ready = true;
+}
 
-        if (type == "v")
-        {
-            glm::vec3 pos;
-            iss >> pos.x >> pos.y >> pos.z;
-            positions.push_back(pos);
-        }
-        else if (type == "vt")
-        {
-            glm::vec2 uv;
-            iss >> uv.x >> uv.y;
-            texCoords.push_back(uv);
-        }
-        else if (type == "vn")
-        {
-            glm::vec3 norm;
-            iss >> norm.x >> norm.y >> norm.z;
-            normals.push_back(norm);
-        }
-        else if (type == "f")
+// Põe os passos na fila do UploadScheduler, que os libera dentro do orçamento
+// de cada quadro; publish roda depois que o último chegar à GPU
+void scheduleUpload(std::vector<UploadScheduler::Step> steps, UploadScheduler::Task publish)
+{
+    g_scheduler->submit(std::move(steps), std::move(publish));
+}
+
+// Devolve a malha na hora, ainda sem dados (ready == false); o parsing roda numa
+// thread de trabalho e o upload depois, via scheduleUpload
+std::shared_ptr<MeshGeometry> loadGeometry(const std::string &objPath, VertexFormat format)
+{
+    if (g_watcher)
+        g_watcher->watch(objPath);
+    auto geometry = std::make_shared<MeshGeometry>();
+    std::weak_ptr<MeshGeometry> target = geometry;
+    g_loader->submit([objPath, format, target]() -> AsyncLoader::Completion
+                     {
+        auto staging = std::make_shared<MeshStaging>();
+        bool ok = prepareGeometry(objPath, format, *staging);
+        return [objPath, format, target, staging, ok]()
         {
-            for (int i = 0; i < 3; i++)
+            if (!ok)
             {
-                std::string v;
-                iss >> v;
-                std::replace(v.begin(), v.end(), '/', ' ');
-                std::istringstream viss(v);
-                int vi = 0, ti = 0, ni = 0;
-                viss >> vi >> ti >> ni;
-
-                Vertex vert;
-                vert.position = positions[vi - 1];
-                vert.texCoord = (ti > 0) ? texCoords[ti - 1] : glm::vec2(0.0f);
-                vert.normal = (ni > 0) ? normals[ni - 1] : glm::vec3(0.0f);
-                vertices.push_back(vert);
+                std::cerr << "Erro ao abrir OBJ: " << objPath << std::endl;
+                if (std::shared_ptr<MeshGeometry> geometry = target.lock())
+                    geometry->failed = true;
+                return;
             }
+            if (target.expired())
+                return; // nenhum objeto usa mais a malha
+            if (shareDuplicate(assets.meshes, meshReloads, target.lock(), staging->view.sourceHash, std::to_string(format)))
+                return;
+
+            auto buffers = std::make_shared<std::pair<GLuint, GLuint>>(0, 0); // VBO, EBO
+            GeometryRange range;
+            GeometryPool *pool = allocateInPool(*staging, format, range);
+            auto publish = [objPath, format, target, staging, buffers, pool, range]()
+            {
+                std::shared_ptr<MeshGeometry> geometry = target.lock();
+                if (!geometry)
+                {
+                    // a faixa só volta ao pool depois que o último passo a escreveu
+                    if (pool)
+                        pool->release(range);
+                    else
+                    {
+                        glDeleteBuffers(1, &buffers->first);
+                        glDeleteBuffers(1, &buffers->second);
+                    }
+                    return;
+                }
+                const MeshView &view = staging->view;
+                if (!view.materialLibrary.empty())
+                    geometry->materialLibrary = (std::filesystem::path(objPath).parent_path() / view.materialLibrary).string();
+                finishGeometry(*staging, format, buffers->first, buffers->second, *geometry, pool, range);
+
+                std::cout << objPath << (staging->cache.fromPack ? " (pacote)" : staging->cache.file.isOpen() ? " (cache)" : " (obj)") << ": " << view.vertexCount
+                          << " vertices, triangulos por nivel:";
+                for (uint32_t l = 0; l < view.lodCount; ++l)
+                    std::cout << " " << view.lods[l].indexCount / 3;
+                std::cout << std::endl;
+            };
+            scheduleUpload(geometryUploadSteps(staging, format, buffers, g_scheduler->stepBytes(), pool, range), publish);
+        }; });
+    return geometry;
+}
+
+// Cubo unitário desenhado no lugar das malhas que ainda estão carregando
+std::shared_ptr<MeshGeometry> createPlaceholderMesh()
+{
+    auto staging = std::make_shared<MeshStaging>();
+    ObjMesh &mesh = staging->mesh;
+    const glm::vec3 normals[6] = {{1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+    for (const glm::vec3 &n : normals)
+    {
+        // u x w = n: os triângulos ficam anti-horários vistos de fora
+        glm::vec3 u = std::fabs(n.y) > 0.5f ? glm::vec3(1, 0, 0) : glm::vec3(0, 1, 0);
+        glm::vec3 w = glm::cross(n, u);
+        uint32_t base = (uint32_t)mesh.vertices.size();
+        const float corners[4][2] = {{-1, -1}, {1, -1}, {1, 1}, {-1, 1}};
+        for (const auto &c : corners)
+        {
+            Vertex v;
+            v.position = (n + u * c[0] + w * c[1]) * 0.5f;
+            v.normal = n;
+            v.texCoord = glm::vec2(c[0] + 1.0f, c[1] + 1.0f) * 0.5f;
+            mesh.vertices.push_back(v);
         }
+        for (uint32_t k : {0u, 1u, 2u, 0u, 2u, 3u})
+            mesh.indices.push_back(base + k);
     }
-    objFile.close();
-
-    // Carrega as texturas (se houver)
-    int w, h;
-    if (!mat.map_Kd.empty())
-        outTexDiffuseID = loadTexture(texFolder + "/" + mat.map_Kd, w, h);
-    else
-        outTexDiffuseID = 0;
+    Submesh all = {0, (uint32_t)mesh.indices.size(), 0};
+    mesh.submeshes.assign(1, all);
+    mesh.materials.assign(1, std::string());
+    mesh.lods.assign(1, MeshLod{0, 0, all.indexCount, 0.0f, 0, 0});
+    computeBounds(mesh);
+    staging->view = makeMeshView(mesh, staging->indices16);
+
+    auto geometry = std::make_shared<MeshGeometry>();
+    auto buffers = std::make_shared<std::pair<GLuint, GLuint>>(0, 0);
+    GeometryRange range;
+    GeometryPool *pool = allocateInPool(*staging, VERTEX_FORMAT_FLOAT, range);
+    for (UploadScheduler::Step &step : geometryUploadSteps(staging, VERTEX_FORMAT_FLOAT, buffers, SIZE_MAX, pool, range))
+        step.upload();
+    finishGeometry(*staging, VERTEX_FORMAT_FLOAT, buffers->first, buffers->second, *geometry, pool, range);
+    return geometry;
+}
 
-    if (!mat.map_Bump.empty())
-        outTexNormalID = loadTexture(texFolder + "/" + mat.map_Bump, w, h);
-    else
-        outTexNormalID = 0;
+// Lê a biblioteca .mtl e pega no registro a textura difusa de cada material;
+// nullptr se o arquivo não abrir. O .mtl é pequeno e lido aqui mesmo, então o
+// hash também: uma cópia idêntica na mesma pasta (map_Kd é relativo a ela)
+// devolve a biblioteca que já existe
+std::shared_ptr<MaterialLibrary> loadMaterials(const std::string &mtlPath)
+{
+    if (g_watcher)
+        g_watcher->watch(mtlPath);
+    std::string folderKey = canonicalAssetPath(std::filesystem::path(mtlPath).parent_path().string());
+    uint64_t contentHash = 0;
+    if (fileContentHash(mtlPath, contentHash))
+        if (std::shared_ptr<MaterialLibrary> existing = assets.materials.findContent(contentHash, folderKey))
+            return existing;
+    auto library = std::make_shared<MaterialLibrary>();
+    AssetBytes packed;
+    if (g_assetPack && g_assetPack->read(mtlPath, ASSET_PACK_RAW, packed))
+        parseMaterialLibrary(packed.data, packed.size, library->materials);
+    else if (!loadMaterialLibrary(mtlPath, library->materials))
+        return nullptr;
+
+    std::filesystem::path folder = std::filesystem::path(mtlPath).parent_path();
+    for (const Material &mat : library->materials)
+    {
+        // só a textura difusa é usada pelo shader
+        std::shared_ptr<Texture> texture;
+        if (!mat.map_Kd.empty())
+            texture = assets.textures.acquire((folder / mat.map_Kd).string(), "", loadTexture);
+        library->diffuse.push_back(texture);
+        library->gpuIndex.push_back(materialBuffer.allocate(gpuMaterial(mat, texture.get())));
+    }
+    materialsAwaitingTextures.push_back(library);
+    if (contentHash != 0)
+        assets.materials.dedupe(library, contentHash, folderKey);
+    return library;
+}
 
-    if (!mat.map_Ks.empty())
-        outTexSpecularID = loadTexture(texFolder + "/" + mat.map_Ks, w, h);
-    else
-        outTexSpecularID = 0;
+// Reserva a camada da textura no pool; se ela abrir uma página nova, o passo
+// que cria o array entra em steps antes dos uploads. false se as páginas acabaram
+static bool allocateTextureLayer(const TextureLayout &layout, TextureSlot &slot, std::vector<UploadScheduler::Step> &steps)
+{
+    TextureArrayPool::Task create;
+    if (!texturePool.allocate(layout, slot, create))
+        return false;
+    if (create)
+        steps.push_back({0, create});
+    return true;
+}
 
-    // Cria VAO e VBO
-    GLuint VBO, VAO;
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
+// Passos de upload de uma cadeia de mipmaps RGB/RGBA gerada na CPU para a
+// camada: cada nível em faixas de linhas, lidas do anel de PBO (staged) ou da
+// memória da CPU
+void appendUncompressedTextureSteps(std::vector<UploadScheduler::Step> &steps, std::shared_ptr<MipChain> chain,
+                                    bool staged, PixelUploadRing::Region region, TextureSlot slot, size_t chunkBytes)
+{
+    std::shared_ptr<GLuint> page = texturePool.pageTexture(slot.page);
+    int layer = slot.layer;
+
+    // com o PBO ligado o "ponteiro" é o deslocamento dentro do buffer
+    const unsigned char *base = staged ? (const unsigned char *)region.offset : chain->data.data();
+    GLuint pbo = staged ? g_pixelRing->buffer() : 0;
+    GLenum format = (chain->channels == 4) ? GL_RGBA : GL_RGB;
+    for (size_t l = 0; l < chain->levels.size(); ++l)
+    {
+        const MipLevel &level = chain->levels[l];
+        const unsigned char *pixels = base + level.offset;
+        int width = level.width;
+        size_t pitch = level.pitch;
+        int rowsPerStep = (int)std::max<size_t>(1, chunkBytes / pitch);
+        for (int y = 0; y < level.height; y += rowsPerStep)
+        {
+            int rows = std::min(rowsPerStep, level.height - y);
+            steps.push_back({rows * pitch, [chain, page, layer, pbo, pixels, format, pitch, l, width, y, rows]()
+                             {
+                                 glBindTexture(GL_TEXTURE_2D_ARRAY, *page);
+                                 glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+                                 glTexSubImage3D(GL_TEXTURE_2D_ARRAY, (GLint)l, 0, y, layer, width, rows, 1, format,
+                                                 GL_UNSIGNED_BYTE, pixels + y * pitch);
+                                 glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                                 glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+                             }});
+        }
+    }
+    if (staged)
+        steps.push_back({0, [region]()
+                         { g_pixelRing->release(region.id, glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0)); }});
+}
 
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
+// Textura cinza usada enquanto as texturas da cena carregam; não ocupa camada
+// (o shader desenha o cinza direto)
+std::shared_ptr<Texture> createPlaceholderTexture()
+{
+    auto texture = std::make_shared<Texture>();
+    texture->slot.page = PLACEHOLDER_TEXTURE_PAGE;
+    texture->width = texture->height = 1;
+    return texture;
+}
 
-    // position (location = 0)
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, position));
-    glEnableVertexAttribArray(0);
+// Copia a cadeia de mipmaps para uma região do anel de PBO; false se o anel não
+// existir ou estiver cheio
+static bool stageMipChain(const MipChain &chain, PixelUploadRing::Region &region)
+{
+    if (!g_pixelRing || !g_pixelRing->allocate(chain.data.size(), region))
+        return false;
+    memcpy(region.data, chain.data.data(), chain.data.size());
+    return true;
+}
 
-    // texCoord (location = 2)
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, texCoord));
-    glEnableVertexAttribArray(2);
+// Cache comprimido da imagem guardado no pacote de assets, como readPackedMesh
+static bool readPackedTexture(const std::string &imagePath, TextureCacheFile &cache)
+{
+    AssetBytes bytes;
+    if (!g_assetPack || !g_assetPack->read(imagePath, ASSET_PACK_TEXTURE, bytes))
+        return false;
+    cache.unpacked = std::move(bytes.storage);
+    return readTextureCache(bytes.data, bytes.size, cache.view);
+}
 
-    // normal (location = 3)
-    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, normal));
-    glEnableVertexAttribArray(3);
+// Passos de upload de uma textura comprimida para a camada: cada nível em
+// faixas de linhas de blocos de 4x4
+void appendCompressedTextureSteps(std::vector<UploadScheduler::Step> &steps, std::shared_ptr<TextureCacheFile> cache,
+                                  GLenum internalFormat, TextureSlot slot, size_t chunkBytes)
+{
+    const TextureView &view = cache->view;
+    std::shared_ptr<GLuint> page = texturePool.pageTexture(slot.page);
+    int layer = slot.layer;
+    for (size_t l = 0; l < view.levels.size(); ++l)
+    {
+        const CompressedLevel &level = view.levels[l];
+        int blockRows = (level.height + 3) / 4;
+        size_t rowBytes = level.size / blockRows;
+        int rowsPerStep = (int)std::max<size_t>(1, chunkBytes / rowBytes);
+        for (int row = 0; row < blockRows; row += rowsPerStep)
+        {
+            int rows = std::min(rowsPerStep, blockRows - row);
+            int y = row * 4, height = std::min(rows * 4, level.height - y);
+            int width = level.width;
+            const unsigned char *data = view.data + level.offset + row * rowBytes;
+            size_t bytes = rows * rowBytes;
+            steps.push_back({bytes, [cache, page, layer, internalFormat, l, y, width, height, data, bytes]()
+                             {
+                                 glBindTexture(GL_TEXTURE_2D_ARRAY, *page);
+                                 glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, (GLint)l, 0, y, layer, width, height, 1,
+                                                           internalFormat, (GLsizei)bytes, data);
+                                 glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+                             }});
+        }
+    }
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+// Publish comum aos caminhos de textura: entrega a camada à Texture ou a
+// devolve ao pool se ninguém mais a usa
+UploadScheduler::Task publishTexture(std::weak_ptr<Texture> target, int width, int height, TextureSlot slot)
+{
+    return [target, width, height, slot]()
+    {
+        // mesmo descartada, a camada pode ter sido a que fez a página crescer
+        texturePool.markReady(slot);
+        std::shared_ptr<Texture> texture = target.lock();
+        if (!texture)
+        {
+            texturePool.release(slot);
+            return;
+        }
+        texture->slot = slot;
+        texture->width = width;
+        texture->height = height;
+    };
+}
 
-    outVertexCount = vertices.size();
+static void textureLayerUnavailable(const std::string &filePath, std::weak_ptr<Texture> target,
+                                    const TextureLayout &layout);
+
+// Decodifica a imagem numa thread de trabalho, gera os mipmaps na CPU
+// (MipGenerator.h) e agenda o upload para uma camada. O tamanho vira a potência
+// de dois mais próxima, como no cache comprimido, para imagens de tamanhos
+// parecidos dividirem página. fit (width > 0) é o layout de uma página já
+// existente em que a imagem é reamostrada quando as páginas acabaram. Com o anel
+// de PBO a thread de trabalho já deixa a cadeia na memória mapeada e o upload só
+// lê do buffer.
+static void submitTextureDecode(const std::string &filePath, std::weak_ptr<Texture> target, TextureLayout fit)
+{
+    g_loader->submit([filePath, target, fit]() -> AsyncLoader::Completion
+                     {
+        // a reamostragem de fit é da mesma textura, que já passou por shareDuplicate
+        uint64_t contentHash = 0;
+        if (fit.width == 0)
+            fileContentHash(filePath, contentHash);
+
+        // cinza e cinza com alfa viram RGB e RGBA
+        int width = 0, height = 0, channels = 0;
+        stbi_info(filePath.c_str(), &width, &height, &channels);
+        channels = fit.width > 0 ? (fit.format == GL_RGBA ? 4 : 3) : ((channels == 2 || channels == 4) ? 4 : 3);
+        int newWidth = fit.width > 0 ? fit.width : nearestPowerOfTwo(std::max(width, 1));
+        int newHeight = fit.width > 0 ? fit.height : nearestPowerOfTwo(std::max(height, 1));
+        bool resize = newWidth != width || newHeight != height;
+        // resampleRGBA só trabalha com 4 canais
+        unsigned char *pixels = stbi_load(filePath.c_str(), &width, &height, nullptr, resize ? 4 : channels);
+        bool failed = !pixels;
+        auto chain = std::make_shared<MipChain>();
+        PixelUploadRing::Region region;
+        bool staged = false;
+        if (pixels)
+        {
+            std::vector<unsigned char> resized;
+            const unsigned char *source = pixels;
+            if (resize)
+            {
+                resampleRGBA(pixels, width, height, newWidth, newHeight, resized);
+                if (channels == 3)
+                    for (size_t i = 0, count = (size_t)newWidth * newHeight; i < count; ++i)
+                        memmove(&resized[i * 3], &resized[i * 4], 3);
+                source = resized.data();
+                width = newWidth;
+                height = newHeight;
+            }
+            generateMipChain(source, width, height, channels, *chain);
+            stbi_image_free(pixels);
+            staged = stageMipChain(*chain, region);
+            if (staged)
+                chain->data = std::vector<unsigned char>();
+        }
+        return [filePath, target, chain, staged, region, failed, width, height, channels, contentHash]()
+        {
+            std::shared_ptr<Texture> texture = target.lock();
+            if (failed)
+            {
+                cerr << "Falha ao carregar textura: " << filePath << endl;
+                if (texture)
+                    texture->failed = true;
+                return;
+            }
+            if (texture && shareDuplicate(assets.textures, textureReloads, texture, contentHash, ""))
+            {
+                if (staged)
+                    g_pixelRing->release(region.id, 0);
+                return;
+            }
 
-    return VAO;
+            // camadas com o mesmo tamanho e formato dividem uma página
+            TextureLayout layout = {GLenum(channels == 4 ? GL_RGBA8 : GL_RGB8), GLenum(channels == 4 ? GL_RGBA : GL_RGB),
+                                    width, height, (int)chain->levels.size()};
+            std::vector<UploadScheduler::Step> steps;
+            TextureSlot slot;
+            if (!texture || !allocateTextureLayer(layout, slot, steps))
+            {
+                if (staged)
+                    g_pixelRing->release(region.id, 0);
+                if (texture)
+                    textureLayerUnavailable(filePath, target, layout);
+                return;
+            }
+            ++(staged ? ringTextureUploads : directTextureUploads);
+            appendUncompressedTextureSteps(steps, chain, staged, region, slot, g_scheduler->stepBytes());
+            scheduleUpload(std::move(steps), publishTexture(target, width, height, slot));
+        }; });
 }
 
-GLuint loadTexture(const std::string &filePath, int &width, int &height)
+// Thread principal: as páginas acabaram para layout. A imagem é decodificada de
+// novo e reamostrada para uma página sem compressão que ainda tem camada livre;
+// sem nenhuma, a textura falha
+static void textureLayerUnavailable(const std::string &filePath, std::weak_ptr<Texture> target,
+                                    const TextureLayout &layout)
 {
-    GLuint texID;
-    glGenTextures(1, &texID);
-    glBindTexture(GL_TEXTURE_2D, texID);
-
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    std::shared_ptr<Texture> texture = target.lock();
+    TextureLayout fit;
+    if (!texturePool.fallbackLayout(layout, fit))
+    {
+        cerr << "Aviso: limite de " << MAX_TEXTURE_PAGES << " arrays de textura atingido, textura não carregada: "
+             << filePath << endl;
+        texture->failed = true;
+        return;
+    }
+    cerr << "Aviso: limite de " << MAX_TEXTURE_PAGES << " arrays de textura atingido, " << filePath
+         << " reamostrada para " << fit.width << "x" << fit.height << endl;
+    submitTextureDecode(filePath, target, fit);
+}
 
-    int nrChannels;
-    unsigned char *data = stbi_load(filePath.c_str(), &width, &height, &nrChannels, 0);
-    if (data)
+// Devolve a textura na hora, ainda sem camada; a leitura roda numa thread de
+// trabalho e o upload depois, via scheduleUpload, em faixas de linhas para
+// nenhum quadro passar do orçamento. A textura vai para uma camada de um array
+// do pool (TextureArrays.h). Com S3TC ela vem do cache comprimido (do pacote de
+// assets ou ao lado da imagem, gerado na primeira vez) e já com mipmaps; sem S3TC
+// a imagem é decodificada a cada execução (submitTextureDecode).
+std::shared_ptr<Texture> loadTexture(const std::string &filePath)
+{
+    if (g_watcher)
+        g_watcher->watch(filePath);
+    auto texture = std::make_shared<Texture>();
+    std::weak_ptr<Texture> target = texture;
+    if (!GLEXT_texture_compression_s3tc)
     {
-        GLenum format = (nrChannels == 4) ? GL_RGBA : GL_RGB;
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
+        submitTextureDecode(filePath, target, TextureLayout());
+        return texture;
     }
-    else
+    g_loader->submit([filePath, target]() -> AsyncLoader::Completion
+                     {
+        auto cache = std::make_shared<TextureCacheFile>();
+        // sem cache (imagem que o compressor não lê) segue o caminho sem compressão
+        if (!readPackedTexture(filePath, *cache) && !loadTextureCached(filePath, *cache))
+            return [filePath, target]()
+            {
+                if (!target.expired())
+                    submitTextureDecode(filePath, target, TextureLayout());
+            };
+        return [filePath, target, cache]()
+        {
+            std::shared_ptr<Texture> texture = target.lock();
+            if (!texture || shareDuplicate(assets.textures, textureReloads, texture, cache->view.sourceHash, ""))
+                return;
+            const TextureView &view = cache->view;
+            GLenum internalFormat = view.format == TEXTURE_BC3 ? GL_COMPRESSED_RGBA_S3TC_DXT5_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+            TextureLayout layout = {internalFormat, 0, view.width, view.height, (int)view.levels.size()};
+            std::vector<UploadScheduler::Step> steps;
+            TextureSlot slot;
+            if (!allocateTextureLayer(layout, slot, steps))
+            {
+                textureLayerUnavailable(filePath, target, layout);
+                return;
+            }
+            ++compressedTextureUploads;
+            appendCompressedTextureSteps(steps, cache, internalFormat, slot, g_scheduler->stepBytes());
+            scheduleUpload(std::move(steps), publishTexture(target, view.width, view.height, slot));
+        }; });
+    return texture;
+}
+
+// Tempo para gerar a cadeia de mipmaps de uma imagem: MipGenerator numa faixa e
+// repartido pelas threads de trabalho contra glGenerateMipmap do driver
+// (consulta de tempo da GPU e relógio da CPU até glFinish, já que em drivers de
+// software o trabalho roda na CPU). Roda com --mip-benchmark
+void benchmarkMipGeneration(const std::string &filePath)
+{
+    int width, height, channels;
+    unsigned char *data = stbi_load(filePath.c_str(), &width, &height, &channels, 4);
+    if (!data)
     {
         cerr << "Falha ao carregar textura: " << filePath << endl;
+        return;
+    }
+
+    auto cpuMs = [](unsigned threads, const unsigned char *pixels, int w, int h, MipChain &chain)
+    {
+        double best = 1e30;
+        for (int run = 0; run < 5; ++run)
+        {
+            auto start = std::chrono::steady_clock::now();
+            generateMipChain(pixels, w, h, 4, chain, threads);
+            best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+        return best;
+    };
+    MipChain chain;
+    unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    double serialMs = cpuMs(1, data, width, height, chain);
+    double parallelMs = cpuMs(hardware, data, width, height, chain);
+
+    GLuint texture, query;
+    glGenTextures(1, &texture);
+    glGenQueries(1, &query);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+    glFinish();
+    double driverMs = 1e30, driverGpuMs = 1e30;
+    for (int run = 0; run < 5; ++run)
+    {
+        auto start = std::chrono::steady_clock::now();
+        glBeginQuery(GL_TIME_ELAPSED, query);
+        glGenerateMipmap(GL_TEXTURE_2D);
+        glEndQuery(GL_TIME_ELAPSED);
+        glFinish();
+        driverMs = std::min(driverMs, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed);
+        driverGpuMs = std::min(driverGpuMs, elapsed / 1e6);
     }
-    stbi_image_free(data);
     glBindTexture(GL_TEXTURE_2D, 0);
+    glDeleteQueries(1, &query);
+    glDeleteTextures(1, &texture);
+    stbi_image_free(data);
 
-    return texID;
+    cout << "Mipmaps de " << filePath << " (" << width << "x" << height << ", " << chain.levels.size() << " niveis)\n"
+         << "  CPU, 1 thread: " << serialMs << " ms\n"
+         << "  CPU, " << hardware << " threads: " << parallelMs << " ms\n"
+         << "  glGenerateMipmap: " << driverMs << " ms (GPU " << driverGpuMs << " ms)" << endl;
 }
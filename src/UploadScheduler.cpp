@@ -0,0 +1,95 @@
+#include "UploadScheduler.h"
+#include <algorithm>
+#include <chrono>
+
+// Passos menores que isso medem mais o custo fixo da chamada que a banda
+static const size_t UPLOAD_MIN_MEASURED_BYTES = 64 * 1024;
+static const size_t UPLOAD_MIN_STEP_BYTES = 64 * 1024;
+
+void UploadScheduler::setBudget(double milliseconds, size_t maxBytes)
+{
+    m_budgetMs = milliseconds;
+    m_maxBytes = maxBytes;
+}
+
+size_t UploadScheduler::frameBytes() const
+{
+    return std::min(m_maxBytes, (size_t)(m_budgetMs * m_bytesPerMs));
+}
+
+size_t UploadScheduler::stepBytes() const
+{
+    // duas fatias por quadro: a segunda completa o que a primeira deixou
+    return std::max(UPLOAD_MIN_STEP_BYTES, frameBytes() / 2);
+}
+
+void UploadScheduler::submit(std::vector<Step> steps, Task publish)
+{
+    if (steps.empty())
+        steps.push_back({0, []() {}});
+    m_jobs.push_back({std::move(steps), 0, std::move(publish)});
+}
+
+void UploadScheduler::measure(const std::vector<UploadTiming> &timings)
+{
+    for (const UploadTiming &timing : timings)
+    {
+        if (timing.bytes < UPLOAD_MIN_MEASURED_BYTES)
+            continue;
+        // o passo custa o que for maior: a chamada na CPU ou a cópia na GPU
+        double ms = std::max(0.01, std::max(timing.cpuMs, timing.gpuMs));
+        m_bytesPerMs = 0.75 * m_bytesPerMs + 0.25 * (timing.bytes / ms);
+    }
+}
+
+void UploadScheduler::runFrame()
+{
+    bool threaded = m_uploader && m_uploader->running();
+    m_timings.clear();
+    if (threaded)
+        m_uploader->takeTimings(m_timings);
+    m_timer.poll(m_timings);
+    measure(m_timings);
+
+    // a thread de upload ainda não terminou o que foi liberado antes: liberar
+    // mais só acumularia trabalho para os próximos quadros
+    if (m_jobs.empty() || (threaded && m_uploader->queued() > 0))
+        return;
+
+    size_t budget = frameBytes(), sent = 0;
+    while (!m_jobs.empty())
+    {
+        Job &job = m_jobs.front();
+        Step &step = job.steps[job.next];
+        // ao menos um passo por quadro, para a fila sempre andar
+        if (sent > 0 && sent + step.bytes > budget)
+            break;
+        sent += step.bytes;
+
+        bool last = ++job.next == job.steps.size();
+        Task publish = last ? std::move(job.publish) : Task();
+        if (threaded)
+            m_uploader->submit(std::move(step.upload), std::move(publish), step.bytes);
+        else
+        {
+            auto start = std::chrono::steady_clock::now();
+            m_timer.begin();
+            step.upload();
+            m_timer.end(step.bytes, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+            if (publish)
+                publish();
+        }
+        if (last)
+            m_jobs.pop_front();
+    }
+    m_largestFrame = std::max(m_largestFrame, sent);
+}
+
+void UploadScheduler::clear()
+{
+    for (Job &job : m_jobs)
+        if (job.publish)
+            job.publish();
+    m_jobs.clear();
+    m_timer.destroy();
+}
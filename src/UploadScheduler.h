@@ -0,0 +1,77 @@
+#pragma once
+#include "GLUploader.h"
+#include "UploadTimer.h"
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <vector>
+
+// Fila de uploads dosada por quadro. Cada recurso chega como uma sequência de
+// passos (criar o objeto GL, enviar uma fatia de linhas ou de bytes, gerar
+// mipmaps...) e runFrame() libera a cada quadro só os passos que cabem no
+// orçamento: ms de upload por quadro convertidos em bytes pela taxa medida com
+// consultas de tempo da GPU, limitados por um teto fixo de bytes.
+//
+// Os passos vão para a thread de upload (GLUploader) quando ela existe; senão
+// rodam na hora, na thread principal. O publish do recurso roda depois do
+// último passo.
+class UploadScheduler
+{
+public:
+    using Task = std::function<void()>;
+
+    struct Step
+    {
+        size_t bytes; // estimativa do que o passo envia (0: só cria objetos)
+        Task upload;
+    };
+
+    explicit UploadScheduler(GLUploader *uploader = nullptr) : m_uploader(uploader) {}
+
+    UploadScheduler(const UploadScheduler &) = delete;
+    UploadScheduler &operator=(const UploadScheduler &) = delete;
+
+    void setBudget(double milliseconds, size_t maxBytes);
+
+    // Bytes por quadro que cabem no orçamento com a taxa medida até agora
+    size_t frameBytes() const;
+
+    // Tamanho das fatias em que os uploads grandes devem ser divididos
+    size_t stepBytes() const;
+
+    void submit(std::vector<Step> steps, Task publish);
+
+    // Thread principal, uma vez por quadro
+    void runFrame();
+
+    // Recursos com passos ainda não liberados
+    size_t pending() const { return m_jobs.size(); }
+
+    // Taxa de upload medida (bytes por ms) e maior volume liberado num quadro
+    double bytesPerMillisecond() const { return m_bytesPerMs; }
+    size_t largestFrameBytes() const { return m_largestFrame; }
+
+    // Thread principal: descarta os passos que faltam, roda o publish de cada
+    // recurso (quem não tem mais dono só apaga os objetos GL) e apaga as
+    // consultas de tempo. Com a thread de upload, chamar depois de GLUploader::stop
+    void clear();
+
+private:
+    struct Job
+    {
+        std::vector<Step> steps;
+        size_t next;
+        Task publish;
+    };
+
+    void measure(const std::vector<UploadTiming> &timings);
+
+    GLUploader *m_uploader;
+    UploadTimer m_timer; // uploads feitos na thread principal
+    std::deque<Job> m_jobs;
+    std::vector<UploadTiming> m_timings;
+    double m_budgetMs = 2.0;
+    size_t m_maxBytes = 16 * 1024 * 1024;
+    double m_bytesPerMs = 1024.0 * 1024.0; // chute inicial de 1 GB/s até as primeiras medições
+    size_t m_largestFrame = 0;
+};
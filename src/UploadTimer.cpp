@@ -0,0 +1,49 @@
+#include "UploadTimer.h"
+
+void UploadTimer::begin()
+{
+    if (m_free.empty())
+    {
+        GLuint query;
+        glGenQueries(1, &query);
+        m_free.push_back(query);
+    }
+    m_active = m_free.back();
+    m_free.pop_back();
+    glBeginQuery(GL_TIME_ELAPSED, m_active);
+}
+
+void UploadTimer::end(size_t bytes, double cpuMs)
+{
+    glEndQuery(GL_TIME_ELAPSED);
+    m_pending.push_back({m_active, bytes, cpuMs});
+    m_active = 0;
+}
+
+void UploadTimer::poll(std::vector<UploadTiming> &out)
+{
+    // as consultas terminam na ordem em que foram enviadas
+    while (!m_pending.empty())
+    {
+        const Pending &front = m_pending.front();
+        GLuint available = 0;
+        glGetQueryObjectuiv(front.query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            break;
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(front.query, GL_QUERY_RESULT, &nanoseconds);
+        out.push_back({front.bytes, front.cpuMs, nanoseconds / 1e6});
+        m_free.push_back(front.query);
+        m_pending.pop_front();
+    }
+}
+
+void UploadTimer::destroy()
+{
+    for (const Pending &pending : m_pending)
+        m_free.push_back(pending.query);
+    m_pending.clear();
+    if (!m_free.empty())
+        glDeleteQueries((GLsizei)m_free.size(), m_free.data());
+    m_free.clear();
+}
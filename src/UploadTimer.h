@@ -0,0 +1,43 @@
+#pragma once
+#include <glad/glad.h>
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+// Quanto custou um passo de upload: tempo de CPU de quem chamou o GL e tempo
+// de GPU medido com GL_TIME_ELAPSED
+struct UploadTiming
+{
+    size_t bytes;
+    double cpuMs;
+    double gpuMs;
+};
+
+// Consultas de tempo da GPU em volta de cada passo de upload. Objetos de
+// consulta não são compartilhados entre contextos: cada contexto que envia
+// dados tem o seu e só ele chama begin/end/poll/destroy.
+class UploadTimer
+{
+public:
+    void begin();
+    void end(size_t bytes, double cpuMs);
+
+    // Não bloqueia: devolve as medições cujos resultados já chegaram
+    void poll(std::vector<UploadTiming> &out);
+    bool waiting() const { return !m_pending.empty(); }
+
+    // Apaga as consultas; precisa do contexto que as criou
+    void destroy();
+
+private:
+    struct Pending
+    {
+        GLuint query;
+        size_t bytes;
+        double cpuMs;
+    };
+
+    std::vector<GLuint> m_free;
+    std::deque<Pending> m_pending;
+    GLuint m_active = 0;
+};
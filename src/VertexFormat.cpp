@@ -0,0 +1,136 @@
+#include "VertexFormat.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+static_assert(sizeof(PackedVertex) == 16, "PackedVertex deve ter 16 bytes");
+
+VertexFormat parseVertexFormat(const std::string &name)
+{
+    return name == "packed" ? VERTEX_FORMAT_PACKED : VERTEX_FORMAT_FLOAT;
+}
+
+// IEEE 754 binary16 com arredondamento para o par mais próximo
+uint16_t floatToHalf(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint32_t sign = (bits >> 16) & 0x8000u;
+    uint32_t exponent = (bits >> 23) & 0xFFu;
+    uint32_t mantissa = bits & 0x7FFFFFu;
+
+    if (exponent == 0xFF) // inf / NaN
+        return (uint16_t)(sign | 0x7C00u | (mantissa ? 0x200u : 0u));
+
+    int halfExponent = (int)exponent - 127 + 15;
+    if (halfExponent >= 31) // estoura: infinito
+        return (uint16_t)(sign | 0x7C00u);
+
+    if (halfExponent <= 0) // subnormal ou zero
+    {
+        if (halfExponent < -10)
+            return (uint16_t)sign;
+        mantissa |= 0x800000u;
+        uint32_t shift = (uint32_t)(14 - halfExponent);
+        uint32_t half = mantissa >> shift;
+        uint32_t rest = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (rest > halfway || (rest == halfway && (half & 1)))
+            ++half;
+        return (uint16_t)(sign | half);
+    }
+
+    uint32_t half = ((uint32_t)halfExponent << 10) | (mantissa >> 13);
+    uint32_t rest = mantissa & 0x1FFFu;
+    if (rest > 0x1000u || (rest == 0x1000u && (half & 1)))
+        ++half; // pode subir o expoente, que continua correto
+    return (uint16_t)(sign | half);
+}
+
+float halfToFloat(uint16_t half)
+{
+    uint32_t sign = (uint32_t)(half & 0x8000u) << 16;
+    uint32_t exponent = (half >> 10) & 0x1Fu;
+    uint32_t mantissa = half & 0x3FFu;
+    uint32_t bits;
+
+    if (exponent == 0)
+    {
+        float value = std::ldexp((float)mantissa, -24);
+        return sign ? -value : value;
+    }
+    if (exponent == 31)
+        bits = sign | 0x7F800000u | (mantissa << 13);
+    else
+        bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Normalização de inteiros com sinal do GL 4.2+: c / 511, limitado a -1
+static uint32_t packSnorm10(float value)
+{
+    int q = (int)std::lround(std::min(1.0f, std::max(-1.0f, value)) * 511.0f);
+    return (uint32_t)q & 0x3FFu;
+}
+
+static float unpackSnorm10(uint32_t bits)
+{
+    int q = (int)(bits & 0x3FFu);
+    if (q & 0x200)
+        q -= 0x400;
+    return std::max(-1.0f, (float)q / 511.0f);
+}
+
+uint32_t packNormal(const glm::vec3 &normal)
+{
+    return packSnorm10(normal.x) | (packSnorm10(normal.y) << 10) | (packSnorm10(normal.z) << 20);
+}
+
+glm::vec3 unpackNormal(uint32_t packed)
+{
+    return glm::vec3(unpackSnorm10(packed), unpackSnorm10(packed >> 10), unpackSnorm10(packed >> 20));
+}
+
+// Caixa com espessura zero em algum eixo (ex.: plano) usa escala 1 nesse eixo
+static glm::vec3 quantizationExtent(const glm::vec3 &boundsMin, const glm::vec3 &boundsMax)
+{
+    glm::vec3 extent = boundsMax - boundsMin;
+    for (int i = 0; i < 3; ++i)
+    {
+        if (!(extent[i] > 0.0f))
+            extent[i] = 1.0f;
+    }
+    return extent;
+}
+
+void packVertices(const Vertex *vertices, size_t vertexCount, const glm::vec3 &boundsMin, const glm::vec3 &boundsMax,
+                  std::vector<PackedVertex> &outPacked)
+{
+    glm::vec3 extent = quantizationExtent(boundsMin, boundsMax);
+    outPacked.resize(vertexCount);
+    for (size_t i = 0; i < vertexCount; ++i)
+    {
+        const Vertex &v = vertices[i];
+        PackedVertex &p = outPacked[i];
+        for (int k = 0; k < 3; ++k)
+        {
+            float t = std::min(1.0f, std::max(0.0f, (v.position[k] - boundsMin[k]) / extent[k]));
+            p.position[k] = (uint16_t)std::lround(t * 65535.0f);
+        }
+        p.position[3] = 0;
+        p.normal = packNormal(v.normal);
+        p.texCoord[0] = floatToHalf(v.texCoord.x);
+        p.texCoord[1] = floatToHalf(v.texCoord.y);
+    }
+}
+
+glm::mat4 dequantizeMatrix(const glm::vec3 &boundsMin, const glm::vec3 &boundsMax)
+{
+    glm::mat4 m = glm::translate(glm::mat4(1.0f), boundsMin);
+    return glm::scale(m, quantizationExtent(boundsMin, boundsMax));
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "ObjLoader.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Formatos de vértice enviados para a GPU. O cache e o parser continuam em
+// Vertex (32 bytes de float); o formato compacto é gerado no upload:
+//  - posição: 3 x uint16 normalizado dentro da caixa envolvente da malha
+//    (a volta para coordenadas do modelo vai na matriz model, ver dequantizeMatrix)
+//  - normal: GL_INT_2_10_10_10_REV normalizado
+//  - texCoord: 2 x half float
+// Os atributos normalizados chegam no shader como vec3/vec2 em float, então o
+// mesmo vertex shader serve para os dois formatos.
+
+enum VertexFormat
+{
+    VERTEX_FORMAT_FLOAT,  // Vertex, 32 bytes
+    VERTEX_FORMAT_PACKED, // PackedVertex, 16 bytes
+};
+
+struct PackedVertex
+{
+    uint16_t position[4]; // xyz + preenchimento para alinhar a normal
+    uint32_t normal;      // x:10 y:10 z:10 w:2, com sinal
+    uint16_t texCoord[2]; // half float
+};
+
+// "float" ou "packed" (campo vertexFormat do scene.json); outros valores viram float
+VertexFormat parseVertexFormat(const std::string &name);
+
+uint16_t floatToHalf(float value);
+float halfToFloat(uint16_t half);
+uint32_t packNormal(const glm::vec3 &normal);
+glm::vec3 unpackNormal(uint32_t packed);
+
+// Converte os vértices; positions são quantizadas em [boundsMin, boundsMax]
+void packVertices(const Vertex *vertices, size_t vertexCount, const glm::vec3 &boundsMin, const glm::vec3 &boundsMax,
+                  std::vector<PackedVertex> &outPacked);
+
+// Leva a posição quantizada ([0,1]^3 depois da normalização do atributo) de volta
+// para o espaço do modelo; multiplicar à direita da matriz model
+glm::mat4 dequantizeMatrix(const glm::vec3 &boundsMin, const glm::vec3 &boundsMax);